@@ -0,0 +1,26 @@
+/**
+ * @file Authorization.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief hand out access tokens to requests, waiting for a running refresh
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QString>
+
+#include <functional>
+
+namespace Authorization {
+
+// Bekommt das aktuelle Access Token, oder einen leeren String wenn keins zu bekommen ist
+using Call = std::function<void(const QString &token)>;
+
+// Führt call aus, sobald ein gültiges Token vorliegt. Während eines Token Refresh
+// werden die Calls gesammelt und danach der Reihe nach ausgeführt.
+using Dispatcher = std::function<void(const Call &call)>;
+
+} // namespace Authorization
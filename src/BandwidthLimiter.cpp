@@ -0,0 +1,169 @@
+#include "BandwidthLimiter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void TokenBucket::setRate(qint64 bytesPerSecond)
+{
+    refill(); // Bis jetzt gilt noch die alte Rate
+    m_rate = std::max<qint64>(0, bytesPerSecond);
+    m_tokens = std::min<double>(m_tokens, burst());
+}
+
+qint64 TokenBucket::rate() const
+{
+    return m_rate;
+}
+
+qint64 TokenBucket::burst() const
+{
+    // Etwa 250 ms Vorrat
+    return std::max(m_rate / 4, MinBurst);
+}
+
+void TokenBucket::refill()
+{
+    if (!m_clock.isValid()) {
+        m_clock.start();
+        m_tokens = burst();
+        return;
+    }
+    const qint64 ns = m_clock.nsecsElapsed();
+    m_clock.restart();
+    if (m_rate > 0)
+        m_tokens = std::min<double>(burst(), m_tokens + m_rate * (ns / 1e9));
+}
+
+qint64 TokenBucket::available()
+{
+    if (m_rate <= 0)
+        return std::numeric_limits<qint64>::max();
+    refill();
+    const qint64 tokens = static_cast<qint64>(m_tokens);
+    return tokens >= std::min(MinRead, burst()) ? tokens : 0;
+}
+
+void TokenBucket::consume(qint64 bytes)
+{
+    if (m_rate > 0)
+        m_tokens -= bytes;
+}
+
+int TokenBucket::msUntilAvailable() const
+{
+    if (m_rate <= 0)
+        return 0;
+    const double missing = std::min(MinRead, burst()) - m_tokens;
+    return std::max(1, static_cast<int>(std::ceil(missing * 1000.0 / m_rate)));
+}
+
+BandwidthLimiter::BandwidthLimiter(QObject *parent)
+    : QObject(parent)
+{}
+
+void BandwidthLimiter::setRates(qint64 totalRate, qint64 transferRate)
+{
+    if (totalRate == m_total.rate() && transferRate == m_transferRate)
+        return;
+    m_total.setRate(totalRate);
+    m_transferRate = std::max<qint64>(0, transferRate);
+    emit ratesChanged();
+}
+
+qint64 BandwidthLimiter::totalRate() const
+{
+    return m_total.rate();
+}
+
+qint64 BandwidthLimiter::transferRate() const
+{
+    return m_transferRate;
+}
+
+TokenBucket &BandwidthLimiter::total()
+{
+    return m_total;
+}
+
+ThrottledDevice *ThrottledDevice::wrap(QNetworkRequest &request, QIODevice *source, BandwidthLimiter *limiter)
+{
+    request.setHeader(QNetworkRequest::ContentLengthHeader, source->size());
+    request.setAttribute(QNetworkRequest::DoNotBufferUploadDataAttribute, true);
+    return new ThrottledDevice(source, limiter);
+}
+
+ThrottledDevice::ThrottledDevice(QIODevice *source, BandwidthLimiter *limiter, QObject *parent)
+    : QIODevice(parent)
+    , m_source(source)
+    , m_limiter(limiter)
+{
+    m_source->setParent(this);
+    m_wakeUp.setSingleShot(true);
+    m_wakeUp.setTimerType(Qt::PreciseTimer);
+    connect(&m_wakeUp, &QTimer::timeout, this, &ThrottledDevice::readyRead);
+
+    if (m_limiter) {
+        m_bucket.setRate(m_limiter->transferRate());
+        connect(m_limiter, &BandwidthLimiter::ratesChanged, this, &ThrottledDevice::onRatesChanged);
+    }
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+bool ThrottledDevice::isSequential() const
+{
+    return true;
+}
+
+qint64 ThrottledDevice::bytesAvailable() const
+{
+    // Sonst hielte QIODevice::atEnd() ein gedrosseltes Device für leer
+    return QIODevice::bytesAvailable() + m_source->bytesAvailable();
+}
+
+qint64 ThrottledDevice::readData(char *data, qint64 maxSize)
+{
+    if (m_source->atEnd())
+        return -1;
+
+    qint64 allowed = std::min({maxSize, ReadBlock, m_bucket.available()});
+    if (m_limiter)
+        allowed = std::min(allowed, m_limiter->total().available());
+    if (allowed <= 0) {
+        scheduleWakeUp();
+        return 0;
+    }
+
+    const qint64 read = m_source->read(data, allowed);
+    if (read > 0) {
+        m_bucket.consume(read);
+        if (m_limiter)
+            m_limiter->total().consume(read);
+    }
+    return read;
+}
+
+qint64 ThrottledDevice::writeData(const char *, qint64)
+{
+    return -1;
+}
+
+void ThrottledDevice::onRatesChanged()
+{
+    m_bucket.setRate(m_limiter->transferRate());
+    // Neue Grenzen sofort anwenden, nicht erst nach der alten Wartezeit
+    if (m_wakeUp.isActive()) {
+        m_wakeUp.stop();
+        emit readyRead();
+    }
+}
+
+void ThrottledDevice::scheduleWakeUp()
+{
+    if (m_wakeUp.isActive())
+        return;
+    int ms = m_bucket.available() > 0 ? 0 : m_bucket.msUntilAvailable();
+    if (m_limiter && m_limiter->total().available() == 0)
+        ms = std::max(ms, m_limiter->total().msUntilAvailable());
+    m_wakeUp.start(std::max(ms, 1));
+}
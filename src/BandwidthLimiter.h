@@ -0,0 +1,101 @@
+/**
+ * @file BandwidthLimiter.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief token bucket upload caps (global and per transfer) and a throttled body device
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QElapsedTimer>
+#include <QIODevice>
+#include <QNetworkRequest>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+class TokenBucket
+{
+public:
+    // Unter dieser Menge wird nicht gelesen, sonst entstehen winzige Writes
+    static constexpr qint64 MinRead = 4 * 1024;
+    static constexpr qint64 MinBurst = 16 * 1024;
+
+    // Bytes pro Sekunde, 0 = unbegrenzt
+    void setRate(qint64 bytesPerSecond);
+    qint64 rate() const;
+
+    // Sofort verfügbare Bytes (0: warten, unbegrenzt: max)
+    qint64 available();
+    void consume(qint64 bytes);
+    // Wartezeit, bis wieder mindestens MinRead verfügbar sind
+    int msUntilAvailable() const;
+
+private:
+    void refill();
+    qint64 burst() const;
+
+    qint64 m_rate = 0;
+    double m_tokens = 0.0;
+    QElapsedTimer m_clock;
+};
+
+// Gemeinsame Grenzen aller Uploads, zur Laufzeit änderbar
+class BandwidthLimiter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BandwidthLimiter(QObject *parent = nullptr);
+
+    void setRates(qint64 totalRate, qint64 transferRate);
+    qint64 totalRate() const;
+    qint64 transferRate() const;
+
+    TokenBucket &total();
+
+signals:
+    void ratesChanged();
+
+private:
+    TokenBucket m_total;
+    qint64 m_transferRate = 0;
+};
+
+/*
+ * Sequentielles Device vor dem eigentlichen Body: liest nur so viel, wie beide Buckets
+ * (global und eigener pro Transfer) erlauben, sonst 0 und später readyRead().
+ * QNetworkAccessManager sendet dann ungepuffert und holt Daten erst bei readyRead nach.
+ */
+class ThrottledDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    static constexpr qint64 ReadBlock = 64 * 1024;
+
+    // Übernimmt source (offen, mit bekannter Größe) und bereitet request vor
+    // (Content-Length, ungepuffertes Senden)
+    static ThrottledDevice *wrap(QNetworkRequest &request, QIODevice *source, BandwidthLimiter *limiter);
+
+    ThrottledDevice(QIODevice *source, BandwidthLimiter *limiter, QObject *parent = nullptr);
+
+    bool isSequential() const override;
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    void onRatesChanged();
+    void scheduleWakeUp();
+
+    QIODevice *m_source;
+    QPointer<BandwidthLimiter> m_limiter;
+    TokenBucket m_bucket; // Grenze pro Transfer
+    QTimer m_wakeUp;
+};
@@ -0,0 +1,344 @@
+#include "ChunkedUpload.h"
+
+#include <QBuffer>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+
+#include <algorithm>
+
+ChunkedUpload::ChunkedUpload(QNetworkAccessManager *manager,
+                             const QString &serverUrl,
+                             const QString &filePath,
+                             const QString &fileName,
+                             const QString &serverPath,
+                             qint64 chunkSize,
+                             QObject *parent)
+    : QObject(parent)
+    , m_netManager(manager)
+    , m_serverUrl(serverUrl)
+    , m_filePath(filePath)
+    , m_fileName(fileName)
+    , m_serverPath(serverPath)
+    , m_file(filePath)
+    , m_chunkSize(std::max<qint64>(chunkSize, 64 * 1024))
+    , m_size(QFileInfo(filePath).size())
+{
+    m_clock.start();
+}
+
+void ChunkedUpload::setDispatcher(const Authorization::Dispatcher &dispatcher)
+{
+    m_dispatcher = dispatcher;
+}
+
+void ChunkedUpload::setContentEncoding(const QByteArray &encoding)
+{
+    m_contentEncoding = encoding;
+}
+
+void ChunkedUpload::setMetadata(const QByteArray &metadata)
+{
+    m_metadata = metadata;
+}
+
+void ChunkedUpload::setBandwidthLimiter(BandwidthLimiter *limiter)
+{
+    m_limiter = limiter;
+}
+
+void ChunkedUpload::setUploadId(const QString &uploadId)
+{
+    m_uploadId = uploadId;
+    m_committed = 0;
+}
+
+void ChunkedUpload::setIdempotencyKey(const QByteArray &key)
+{
+    m_idempotencyKey = key;
+}
+
+void ChunkedUpload::setServerUrl(const QString &url)
+{
+    if (url == m_serverUrl)
+        return;
+    m_serverUrl = url;
+    m_retries = 0; // neuer Knoten, neue Versuche
+
+    // Idle: wartet auf Retry oder Token bzw. ist fertig, der nächste Request geht schon an url
+    if (m_step == Step::Idle)
+        return;
+    ++m_generation;
+    if (m_call)
+        m_call->cancel();
+    m_step = Step::Idle;
+    if (m_uploadId.isEmpty())
+        createSession();
+    else
+        queryOffset();
+}
+
+void ChunkedUpload::start(const QString &token)
+{
+    m_token = token;
+    m_waitingForAuth = false;
+
+    if (m_uploadId.isEmpty())
+        createSession();
+    else
+        queryOffset();
+}
+
+bool ChunkedUpload::isWaitingForAuth() const
+{
+    return m_waitingForAuth;
+}
+
+QString ChunkedUpload::uploadId() const
+{
+    return m_uploadId;
+}
+
+qint64 ChunkedUpload::committedOffset() const
+{
+    return m_committed;
+}
+
+qint64 ChunkedUpload::size() const
+{
+    return m_size;
+}
+
+QNetworkRequest ChunkedUpload::buildRequest(const QString &path) const
+{
+    QNetworkRequest request(QUrl(m_serverUrl + path));
+    RetryPolicy::markAttempt(request, m_retries);
+    request.setRawHeader("Authorization", ("Bearer " + m_token).toUtf8());
+    return request;
+}
+
+void ChunkedUpload::authorized(const std::function<void()> &send)
+{
+    const Authorization::Call call = [this, send, generation = m_generation](const QString &token) {
+        if (generation != m_generation)
+            return; // Server gewechselt, setServerUrl() hat neu angesetzt
+        if (token.isEmpty()) {
+            m_step = Step::Idle;
+            m_waitingForAuth = true;
+            emit authenticationRequired();
+            return;
+        }
+        m_token = token;
+        send();
+    };
+
+    if (m_dispatcher)
+        m_dispatcher(call);
+    else
+        call(m_token);
+}
+
+void ChunkedUpload::createSession()
+{
+    m_step = Step::Create;
+    authorized([this]() {
+        QNetworkRequest request = buildRequest("/upload/chunked");
+        request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+        if (!m_idempotencyKey.isEmpty())
+            request.setRawHeader(RetryPolicy::IdempotencyHeader, m_idempotencyKey);
+
+        QJsonObject json;
+        json["fileName"] = m_fileName;
+        json["path"] = m_serverPath;
+        json["size"] = m_size;
+        if (!m_contentEncoding.isEmpty())
+            json["contentEncoding"] = QString::fromLatin1(m_contentEncoding);
+        if (!m_metadata.isEmpty())
+            json["metadata"] = QJsonDocument::fromJson(m_metadata).object();
+
+        m_call = NetworkCall::post(m_netManager,
+                                   request,
+                                   QJsonDocument(json).toJson(),
+                                   this,
+                                   [this](QNetworkReply *reply) { onReplyFinished(reply); });
+    });
+}
+
+void ChunkedUpload::queryOffset()
+{
+    m_step = Step::Query;
+    authorized([this]() {
+        m_call = NetworkCall::get(m_netManager,
+                                  buildRequest("/upload/chunked/" + m_uploadId),
+                                  this,
+                                  [this](QNetworkReply *reply) { onReplyFinished(reply); });
+    });
+}
+
+void ChunkedUpload::sendChunk()
+{
+    if (!m_file.isOpen() && !m_file.open(QIODevice::ReadOnly)) {
+        fail(tr("Could not open file locally."));
+        return;
+    }
+
+    // Letzter Chunk übernommen, aber seine Antwort ging verloren: Query bzw. 409 melden das Ende
+    if (m_committed >= m_size) {
+        complete();
+        return;
+    }
+
+    const qint64 offset = m_committed;
+    const qint64 length = std::min(m_chunkSize, m_size - offset);
+    if (length <= 0 || !m_file.seek(offset)) {
+        fail(tr("Invalid offset %1 reported by server.").arg(offset));
+        return;
+    }
+    const QByteArray chunk = m_file.read(length);
+    if (chunk.size() != length) {
+        fail(tr("Could not read file locally."));
+        return;
+    }
+
+    m_step = Step::Chunk;
+    m_sentAt = -1;
+    authorized([this, offset, chunk]() {
+        QNetworkRequest request = buildRequest("/upload/chunked/" + m_uploadId);
+        request.setHeader(QNetworkRequest::ContentTypeHeader, "application/octet-stream");
+        request.setRawHeader("Content-Range",
+                             QString("bytes %1-%2/%3")
+                                 .arg(offset)
+                                 .arg(offset + chunk.size() - 1)
+                                 .arg(m_size)
+                                 .toLatin1());
+
+        QBuffer *buffer = new QBuffer;
+        buffer->setData(chunk);
+        buffer->open(QIODevice::ReadOnly);
+        ThrottledDevice *body = ThrottledDevice::wrap(request, buffer, m_limiter);
+
+        m_call = NetworkCall::put(m_netManager, request, body, this, [this](QNetworkReply *reply) {
+            onReplyFinished(reply);
+        });
+        connect(m_call->reply(),
+                &QNetworkReply::uploadProgress,
+                this,
+                [this, offset](qint64 bytesSent, qint64 bytesTotal) {
+                    if (bytesTotal > 0 && bytesSent == bytesTotal && m_sentAt < 0)
+                        m_sentAt = m_clock.elapsed();
+                    emit progress(offset + bytesSent, m_size);
+                });
+    });
+}
+
+void ChunkedUpload::onReplyFinished(QNetworkReply *reply)
+{
+    m_call.clear();
+
+    const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    const QJsonObject obj = QJsonDocument::fromJson(reply->readAll()).object();
+    const Step step = m_step;
+    m_step = Step::Idle;
+    if (step == Step::Chunk)
+        emit chunkResponse(statusCode, m_sentAt >= 0 ? m_clock.elapsed() - m_sentAt : -1);
+
+    if (statusCode == 401) {
+        // Bereits bestätigte Chunks bleiben erhalten, nur der laufende geht verloren
+        m_waitingForAuth = true;
+        emit authenticationRequired();
+        return;
+    }
+
+    if (step == Step::Chunk && statusCode == 409) {
+        // Server hat einen anderen Stand, dort weitermachen
+        m_committed = obj["offset"].toInteger();
+        sendChunk();
+        return;
+    }
+
+    if (reply->error() != QNetworkReply::NoError) {
+        if (statusCode == 404 && step != Step::Create) {
+            // Upload-Session existiert nicht mehr: von vorne, mit neuem Schlüssel
+            // (der alte würde die Antwort mit der verschwundenen Session wiederholen)
+            m_uploadId.clear();
+            m_committed = 0;
+            m_idempotencyKey = RetryPolicy::newKey();
+            retry(reply);
+        } else if (RetryPolicy::isRetryable(reply)) {
+            if (RetryPolicy::isUnreachable(reply))
+                emit serverUnreachable(reply->url().toString(), RetryPolicy::reason(reply));
+            retry(reply);
+        } else {
+            fail(reply->errorString());
+        }
+        return;
+    }
+
+    m_retries = 0;
+    switch (step) {
+    case Step::Create:
+        m_uploadId = obj["uploadId"].toString();
+        m_committed = obj["offset"].toInteger();
+        if (m_uploadId.isEmpty()) {
+            fail(tr("Server did not return an upload id."));
+            return;
+        }
+        break;
+    case Step::Query:
+        if (obj.contains("size") && obj["size"].toInteger() != m_size) {
+            // Session gehört zu einer anderen Fassung der Datei: neu anlegen
+            m_uploadId.clear();
+            m_committed = 0;
+            m_idempotencyKey = RetryPolicy::newKey();
+            createSession();
+            return;
+        }
+        m_committed = obj["offset"].toInteger();
+        break;
+    case Step::Chunk:
+        m_committed = obj["offset"].toInteger();
+        if (obj["complete"].toBool()) {
+            complete();
+            return;
+        }
+        break;
+    case Step::Idle:
+        return;
+    }
+
+    emit committed(m_uploadId, m_committed);
+    emit progress(m_committed, m_size);
+    sendChunk();
+}
+
+void ChunkedUpload::retry(const QNetworkReply *reply)
+{
+    if (++m_retries > MaxRetries) {
+        fail(RetryPolicy::reason(reply));
+        return;
+    }
+
+    // Warten (Backoff mit Jitter bzw. Retry-After), dann den bestätigten Offset beim Server erfragen
+    const int delayMs = RetryPolicy::delayMs(m_retries, reply);
+    emit retrying(m_retries, delayMs, RetryPolicy::reason(reply));
+    QTimer::singleShot(delayMs, this, [this]() {
+        if (m_uploadId.isEmpty())
+            createSession();
+        else
+            queryOffset();
+    });
+}
+
+void ChunkedUpload::complete()
+{
+    m_file.close();
+    emit progress(m_size, m_size);
+    emit finished(true, QString());
+}
+
+void ChunkedUpload::fail(const QString &message)
+{
+    m_file.close();
+    emit finished(false, message);
+}
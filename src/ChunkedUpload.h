@@ -0,0 +1,127 @@
+/**
+ * @file ChunkedUpload.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief resumable upload of one file in fixed-size chunks
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QObject>
+#include <QString>
+
+#include <functional>
+
+#include "Authorization.h"
+#include "BandwidthLimiter.h"
+#include "NetworkCall.h"
+#include "RetryPolicy.h"
+
+/*
+ * Protokoll:
+ *   POST /upload/chunked          {"fileName","path","size"[,"contentEncoding","metadata"]} -> {"uploadId","offset"}
+ *   GET  /upload/chunked/<id>     -> {"offset","size"}
+ *   PUT  /upload/chunked/<id>     Content-Range: bytes a-b/size -> {"offset","complete"}
+ * size und Offsets beziehen sich auf die gesendeten (ggf. gzip-kodierten) Bytes.
+ * Nach einem Fehler wird der vom Server bestätigte Offset abgefragt und ab dort weitergesendet.
+ */
+class ChunkedUpload : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MaxRetries = RetryPolicy::MaxRetries;
+
+    ChunkedUpload(QNetworkAccessManager *manager,
+                  const QString &serverUrl,
+                  const QString &filePath,
+                  const QString &fileName,
+                  const QString &serverPath,
+                  qint64 chunkSize,
+                  QObject *parent = nullptr);
+
+    // Jeder Request holt sich sein Token über den Dispatcher (sonst: Token aus start())
+    void setDispatcher(const Authorization::Dispatcher &dispatcher);
+    // Die Datei ist bereits kodiert (z.B. "gzip"), der Server dekodiert beim Zusammensetzen
+    void setContentEncoding(const QByteArray &encoding);
+    // Aufnahmedaten als JSON-Objekt (ExifReader::toJson), gehen mit dem Anlegen der Session mit
+    void setMetadata(const QByteArray &metadata);
+    // Chunks werden über die gemeinsamen Bandbreitengrenzen gedrosselt gesendet
+    void setBandwidthLimiter(BandwidthLimiter *limiter);
+    // Bestehende Session (z.B. aus dem Journal) fortsetzen: start() fragt zuerst den Offset ab
+    void setUploadId(const QString &uploadId);
+    // Idempotency-Key für das Anlegen der Session (Chunks sind über den Offset idempotent)
+    void setIdempotencyKey(const QByteArray &key);
+    // Failover: laufenden Request abbrechen und beim neuen Knoten den Offset erfragen
+    // (unbekannte Session: 404, dann neu anlegen)
+    void setServerUrl(const QString &url);
+
+    // Startet den Upload bzw. setzt ihn (z.B. nach einem Token Refresh) fort
+    void start(const QString &token);
+
+    bool isWaitingForAuth() const;
+    QString uploadId() const;
+    qint64 committedOffset() const;
+    qint64 size() const;
+
+signals:
+    void progress(qint64 bytesSent, qint64 bytesTotal);
+    // Der Server hat bis offset bestätigt
+    void committed(const QString &uploadId, qint64 offset);
+    // Antwort auf einen Chunk: HTTP Status (0 = Netzwerkfehler) und Wartezeit nach dem Senden
+    void chunkResponse(int statusCode, qint64 waitMs);
+    // Vorübergehender Fehler: nächster Versuch (1..MaxRetries) in delayMs
+    void retrying(int retry, int delayMs, const QString &reason);
+    void authenticationRequired();
+    // Verbindungsfehler, Timeout, 502/504 (RetryPolicy::isUnreachable) für requestUrl
+    void serverUnreachable(const QString &requestUrl, const QString &reason);
+    void finished(bool ok, const QString &message);
+
+private:
+    void createSession();
+    void queryOffset();
+    void sendChunk();
+    void authorized(const std::function<void()> &send);
+    void onReplyFinished(QNetworkReply *reply);
+    void retry(const QNetworkReply *reply);
+    void complete();
+    void fail(const QString &message);
+
+    QNetworkRequest buildRequest(const QString &path) const;
+
+    enum class Step { Idle, Create, Query, Chunk };
+
+    QNetworkAccessManager *m_netManager;
+    QString m_serverUrl;
+    QString m_filePath;
+    QString m_fileName;
+    QString m_serverPath;
+    QByteArray m_contentEncoding;
+    QByteArray m_metadata;
+    QString m_token;
+    Authorization::Dispatcher m_dispatcher;
+    QPointer<BandwidthLimiter> m_limiter;
+    QFile m_file;
+    QPointer<NetworkCall> m_call; // laufender Request, mit Inaktivitäts-Timeout
+
+    qint64 m_chunkSize;
+    qint64 m_size = 0;
+    qint64 m_committed = 0;
+    QString m_uploadId;
+    QByteArray m_idempotencyKey;
+
+    QElapsedTimer m_clock;
+    qint64 m_sentAt = -1; // Chunk vollständig gesendet (m_clock)
+
+    Step m_step = Step::Idle;
+    bool m_waitingForAuth = false;
+    int m_retries = 0;
+    quint64 m_generation = 0; // verwirft nach setServerUrl() noch ausstehende authorized()-Aufrufe
+};
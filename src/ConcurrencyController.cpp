@@ -0,0 +1,126 @@
+#include "ConcurrencyController.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+// Basislinie pro Fenster um 2 % anheben, damit ein einmal sehr schneller Wert nicht ewig gilt
+constexpr double MinWaitDrift = 1.02;
+} // namespace
+
+ConcurrencyController::ConcurrencyController(QObject *parent)
+    : QObject(parent)
+{}
+
+void ConcurrencyController::reset(int initial, int minimum, int maximum)
+{
+    m_minimum = std::max(1, minimum);
+    m_maximum = std::max(m_minimum, maximum);
+    m_phase = Phase::SlowStart;
+    m_overloads = 0;
+    m_waitSum = 0;
+    m_waitCount = 0;
+    m_minWait = -1.0;
+    m_lastThroughput = 0;
+    m_lastLimit = 0;
+    m_hold = 0;
+    setLimit(initial);
+}
+
+int ConcurrencyController::limit() const
+{
+    return m_limit;
+}
+
+int ConcurrencyController::minimum() const
+{
+    return m_minimum;
+}
+
+int ConcurrencyController::maximum() const
+{
+    return m_maximum;
+}
+
+bool ConcurrencyController::isOverload(int statusCode)
+{
+    return statusCode == 0 || statusCode == 429 || statusCode == 503 || statusCode == 504;
+}
+
+void ConcurrencyController::addResponse(int statusCode, qint64 waitMs)
+{
+    if (isOverload(statusCode)) {
+        ++m_overloads;
+        return;
+    }
+    if (waitMs >= 0) {
+        m_waitSum += waitMs;
+        ++m_waitCount;
+    }
+}
+
+void ConcurrencyController::endWindow(qint64 bytes, qint64 elapsedMs, int inFlight)
+{
+    const double throughput = elapsedMs > 0 ? std::max<qint64>(bytes, 0) * 1000.0 / elapsedMs : 0.0;
+    const double wait = m_waitCount > 0 ? double(m_waitSum) / m_waitCount : -1.0;
+    const int overloads = std::exchange(m_overloads, 0);
+    m_waitSum = 0;
+    m_waitCount = 0;
+
+    if (wait >= 0)
+        m_minWait = m_minWait < 0 ? wait : std::min(m_minWait * MinWaitDrift, wait);
+
+    if (overloads > 0) {
+        m_phase = Phase::Avoidance;
+        m_lastThroughput = 0;
+        m_hold = 2;
+        setLimit(static_cast<int>(m_limit * Backoff));
+        return;
+    }
+
+    const bool queueing = wait >= 0 && wait > m_minWait * LatencyTolerance
+                          && wait - m_minWait > MinQueueDelay;
+    if (queueing) {
+        // So weit zurück, wie die Wartezeit über der Toleranz liegt, höchstens Backoff
+        const double gradient = std::clamp(m_minWait * LatencyTolerance / wait, Backoff, 1.0);
+        m_phase = Phase::Avoidance;
+        m_lastThroughput = 0;
+        m_hold = 1;
+        setLimit(std::min(m_limit - 1, static_cast<int>(std::floor(m_limit * gradient))));
+        return;
+    }
+
+    // Nicht ausgelastet (zu wenig Arbeit): das Fenster sagt nichts über das Limit
+    if (inFlight < m_limit)
+        return;
+
+    if (m_hold > 0) {
+        --m_hold;
+        return;
+    }
+
+    if (m_lastThroughput > 0 && m_limit > m_lastLimit
+        && throughput < m_lastThroughput * (1.0 + MinGain)) {
+        // Mehr parallel hat nichts gebracht (Leitung oder Server voll): zurück und halten
+        m_phase = Phase::Avoidance;
+        m_hold = ProbeInterval;
+        const int previous = m_lastLimit;
+        m_lastThroughput = 0;
+        setLimit(previous);
+        return;
+    }
+
+    m_lastThroughput = throughput;
+    m_lastLimit = m_limit;
+    setLimit(m_phase == Phase::SlowStart ? m_limit * 2 : m_limit + 1);
+}
+
+void ConcurrencyController::setLimit(int limit)
+{
+    limit = std::clamp(limit, m_minimum, m_maximum);
+    if (limit == m_limit)
+        return;
+    m_limit = limit;
+    emit limitChanged(limit);
+}
@@ -0,0 +1,73 @@
+/**
+ * @file ConcurrencyController.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief adapts the number of parallel uploads to measured throughput, latency and overload responses
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QObject>
+
+/*
+ * AIMD mit Latenz-Gradient, ausgewertet pro Messfenster:
+ *   - 429/503/504 oder Verbindungsfehler: Limit * Backoff (multiplikativ runter)
+ *   - Antwort-Wartezeit > LatencyTolerance * Minimum: Warteschlange beim Server bzw.
+ *     Bufferbloat, Limit im Verhältnis Minimum/aktuell zurücknehmen
+ *   - sonst Slow Start (verdoppeln), danach +1 pro Fenster, solange jede Erhöhung
+ *     mindestens MinGain mehr Durchsatz bringt; ohne Gewinn zurück und ProbeInterval halten
+ * Wartezeit = Request vollständig gesendet bis Antwort da (RTT + Serverzeit).
+ * Reine Logik ohne Timer, die Queue liefert Antworten und Fenster.
+ */
+class ConcurrencyController : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int Window = 1000; // ms
+    static constexpr double Backoff = 0.7;
+    static constexpr double LatencyTolerance = 2.0;
+    static constexpr qint64 MinQueueDelay = 20; // ms, darunter ist es Rauschen (LAN)
+    static constexpr double MinGain = 0.05;
+    static constexpr int ProbeInterval = 10; // Fenster
+
+    explicit ConcurrencyController(QObject *parent = nullptr);
+
+    void reset(int initial, int minimum, int maximum);
+    int limit() const;
+    int minimum() const;
+    int maximum() const;
+
+    // Antwort auf einen Upload-Request; statusCode 0 = Netzwerkfehler, waitMs < 0 = unbekannt
+    void addResponse(int statusCode, qint64 waitMs);
+    // Messfenster vorbei: in elapsedMs gesendete Bytes und Requests in Arbeit am Ende
+    void endWindow(qint64 bytes, qint64 elapsedMs, int inFlight);
+
+    static bool isOverload(int statusCode);
+
+signals:
+    void limitChanged(int limit);
+
+private:
+    enum class Phase { SlowStart, Avoidance };
+
+    void setLimit(int limit);
+
+    int m_limit = 1;
+    int m_minimum = 1;
+    int m_maximum = 1;
+    Phase m_phase = Phase::SlowStart;
+
+    // laufendes Fenster
+    int m_overloads = 0;
+    qint64 m_waitSum = 0;
+    int m_waitCount = 0;
+
+    double m_minWait = -1.0;      // Basislinie, steigt langsam mit (Routenwechsel)
+    double m_lastThroughput = 0;  // Bytes/s beim Limit vor der letzten Erhöhung
+    int m_lastLimit = 0;
+    int m_hold = 0;               // Fenster ohne Erhöhung
+};
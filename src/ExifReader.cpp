@@ -0,0 +1,571 @@
+#include "ExifReader.h"
+
+#include <QBuffer>
+#include <QFile>
+#include <QJsonValue>
+#include <QList>
+#include <QUuid>
+
+#include <algorithm>
+#include <initializer_list>
+#include <utility>
+
+namespace {
+constexpr quint16 TagThumbnailOffset = 0x0201; // JPEGInterchangeFormat
+constexpr quint16 TagThumbnailLength = 0x0202; // JPEGInterchangeFormatLength
+
+// IFD0
+constexpr quint16 TagMake = 0x010F;
+constexpr quint16 TagModel = 0x0110;
+constexpr quint16 TagOrientation = 0x0112;
+constexpr quint16 TagDateTime = 0x0132;
+constexpr quint16 TagExifIfd = 0x8769;
+constexpr quint16 TagGpsIfd = 0x8825;
+// Exif SubIFD
+constexpr quint16 TagDateTimeOriginal = 0x9003;
+constexpr quint16 TagOffsetTimeOriginal = 0x9011;
+constexpr quint16 TagLensModel = 0xA434;
+// GPS IFD
+constexpr quint16 TagGpsLatitudeRef = 0x0001;
+constexpr quint16 TagGpsLatitude = 0x0002;
+constexpr quint16 TagGpsLongitudeRef = 0x0003;
+constexpr quint16 TagGpsLongitude = 0x0004;
+constexpr quint16 TagGpsAltitudeRef = 0x0005;
+constexpr quint16 TagGpsAltitude = 0x0006;
+
+// Datentypen der IFD-Einträge
+constexpr quint16 TypeByte = 1;
+constexpr quint16 TypeAscii = 2;
+constexpr quint16 TypeShort = 3;
+constexpr quint16 TypeLong = 4;
+constexpr quint16 TypeRational = 5;
+constexpr quint16 TypeSRational = 10;
+
+constexpr qint64 BlockSize = 256 * 1024;
+
+const QByteArray JpegStart("\xFF\xD8", 2);
+const QByteArray ExifHeader("Exif\0\0", 6);
+const QByteArray XmpHeader("http://ns.adobe.com/xap/1.0/\0", 29);
+
+// Lesen im TIFF-Block mit dessen Byte-Reihenfolge ("II" little endian, "MM" big endian)
+class Tiff
+{
+public:
+    explicit Tiff(const QByteArray &data)
+        : m_data(data)
+        , m_little(data.startsWith("II"))
+    {}
+
+    bool isValid() const
+    {
+        return m_data.size() >= 8 && (m_data.startsWith("II") || m_data.startsWith("MM")) && u16(2) == 42;
+    }
+
+    bool contains(qint64 offset, qint64 length) const
+    {
+        return offset >= 0 && length >= 0 && offset + length <= m_data.size();
+    }
+
+    quint8 u8(qint64 offset) const
+    {
+        return contains(offset, 1) ? static_cast<quint8>(m_data.at(offset)) : 0;
+    }
+
+    quint16 u16(qint64 offset) const
+    {
+        if (!contains(offset, 2))
+            return 0;
+        const auto *p = reinterpret_cast<const uchar *>(m_data.constData() + offset);
+        return m_little ? quint16(p[0] | p[1] << 8) : quint16(p[0] << 8 | p[1]);
+    }
+
+    quint32 u32(qint64 offset) const
+    {
+        if (!contains(offset, 4))
+            return 0;
+        const auto *p = reinterpret_cast<const uchar *>(m_data.constData() + offset);
+        return m_little ? quint32(p[0]) | quint32(p[1]) << 8 | quint32(p[2]) << 16 | quint32(p[3]) << 24
+                        : quint32(p[0]) << 24 | quint32(p[1]) << 16 | quint32(p[2]) << 8 | quint32(p[3]);
+    }
+
+    // Offset des nächsten IFD hinter dem IFD bei offset (0: keins)
+    quint32 nextIfd(quint32 offset) const { return u32(offset + 2 + 12 * qint64(u16(offset))); }
+
+    QByteArray mid(qint64 offset, qint64 length) const { return m_data.mid(offset, length); }
+
+    // Einträge eines IFD: f(tag, Offset des 12-Byte-Eintrags)
+    template<typename F>
+    void forEachEntry(quint32 ifd, F f) const
+    {
+        if (ifd == 0 || !contains(ifd, 2))
+            return;
+        const quint16 count = u16(ifd);
+        for (quint16 i = 0; i < count; ++i) {
+            const qint64 entry = ifd + 2 + 12 * qint64(i);
+            if (!contains(entry, 12))
+                return;
+            f(u16(entry), entry);
+        }
+    }
+
+    // Ganzzahl (BYTE, SHORT, LONG) aus einem Eintrag
+    quint32 number(qint64 entry) const
+    {
+        switch (u16(entry + 2)) {
+        case TypeByte:
+            return u8(entry + 8);
+        case TypeShort:
+            return u16(entry + 8);
+        case TypeLong:
+            return u32(entry + 8);
+        default:
+            return 0;
+        }
+    }
+
+    QString ascii(qint64 entry) const
+    {
+        if (u16(entry + 2) != TypeAscii)
+            return QString();
+        // Bis 4 Bytes stehen direkt im Eintrag, sonst dessen Offset
+        const quint32 count = u32(entry + 4);
+        const qint64 offset = count <= 4 ? entry + 8 : u32(entry + 8);
+        if (!contains(offset, count))
+            return QString();
+        QByteArray bytes = m_data.mid(offset, count);
+        const qsizetype end = bytes.indexOf('\0');
+        if (end >= 0)
+            bytes.truncate(end);
+        return QString::fromUtf8(bytes).trimmed();
+    }
+
+    // index-ter Wert eines (S)RATIONAL-Eintrags, false bei falschem Typ oder Nenner 0
+    bool rational(qint64 entry, quint32 index, double *value) const
+    {
+        const quint16 type = u16(entry + 2);
+        if ((type != TypeRational && type != TypeSRational) || index >= u32(entry + 4))
+            return false;
+        const qint64 offset = u32(entry + 8) + 8 * qint64(index);
+        if (!contains(offset, 8) || u32(offset + 4) == 0)
+            return false;
+        if (type == TypeSRational)
+            *value = double(qint32(u32(offset))) / qint32(u32(offset + 4));
+        else
+            *value = double(u32(offset)) / u32(offset + 4);
+        return true;
+    }
+
+private:
+    const QByteArray &m_data;
+    bool m_little;
+};
+
+struct Segments
+{
+    QByteArray exif; // TIFF-Block
+    QByteArray xmp;  // XML-Paket
+};
+
+// Nur Marker und APP1-Segmente lesen, bis zu den Bilddaten (SOS) bzw. MaxHeaderSize;
+// ohne withXmp endet die Suche schon beim EXIF-Block
+Segments jpegSegments(QIODevice &device, bool withXmp)
+{
+    Segments segments;
+    if (device.read(2) != JpegStart)
+        return segments;
+
+    qint64 pos = 2;
+    while (pos < ExifReader::MaxHeaderSize
+           && (segments.exif.isEmpty() || (withXmp && segments.xmp.isEmpty())) && device.seek(pos)) {
+        const QByteArray head = device.read(4);
+        if (head.size() < 2 || static_cast<uchar>(head.at(0)) != 0xFF)
+            break;
+        const uchar marker = static_cast<uchar>(head.at(1));
+        if (marker == 0xFF) { // Füllbyte
+            ++pos;
+            continue;
+        }
+        if (marker == 0xDA || marker == 0xD9 || head.size() < 4) // Bilddaten: kein EXIF danach
+            break;
+
+        const int length = static_cast<uchar>(head.at(2)) << 8 | static_cast<uchar>(head.at(3));
+        if (marker == 0xE1 && length > 2) {
+            const QByteArray data = device.read(length - 2);
+            if (segments.exif.isEmpty() && data.startsWith(ExifHeader))
+                segments.exif = data.mid(ExifHeader.size());
+            else if (segments.xmp.isEmpty() && data.startsWith(XmpHeader))
+                segments.xmp = data.mid(XmpHeader.size());
+        }
+        pos += 2 + length;
+    }
+    return segments;
+}
+
+bool isTiff(const QByteArray &head)
+{
+    return head.startsWith(QByteArray("II*\0", 4)) || head.startsWith(QByteArray("MM\0*", 4));
+}
+
+// "2024:05:01 13:45:10" -> "2024-05-01T13:45:10", leere oder genullte Angaben verwerfen
+QString isoDate(const QString &exifDate, const QString &offset)
+{
+    if (exifDate.size() < 19 || exifDate.startsWith("0000") || exifDate.at(4) != ':')
+        return QString();
+    QString iso = exifDate.left(19);
+    iso[4] = '-';
+    iso[7] = '-';
+    iso[10] = 'T';
+    return iso + offset;
+}
+
+// Grad, Minuten, Sekunden als drei RATIONAL
+bool degrees(const Tiff &tiff, qint64 entry, double *value)
+{
+    double d = 0;
+    double m = 0;
+    double s = 0;
+    if (!tiff.rational(entry, 0, &d) || !tiff.rational(entry, 1, &m) || !tiff.rational(entry, 2, &s))
+        return false;
+    *value = d + m / 60 + s / 3600;
+    return true;
+}
+
+void readGps(const Tiff &tiff, quint32 ifd, ExifReader::Metadata &metadata)
+{
+    QString latRef;
+    QString lonRef;
+    qint64 lat = -1;
+    qint64 lon = -1;
+    qint64 alt = -1;
+    quint32 altRef = 0;
+    tiff.forEachEntry(ifd, [&](quint16 tag, qint64 entry) {
+        switch (tag) {
+        case TagGpsLatitudeRef:
+            latRef = tiff.ascii(entry);
+            break;
+        case TagGpsLatitude:
+            lat = entry;
+            break;
+        case TagGpsLongitudeRef:
+            lonRef = tiff.ascii(entry);
+            break;
+        case TagGpsLongitude:
+            lon = entry;
+            break;
+        case TagGpsAltitudeRef:
+            altRef = tiff.number(entry);
+            break;
+        case TagGpsAltitude:
+            alt = entry;
+            break;
+        }
+    });
+
+    double latitude = 0;
+    double longitude = 0;
+    if (lat < 0 || lon < 0 || !degrees(tiff, lat, &latitude) || !degrees(tiff, lon, &longitude))
+        return;
+    // Manche Kameras schreiben 0/0 ohne GPS-Fix
+    if (latitude == 0 && longitude == 0)
+        return;
+    metadata.hasGps = true;
+    metadata.latitude = latRef.startsWith('S') ? -latitude : latitude;
+    metadata.longitude = lonRef.startsWith('W') ? -longitude : longitude;
+
+    double altitude = 0;
+    if (alt >= 0 && tiff.rational(alt, 0, &altitude)) {
+        metadata.hasAltitude = true;
+        metadata.altitude = altRef == 1 ? -altitude : altitude;
+    }
+}
+
+void readExif(const QByteArray &exif, ExifReader::Metadata &metadata)
+{
+    const Tiff tiff(exif);
+    if (!tiff.isValid())
+        return;
+
+    QString dateTime;
+    quint32 exifIfd = 0;
+    quint32 gpsIfd = 0;
+    tiff.forEachEntry(tiff.u32(4), [&](quint16 tag, qint64 entry) {
+        switch (tag) {
+        case TagMake:
+            metadata.make = tiff.ascii(entry);
+            break;
+        case TagModel:
+            metadata.model = tiff.ascii(entry);
+            break;
+        case TagOrientation:
+            metadata.orientation = int(tiff.number(entry));
+            break;
+        case TagDateTime:
+            dateTime = tiff.ascii(entry);
+            break;
+        case TagExifIfd:
+            exifIfd = tiff.number(entry);
+            break;
+        case TagGpsIfd:
+            gpsIfd = tiff.number(entry);
+            break;
+        }
+    });
+    if (metadata.orientation < 1 || metadata.orientation > 8)
+        metadata.orientation = 0;
+
+    QString original;
+    QString offset;
+    tiff.forEachEntry(exifIfd, [&](quint16 tag, qint64 entry) {
+        switch (tag) {
+        case TagDateTimeOriginal:
+            original = tiff.ascii(entry);
+            break;
+        case TagOffsetTimeOriginal:
+            offset = tiff.ascii(entry);
+            break;
+        case TagLensModel:
+            metadata.lens = tiff.ascii(entry);
+            break;
+        }
+    });
+    // DateTime (IFD0) ist die letzte Änderung, nur ohne DateTimeOriginal verwenden
+    metadata.captured = isoDate(original, offset);
+    if (metadata.captured.isEmpty())
+        metadata.captured = isoDate(dateTime, QString());
+
+    readGps(tiff, gpsIfd, metadata);
+}
+
+// Einfache XMP-Eigenschaft als Attribut (name="wert") oder Element (<name>wert</name>)
+QString xmpValue(const QByteArray &xmp, const QByteArray &name)
+{
+    const QByteArray attribute = name + "=\"";
+    for (qsizetype pos = xmp.indexOf(attribute); pos >= 0; pos = xmp.indexOf(attribute, pos + 1)) {
+        // Nur ganze Namen: davor steht Leerraum, kein Teil eines längeren Namens
+        if (pos > 0 && !QChar::isSpace(static_cast<uchar>(xmp.at(pos - 1))))
+            continue;
+        const qsizetype start = pos + attribute.size();
+        const qsizetype end = xmp.indexOf('"', start);
+        return end < 0 ? QString() : QString::fromUtf8(xmp.mid(start, end - start)).trimmed();
+    }
+    const QByteArray element = "<" + name + ">";
+    const qsizetype pos = xmp.indexOf(element);
+    if (pos >= 0) {
+        const qsizetype start = pos + element.size();
+        const qsizetype end = xmp.indexOf("</" + name + ">", start);
+        return end < 0 ? QString() : QString::fromUtf8(xmp.mid(start, end - start)).trimmed();
+    }
+    return QString();
+}
+
+// XMP ergänzt nur, was EXIF nicht liefert (z.B. nachträglich in Lightroom gesetzt)
+void readXmp(const QByteArray &xmp, ExifReader::Metadata &metadata)
+{
+    if (xmp.isEmpty())
+        return;
+
+    const auto fill = [&xmp](QString &field, std::initializer_list<QByteArray> names) {
+        for (const QByteArray &name : names) {
+            if (!field.isEmpty())
+                return;
+            field = xmpValue(xmp, name);
+        }
+    };
+    fill(metadata.captured, {"exif:DateTimeOriginal", "photoshop:DateCreated", "xmp:CreateDate"});
+    fill(metadata.make, {"tiff:Make"});
+    fill(metadata.model, {"tiff:Model"});
+    fill(metadata.lens, {"exifEX:LensModel", "aux:Lens"});
+    if (metadata.orientation == 0) {
+        const int orientation = xmpValue(xmp, "tiff:Orientation").toInt();
+        if (orientation >= 1 && orientation <= 8)
+            metadata.orientation = orientation;
+    }
+
+    bool ok = false;
+    const int rating = xmpValue(xmp, "xmp:Rating").toInt(&ok);
+    if (ok && rating >= 0 && rating <= 5)
+        metadata.rating = rating;
+}
+
+bool copyRange(QFile &input, QFile &output, qint64 offset, qint64 length)
+{
+    if (!input.seek(offset))
+        return false;
+    QByteArray block(std::min(length, BlockSize), Qt::Uninitialized);
+    while (length > 0) {
+        const qint64 read = input.read(block.data(), std::min<qint64>(length, block.size()));
+        if (read <= 0 || output.write(block.constData(), read) != read)
+            return false;
+        length -= read;
+    }
+    return true;
+}
+} // namespace
+
+bool ExifReader::Metadata::isEmpty() const
+{
+    return captured.isEmpty() && make.isEmpty() && model.isEmpty() && lens.isEmpty() && orientation == 0
+           && rating < 0 && !hasGps;
+}
+
+QByteArray ExifReader::exifBlock(const QByteArray &jpegHead)
+{
+    QBuffer buffer;
+    buffer.setData(jpegHead);
+    buffer.open(QIODevice::ReadOnly);
+    return jpegSegments(buffer, false).exif;
+}
+
+QByteArray ExifReader::thumbnail(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+
+    const QByteArray exif = jpegSegments(file, false).exif;
+    const Tiff tiff(exif);
+    if (!tiff.isValid())
+        return QByteArray();
+
+    const quint32 ifd1 = tiff.nextIfd(tiff.u32(4));
+    if (ifd1 == 0 || !tiff.contains(ifd1, 2))
+        return QByteArray();
+
+    quint32 offset = 0;
+    quint32 length = 0;
+    const quint16 count = tiff.u16(ifd1);
+    for (quint16 i = 0; i < count; ++i) {
+        const qint64 entry = ifd1 + 2 + 12 * qint64(i);
+        const quint16 tag = tiff.u16(entry);
+        if (tag == TagThumbnailOffset)
+            offset = tiff.u32(entry + 8);
+        else if (tag == TagThumbnailLength)
+            length = tiff.u32(entry + 8);
+    }
+
+    if (length == 0 || !tiff.contains(offset, length))
+        return QByteArray();
+    return tiff.mid(offset, length);
+}
+
+ExifReader::Metadata ExifReader::read(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return Metadata();
+
+    // TIFF: die Datei selbst ist der TIFF-Block; JPEG: nur die APP1-Segmente lesen
+    Metadata metadata;
+    if (isTiff(file.peek(4))) {
+        readExif(file.read(MaxHeaderSize), metadata);
+        return metadata;
+    }
+    const Segments segments = jpegSegments(file, true);
+    readExif(segments.exif, metadata);
+    readXmp(segments.xmp, metadata);
+    return metadata;
+}
+
+ExifReader::Metadata ExifReader::parse(const QByteArray &head)
+{
+    Metadata metadata;
+    if (isTiff(head)) {
+        readExif(head, metadata);
+        return metadata;
+    }
+    QBuffer buffer;
+    buffer.setData(head);
+    buffer.open(QIODevice::ReadOnly);
+    const Segments segments = jpegSegments(buffer, true);
+    readExif(segments.exif, metadata);
+    readXmp(segments.xmp, metadata);
+    return metadata;
+}
+
+QJsonObject ExifReader::toJson(const Metadata &metadata)
+{
+    QJsonObject json;
+    if (!metadata.captured.isEmpty())
+        json["captured"] = metadata.captured;
+    if (!metadata.make.isEmpty())
+        json["make"] = metadata.make;
+    if (!metadata.model.isEmpty())
+        json["model"] = metadata.model;
+    if (!metadata.lens.isEmpty())
+        json["lens"] = metadata.lens;
+    if (metadata.orientation > 0)
+        json["orientation"] = metadata.orientation;
+    if (metadata.rating >= 0)
+        json["rating"] = metadata.rating;
+    if (metadata.hasGps) {
+        QJsonObject gps{{"lat", metadata.latitude}, {"lon", metadata.longitude}};
+        if (metadata.hasAltitude)
+            gps["alt"] = metadata.altitude;
+        json["gps"] = gps;
+    }
+    return json;
+}
+
+ExifReader::StripResult ExifReader::strip(const QString &filePath, const QString &outputDir)
+{
+    StripResult result;
+    QFile input(filePath);
+    if (!input.open(QIODevice::ReadOnly)) {
+        result.error = input.errorString();
+        return result;
+    }
+    if (input.read(2) != JpegStart)
+        return result;
+
+    // Erst die Segmente vor den Bilddaten durchgehen: was bleibt, und lohnt es sich?
+    QList<std::pair<qint64, qint64>> keep; // Offset, Länge
+    bool removed = false;
+    qint64 pos = 2;
+    while (true) {
+        if (!input.seek(pos))
+            return result;
+        const QByteArray head = input.read(4);
+        if (head.size() < 4 || static_cast<uchar>(head.at(0)) != 0xFF)
+            return result; // unbekannter Aufbau: lieber das Original senden
+        const uchar marker = static_cast<uchar>(head.at(1));
+        if (marker == 0xFF) {
+            ++pos;
+            continue;
+        }
+        if (marker == 0xDA) // SOS: ab hier Bilddaten, unverändert übernehmen
+            break;
+
+        const int length = static_cast<uchar>(head.at(2)) << 8 | static_cast<uchar>(head.at(3));
+        if (length < 2 || pos + 2 + length > input.size())
+            return result;
+        // APP1 (EXIF, XMP), APP13 (IPTC), COM
+        if (marker == 0xE1 || marker == 0xED || marker == 0xFE)
+            removed = true;
+        else
+            keep.append({pos, 2 + length});
+        pos += 2 + length;
+    }
+    if (!removed)
+        return result;
+
+    QFile output(outputDir + "/" + QUuid::createUuid().toString(QUuid::WithoutBraces) + ".jpg");
+    if (!output.open(QIODevice::WriteOnly)) {
+        result.error = output.errorString();
+        return result;
+    }
+    bool ok = output.write(JpegStart) == JpegStart.size();
+    for (const auto &[offset, length] : std::as_const(keep))
+        ok = ok && copyRange(input, output, offset, length);
+    ok = ok && copyRange(input, output, pos, input.size() - pos);
+    output.close();
+    if (!ok) {
+        result.error = output.errorString().isEmpty() ? input.errorString() : output.errorString();
+        output.remove();
+        return result;
+    }
+
+    result.stripped = true;
+    result.outputPath = output.fileName();
+    result.size = output.size();
+    return result;
+}
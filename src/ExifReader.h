@@ -0,0 +1,68 @@
+/**
+ * @file ExifReader.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief minimal EXIF/XMP parser for JPEG and TIFF files (preview image, capture metadata, stripping)
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+
+namespace ExifReader {
+
+// Der APP1-Block mit EXIF muss laut Spezifikation in die ersten 64 KiB passen
+constexpr qint64 MaxHeaderSize = 128 * 1024;
+
+// Aufnahmedaten, soweit EXIF (bzw. ersatzweise XMP) sie enthält
+struct Metadata
+{
+    QString captured; // ISO 8601, mit Zeitzone nur wenn OffsetTimeOriginal gesetzt ist
+    QString make;
+    QString model;
+    QString lens;
+    int orientation = 0; // 1..8, 0 = unbekannt
+    int rating = -1;     // XMP 0..5, -1 = keins
+    bool hasGps = false;
+    double latitude = 0;  // Grad, Süd negativ
+    double longitude = 0; // Grad, West negativ
+    bool hasAltitude = false;
+    double altitude = 0; // Meter, unter dem Meeresspiegel negativ
+
+    bool isEmpty() const;
+};
+
+struct StripResult
+{
+    bool stripped = false; // false: Original hochladen
+    QString outputPath;
+    qint64 size = 0;
+    QString error;
+};
+
+// TIFF-Daten des EXIF-Blocks (nach "Exif\0\0"), leer bei Nicht-JPEG oder ohne EXIF
+QByteArray exifBlock(const QByteArray &jpegHead);
+
+// Eingebettetes JPEG-Vorschaubild aus IFD1, leer wenn keins vorhanden.
+// Liest nur den Dateikopf, thread-safe.
+QByteArray thumbnail(const QString &filePath);
+
+// Aufnahmedatum, Kamera, Objektiv, Ausrichtung und GPS aus den ersten MaxHeaderSize Bytes
+// (JPEG: APP1 EXIF und XMP, TIFF: IFD0). Thread-safe, läuft im Worker-Pool der Upload Queue.
+Metadata read(const QString &filePath);
+Metadata parse(const QByteArray &head);
+
+// Nur gesetzte Felder, z.B. {"captured":"2024-05-01T13:45:10","gps":{"lat":..,"lon":..}}
+QJsonObject toJson(const Metadata &metadata);
+
+// JPEG ohne EXIF, XMP, IPTC und Kommentare (APP1, APP13, COM) nach outputDir kopieren.
+// ICC-Profil und Bilddaten bleiben unverändert; die Ausrichtung steckt dann nur noch
+// in den separat gesendeten Metadaten. Nicht-JPEG oder nichts zu entfernen: stripped = false.
+StripResult strip(const QString &filePath, const QString &outputDir);
+
+} // namespace ExifReader
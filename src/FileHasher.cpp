@@ -0,0 +1,31 @@
+#include "FileHasher.h"
+
+#include <QByteArrayView>
+#include <QFile>
+
+#include <algorithm>
+
+QByteArray FileHasher::hashFile(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+
+    QCryptographicHash hash(Algorithm);
+    const qint64 size = file.size();
+    constexpr qint64 Window = 64 * 1024 * 1024;
+
+    for (qint64 offset = 0; offset < size; offset += Window) {
+        const qint64 length = std::min(Window, size - offset);
+        uchar *data = file.map(offset, length);
+        if (!data) {
+            // mmap nicht möglich (z.B. Netzlaufwerk): Rest normal lesen
+            if (!file.seek(offset) || !hash.addData(&file))
+                return QByteArray();
+            break;
+        }
+        hash.addData(QByteArrayView(reinterpret_cast<const char *>(data), length));
+        file.unmap(data);
+    }
+    return hash.result();
+}
@@ -0,0 +1,27 @@
+/**
+ * @file FileHasher.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief content hash of local files
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QString>
+
+namespace FileHasher {
+
+// BLAKE2b ist in Software deutlich schneller als SHA-256 und in Qt ohne Zusatz-Lib verfügbar.
+// Der Server muss denselben Algorithmus verwenden (siehe mock/MockCrowServer.cpp).
+constexpr auto Algorithm = QCryptographicHash::Blake2b_256;
+
+// Liest die Datei per mmap in Fenstern; liefert ein leeres Array bei Fehlern.
+// Thread-safe, läuft in den Worker-Threads der Upload Queue.
+QByteArray hashFile(const QString &filePath);
+
+} // namespace FileHasher
@@ -0,0 +1,263 @@
+#include "FolderSync.h"
+#include "FileHasher.h"
+#include "ImageFiles.h"
+#include "NetworkCall.h"
+#include "RetryPolicy.h"
+#include "UploadIndex.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkRequest>
+#include <QUrlQuery>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <utility>
+
+FolderSync::FolderSync(QNetworkAccessManager *manager, UploadIndex *index, QObject *parent)
+    : QObject(parent)
+    , m_netManager(manager)
+    , m_index(index)
+{}
+
+void FolderSync::setServerUrl(const QString &url)
+{
+    m_serverUrl = url;
+}
+
+void FolderSync::setDispatcher(const Authorization::Dispatcher &dispatcher)
+{
+    m_dispatcher = dispatcher;
+}
+
+void FolderSync::setPresenceOnly(bool presenceOnly)
+{
+    m_presenceOnly = presenceOnly;
+}
+
+bool FolderSync::isRunning() const
+{
+    return m_running;
+}
+
+bool FolderSync::start(const QString &root, const QString &serverPath)
+{
+    if (m_running)
+        return false;
+
+    m_running = true;
+    const quint64 generation = ++m_generation;
+    m_haveLocal = false;
+    m_haveRemote = false;
+    m_elapsed.start();
+    m_result = Result();
+    m_result.root = QDir(root).absolutePath();
+    m_result.serverPath = serverPath;
+
+    // Lokaler Scan und Manifest laufen parallel
+    QtConcurrent::run(&FolderSync::scanLocal, m_result.root)
+        .then(this, [this, generation](const QList<LocalFile> &files) {
+            if (generation == m_generation)
+                onScanned(files);
+        });
+
+    if (!m_dispatcher) {
+        finish(tr("No dispatcher for authorized requests."));
+        return true;
+    }
+    m_dispatcher([this, generation](const QString &token) {
+        if (generation == m_generation)
+            sendManifestRequest(token);
+    });
+    return true;
+}
+
+QList<FolderSync::LocalFile> FolderSync::scanLocal(const QString &root)
+{
+    // fileInfo() des Iterators: ein stat pro Datei, nicht zwei wie mit scanDirectory + QFileInfo
+    const QDir rootDir(root);
+    QList<LocalFile> files;
+    QDirIterator it(root, ImageFiles::NAME_FILTERS, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        LocalFile file;
+        file.filePath = info.absoluteFilePath();
+        file.relPath = rootDir.relativeFilePath(file.filePath);
+        file.size = info.size();
+        file.mtime = info.lastModified().toMSecsSinceEpoch();
+        files.append(file);
+    }
+    return files;
+}
+
+QString FolderSync::targetPath(const QString &serverPath, const QString &relPath)
+{
+    // Wie UploadEngine::enqueue: Unterordner bleiben unter serverPath erhalten
+    const QString relDir = QFileInfo(relPath).path();
+    if (relDir == ".")
+        return serverPath;
+    return serverPath.isEmpty() ? relDir : serverPath + "/" + relDir;
+}
+
+void FolderSync::sendManifestRequest(const QString &token)
+{
+    if (!m_running)
+        return;
+    if (token.isEmpty()) {
+        finish(tr("Not logged in."));
+        return;
+    }
+
+    QUrl url(m_serverUrl + "/upload/manifest");
+    QUrlQuery query;
+    query.addQueryItem("path", m_result.serverPath);
+    url.setQuery(query);
+
+    QNetworkRequest request(url);
+    request.setRawHeader("Authorization", ("Bearer " + token).toUtf8());
+    // Manifest kann groß sein, gzip nimmt Qt selbst an und dekodiert es
+    NetworkCall *call = NetworkCall::get(m_netManager,
+                                         request,
+                                         this,
+                                         [this, generation = m_generation](QNetworkReply *reply) {
+                                             if (generation == m_generation)
+                                                 onManifest(reply);
+                                         });
+    // GET ist idempotent: vorübergehende Fehler einfach wiederholen
+    call->setMaxRetries(RetryPolicy::MaxRetries);
+}
+
+void FolderSync::onManifest(QNetworkReply *reply)
+{
+    if (!m_running)
+        return;
+
+    const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (statusCode == 404) {
+        finish(tr("Server does not provide a manifest (/upload/manifest)."));
+        return;
+    }
+    if (reply->error() != QNetworkReply::NoError) {
+        finish(tr("Manifest request failed: %1").arg(reply->errorString()));
+        return;
+    }
+
+    // Kompakt: {"files":[["sub/name.jpg", size, "blake2b hex"], ...]}
+    const QJsonArray files = QJsonDocument::fromJson(reply->readAll()).object()["files"].toArray();
+    m_remote.clear();
+    m_remote.reserve(files.size());
+    for (const QJsonValue &value : files) {
+        const QJsonArray entry = value.toArray();
+        RemoteFile remote;
+        remote.size = entry.at(1).toInteger();
+        remote.hash = QByteArray::fromHex(entry.at(2).toString().toLatin1());
+        m_remote.insert(entry.at(0).toString(), remote);
+    }
+
+    m_haveRemote = true;
+    if (m_haveLocal)
+        compare();
+}
+
+void FolderSync::onScanned(const QList<LocalFile> &files)
+{
+    if (!m_running)
+        return;
+    m_local = files;
+    m_haveLocal = true;
+    if (m_haveRemote)
+        compare();
+}
+
+void FolderSync::compare()
+{
+    // Zählt eine Datei mit bekanntem Hash; gleiche landen auch im Index, damit die Dedup sie kennt
+    const auto classify = [this](const LocalFile &file, const RemoteFile &remote) {
+        if (!file.hash.isEmpty() && file.hash == remote.hash) {
+            ++m_result.unchanged;
+            if (m_index) {
+                m_index->recordUpload(file.filePath,
+                                      file.size,
+                                      file.mtime,
+                                      file.hash,
+                                      targetPath(m_result.serverPath, file.relPath));
+            }
+        } else {
+            ++m_result.changed;
+            m_result.upload.append(file.filePath);
+        }
+    };
+
+    QList<int> pending;
+    for (qsizetype i = 0; i < m_local.size(); ++i) {
+        LocalFile &file = m_local[i];
+        const auto it = m_remote.constFind(file.relPath);
+        if (it == m_remote.constEnd()) {
+            ++m_result.added;
+            m_result.upload.append(file.filePath);
+        } else if (m_presenceOnly || it->hash.isEmpty()) {
+            // Ohne vergleichbaren Inhalt (transkodiert, Server ohne Hash) zählt die Größe nicht
+            if (!m_presenceOnly && it->size != file.size) {
+                ++m_result.changed;
+                m_result.upload.append(file.filePath);
+            } else {
+                ++m_result.unchanged;
+            }
+        } else if (it->size != file.size) {
+            ++m_result.changed;
+            m_result.upload.append(file.filePath);
+        } else {
+            if (m_index)
+                file.hash = m_index->cachedHash(file.filePath, file.size, file.mtime);
+            if (file.hash.isEmpty())
+                pending.append(int(i));
+            else
+                classify(file, *it);
+        }
+    }
+
+    if (pending.isEmpty()) {
+        finish();
+        return;
+    }
+
+    // Nur gleich große Dateien ohne gecachten Hash werden gelesen, parallel im globalen Pool
+    QStringList paths;
+    paths.reserve(pending.size());
+    for (const int i : std::as_const(pending))
+        paths.append(m_local.at(i).filePath);
+    QtConcurrent::mapped(std::move(paths), &FileHasher::hashFile)
+        .then(this, [this, generation = m_generation, pending, classify](QFuture<QByteArray> future) {
+            if (generation != m_generation || !m_running)
+                return;
+            const QList<QByteArray> hashes = future.results();
+            for (qsizetype k = 0; k < pending.size(); ++k) {
+                LocalFile &file = m_local[pending.at(k)];
+                file.hash = hashes.value(k);
+                if (m_index && !file.hash.isEmpty())
+                    m_index->updateHash(file.filePath, file.size, file.mtime, file.hash);
+                classify(file, m_remote.value(file.relPath));
+            }
+            finish();
+        });
+}
+
+void FolderSync::finish(const QString &error)
+{
+    m_running = false;
+    m_result.error = error;
+    m_result.elapsedMs = m_elapsed.elapsed();
+    m_result.upload.sort();
+    m_local.clear();
+    m_remote.clear();
+    if (m_index)
+        m_index->save();
+
+    const Result result = std::exchange(m_result, Result());
+    emit finished(result);
+}
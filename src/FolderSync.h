@@ -0,0 +1,103 @@
+/**
+ * @file FolderSync.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief compares a local folder tree with the server manifest and finds new or changed files
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include "Authorization.h"
+
+class UploadIndex;
+
+/*
+ * Ablauf: lokalen Baum einlesen (Worker-Thread, nur stat) und parallel dazu
+ * GET /upload/manifest?path=... holen. Der Vergleich läuft über relative Pfade
+ * in einer Hash-Tabelle: fehlt die Datei remote oder weicht die Größe ab, ist
+ * sie neu bzw. geändert. Bei gleicher Größe entscheidet der Hash; der kommt
+ * aus dem UploadIndex, nur unbekannte Dateien werden (parallel) gehasht.
+ * Ein erneuter Sync unveränderter Dateien braucht so nur stat und Lookups.
+ */
+class FolderSync : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Result
+    {
+        QString root;
+        QString serverPath;
+        QStringList upload; // neue und geänderte Dateien (absolut)
+        int added = 0;
+        int changed = 0;
+        int unchanged = 0;
+        qint64 elapsedMs = 0;
+        QString error; // leer bei Erfolg
+    };
+
+    FolderSync(QNetworkAccessManager *manager, UploadIndex *index, QObject *parent = nullptr);
+
+    void setServerUrl(const QString &url);
+    void setDispatcher(const Authorization::Dispatcher &dispatcher);
+    // Nur vorhanden/nicht vorhanden vergleichen (z.B. wenn vor dem Upload transkodiert wird)
+    void setPresenceOnly(bool presenceOnly);
+
+    // Läuft asynchron, am Ende kommt genau ein finished(); ein laufender Sync wird nicht unterbrochen
+    bool start(const QString &root, const QString &serverPath);
+    bool isRunning() const;
+
+signals:
+    void finished(const FolderSync::Result &result);
+
+private:
+    struct LocalFile
+    {
+        QString filePath;
+        QString relPath;
+        qint64 size = 0;
+        qint64 mtime = 0;
+        QByteArray hash;
+    };
+    struct RemoteFile
+    {
+        qint64 size = 0;
+        QByteArray hash; // leer, wenn der Server keinen kennt
+    };
+
+    static QList<LocalFile> scanLocal(const QString &root);
+    static QString targetPath(const QString &serverPath, const QString &relPath);
+    void sendManifestRequest(const QString &token);
+    void onManifest(QNetworkReply *reply);
+    void onScanned(const QList<LocalFile> &files);
+    void compare();
+    void finish(const QString &error = QString());
+
+    QNetworkAccessManager *m_netManager;
+    UploadIndex *m_index;
+    QString m_serverUrl;
+    Authorization::Dispatcher m_dispatcher;
+    bool m_presenceOnly = false;
+
+    bool m_running = false;
+    quint64 m_generation = 0; // Ergebnisse eines früheren Laufs verwerfen
+    bool m_haveLocal = false;
+    bool m_haveRemote = false;
+    QElapsedTimer m_elapsed;
+    Result m_result;
+    QList<LocalFile> m_local;
+    QHash<QString, RemoteFile> m_remote; // relativer Pfad -> Größe/Hash
+};
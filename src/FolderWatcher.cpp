@@ -0,0 +1,395 @@
+#include "FolderWatcher.h"
+#include "ImageFiles.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+constexpr quint32 SnapshotMagic = 0x43525753; // "CRWS"
+constexpr quint32 SnapshotVersion = 1;
+
+qint64 modified(const QFileInfo &info)
+{
+    return info.lastModified().toMSecsSinceEpoch();
+}
+
+bool isBelow(const QString &path, const QString &dir)
+{
+    return path == dir || path.startsWith(dir + '/');
+}
+} // namespace
+
+FolderWatcher::FolderWatcher(QObject *parent)
+    : QObject(parent)
+{
+    m_clock.start();
+
+    m_scanTimer.setSingleShot(true);
+    m_scanTimer.setInterval(ScanDelay);
+    connect(&m_scanTimer, &QTimer::timeout, this, &FolderWatcher::rescanDirty);
+
+    // Läuft nur, solange Dateien auf "fertig geschrieben" warten
+    m_settleTimer.setInterval(SettleCheck);
+    connect(&m_settleTimer, &QTimer::timeout, this, &FolderWatcher::checkCandidates);
+
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(SaveDelay);
+    connect(&m_saveTimer, &QTimer::timeout, this, &FolderWatcher::saveSnapshot);
+
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &FolderWatcher::onDirectoryChanged);
+}
+
+FolderWatcher::~FolderWatcher()
+{
+    if (m_active)
+        saveSnapshot();
+}
+
+QString FolderWatcher::snapshotLocation(const QString &folder)
+{
+    const QByteArray key = QCryptographicHash::hash(QDir(folder).absolutePath().toUtf8(),
+                                                    QCryptographicHash::Sha1)
+                               .toHex()
+                               .left(16);
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/watch-"
+           + QString::fromLatin1(key) + ".dat";
+}
+
+bool FolderWatcher::start(const QString &folder)
+{
+    stop();
+
+    const QFileInfo info(folder);
+    if (!info.isDir())
+        return false;
+
+    m_folder = info.absoluteFilePath();
+    m_snapshotFile = snapshotLocation(m_folder);
+    m_active = true;
+    if (!loadSnapshot())
+        m_snapshot.clear();
+
+    // Events schon während des ersten Scans mitnehmen
+    m_watcher.addPath(m_folder);
+    m_scanning = true;
+    const quint64 generation = ++m_generation;
+    QtConcurrent::run(&FolderWatcher::scanTree, m_folder, m_snapshot)
+        .then(this, [this, generation](const ScanResult &result) {
+            if (generation == m_generation)
+                onScanned(result);
+        });
+    return true;
+}
+
+void FolderWatcher::stop()
+{
+    if (!m_active)
+        return;
+
+    saveSnapshot();
+    ++m_generation;
+    m_active = false;
+    m_scanning = false;
+    m_scanTimer.stop();
+    m_settleTimer.stop();
+    m_saveTimer.stop();
+    if (!m_watcher.directories().isEmpty())
+        m_watcher.removePaths(m_watcher.directories());
+    m_dirty.clear();
+    m_candidates.clear();
+    m_snapshot.clear();
+    m_folder.clear();
+}
+
+bool FolderWatcher::isActive() const
+{
+    return m_active;
+}
+
+QString FolderWatcher::folder() const
+{
+    return m_folder;
+}
+
+FolderWatcher::ScanResult FolderWatcher::scanTree(const QString &root, Snapshot previous)
+{
+    ScanResult result;
+    result.startedAt = QDateTime::currentMSecsSinceEpoch();
+
+    QStringList pending{root};
+    while (!pending.isEmpty()) {
+        const QString path = pending.takeLast();
+        DirState state = previous.take(path);
+
+        // Unveränderte Ordner-mtime: keine Datei hinzugekommen, umbenannt oder gelöscht,
+        // die Liste aus dem Snapshot gilt weiter, nur der Inhalt kann sich geändert haben
+        if (state.mtime == 0 || state.mtime != modified(QFileInfo(path)))
+            scanDirectory(path, state, result.changed);
+        else
+            checkFiles(path, state, result.changed);
+
+        for (const QString &subdir : std::as_const(state.subdirs))
+            pending.append(path + '/' + subdir);
+        result.snapshot.insert(path, state);
+    }
+    return result;
+}
+
+void FolderWatcher::scanDirectory(const QString &path, DirState &state, QStringList &changed)
+{
+    const QDir dir(path);
+    const qint64 mtime = modified(QFileInfo(path));
+
+    QHash<QString, FileState> files;
+    bool complete = true;
+    const QFileInfoList entries = dir.entryInfoList(ImageFiles::NAME_FILTERS, QDir::Files);
+    for (const QFileInfo &info : entries) {
+        const FileState current{info.size(), modified(info)};
+        const auto it = state.files.constFind(info.fileName());
+        if (it != state.files.cend() && it->size == current.size && it->mtime == current.mtime) {
+            files.insert(info.fileName(), current);
+        } else {
+            changed.append(info.absoluteFilePath());
+            complete = false;
+        }
+    }
+
+    state.files = std::move(files);
+    state.subdirs = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks);
+    // Solange Dateien noch nicht gemeldet sind, den Ordner beim nächsten Start wieder listen
+    state.mtime = complete ? mtime : 0;
+}
+
+void FolderWatcher::checkFiles(const QString &path, DirState &state, QStringList &changed)
+{
+    for (auto it = state.files.begin(); it != state.files.end();) {
+        const QFileInfo info(path + '/' + it.key());
+        if (!info.isFile()) {
+            it = state.files.erase(it);
+            continue;
+        }
+        if (info.size() == it->size && modified(info) == it->mtime) {
+            ++it;
+            continue;
+        }
+        // Überschrieben: erneut melden; bis dahin den Ordner beim nächsten Start wieder listen
+        changed.append(info.absoluteFilePath());
+        it = state.files.erase(it);
+        state.mtime = 0;
+    }
+}
+
+void FolderWatcher::onScanned(const ScanResult &result)
+{
+    m_scanning = false;
+    m_snapshot = result.snapshot;
+
+    QStringList paths = m_snapshot.keys();
+    paths.removeAll(m_folder);
+    if (!paths.isEmpty())
+        m_watcher.addPaths(paths);
+
+    // Was sich während des Scans geändert hat, hat ggf. noch keine Watch gehabt
+    for (auto it = m_snapshot.cbegin(); it != m_snapshot.cend(); ++it) {
+        if (modified(QFileInfo(it.key())) >= result.startedAt)
+            m_dirty.insert(it.key());
+    }
+    if (!m_dirty.isEmpty())
+        m_scanTimer.start();
+
+    emit message(tr("Watching %1 (%2 folders)").arg(m_folder).arg(m_snapshot.size()));
+    addCandidates(result.changed);
+    m_saveTimer.start();
+}
+
+void FolderWatcher::onDirectoryChanged(const QString &path)
+{
+    m_dirty.insert(path);
+    // Nicht neu starten: bei Dauer-Events sonst nie ein Scan
+    if (!m_scanning && !m_scanTimer.isActive())
+        m_scanTimer.start();
+}
+
+void FolderWatcher::rescanDirty()
+{
+    QStringList changed;
+    const QSet<QString> dirty = std::exchange(m_dirty, {});
+    for (const QString &path : dirty) {
+        if (!isBelow(path, m_folder))
+            continue;
+        if (!QFileInfo(path).isDir()) {
+            removeTree(path);
+            continue;
+        }
+
+        DirState &state = m_snapshot[path];
+        const QStringList previous = state.subdirs;
+        scanDirectory(path, state, changed);
+        const QStringList subdirs = state.subdirs; // state kann durch insert() ungültig werden
+
+        for (const QString &subdir : previous) {
+            if (!subdirs.contains(subdir))
+                removeTree(path + '/' + subdir);
+        }
+        for (const QString &subdir : subdirs) {
+            if (previous.contains(subdir))
+                continue;
+            // Neuer Unterordner (z.B. hineinkopiert): komplett erfassen
+            const ScanResult result = scanTree(path + '/' + subdir, {});
+            for (auto it = result.snapshot.cbegin(); it != result.snapshot.cend(); ++it)
+                m_snapshot.insert(it.key(), it.value());
+            m_watcher.addPaths(result.snapshot.keys());
+            changed += result.changed;
+        }
+    }
+
+    addCandidates(changed);
+    if (!m_saveTimer.isActive())
+        m_saveTimer.start();
+}
+
+void FolderWatcher::removeTree(const QString &path)
+{
+    QStringList removed;
+    for (auto it = m_snapshot.begin(); it != m_snapshot.end();) {
+        if (isBelow(it.key(), path)) {
+            removed.append(it.key());
+            it = m_snapshot.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    const QStringList watched = m_watcher.directories();
+    for (const QString &dir : std::as_const(removed)) {
+        if (watched.contains(dir))
+            m_watcher.removePath(dir);
+    }
+    for (auto it = m_candidates.begin(); it != m_candidates.end();) {
+        if (isBelow(it.key(), path))
+            it = m_candidates.erase(it);
+        else
+            ++it;
+    }
+}
+
+void FolderWatcher::addCandidates(const QStringList &files)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (const QString &filePath : files) {
+        if (m_candidates.contains(filePath))
+            continue;
+        const QFileInfo info(filePath);
+        Candidate candidate{{info.size(), modified(info)}, m_clock.elapsed()};
+        // Schon länger nicht mehr geändert (z.B. beim Start gefunden): sofort fertig
+        if (now - candidate.state.mtime >= SettleTime)
+            candidate.stableSince -= SettleTime;
+        m_candidates.insert(filePath, candidate);
+    }
+
+    if (!m_candidates.isEmpty()) {
+        checkCandidates();
+        if (!m_candidates.isEmpty() && !m_settleTimer.isActive())
+            m_settleTimer.start();
+    }
+}
+
+void FolderWatcher::checkCandidates()
+{
+    const qint64 now = m_clock.elapsed();
+    QStringList ready;
+    for (auto it = m_candidates.begin(); it != m_candidates.end();) {
+        const QFileInfo info(it.key());
+        if (!info.exists()) {
+            it = m_candidates.erase(it);
+            continue;
+        }
+
+        const FileState current{info.size(), modified(info)};
+        if (current.size != it->state.size || current.mtime != it->state.mtime || current.size == 0) {
+            it->state = current;
+            it->stableSince = now;
+            ++it;
+        } else if (now - it->stableSince >= SettleTime) {
+            ready.append(it.key());
+            m_snapshot[info.absolutePath()].files.insert(info.fileName(), current);
+            it = m_candidates.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (m_candidates.isEmpty())
+        m_settleTimer.stop();
+    if (ready.isEmpty())
+        return;
+
+    ready.sort();
+    if (!m_saveTimer.isActive())
+        m_saveTimer.start();
+    emit filesReady(ready);
+}
+
+bool FolderWatcher::loadSnapshot()
+{
+    QFile file(m_snapshotFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QString root;
+    qint64 count = 0;
+    in >> magic >> version >> root >> count;
+    if (magic != SnapshotMagic || version != SnapshotVersion || root != m_folder)
+        return false;
+
+    m_snapshot.clear();
+    m_snapshot.reserve(count);
+    for (qint64 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        DirState state;
+        qint64 files = 0;
+        in >> path >> state.mtime >> state.subdirs >> files;
+        for (qint64 f = 0; f < files && in.status() == QDataStream::Ok; ++f) {
+            QString name;
+            FileState fileState;
+            in >> name >> fileState.size >> fileState.mtime;
+            state.files.insert(name, fileState);
+        }
+        m_snapshot.insert(path, state);
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+bool FolderWatcher::saveSnapshot()
+{
+    // Während des ersten Scans ist m_snapshot noch der alte Stand, der auf der Platte reicht
+    if (!m_active || m_scanning)
+        return false;
+
+    QDir().mkpath(QFileInfo(m_snapshotFile).absolutePath());
+    QSaveFile file(m_snapshotFile);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out << SnapshotMagic << SnapshotVersion << m_folder << static_cast<qint64>(m_snapshot.size());
+    for (auto it = m_snapshot.cbegin(); it != m_snapshot.cend(); ++it) {
+        const DirState &state = it.value();
+        out << it.key() << state.mtime << state.subdirs << static_cast<qint64>(state.files.size());
+        for (auto f = state.files.cbegin(); f != state.files.cend(); ++f)
+            out << f.key() << f->size << f->mtime;
+    }
+    return file.commit();
+}
@@ -0,0 +1,116 @@
+/**
+ * @file FolderWatcher.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief hot folder: reports new or changed images once they are completely written
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+/*
+ * Änderungen kommen über QFileSystemWatcher (Linux: inotify) pro Ordner, danach wird
+ * nur der betroffene Ordner neu gelistet. Neue Dateien gelten erst als fertig, wenn
+ * Größe und Änderungszeit SettleTime lang gleich bleiben (Kamera schreibt noch).
+ * Der Snapshot merkt sich je Ordner Änderungszeit, Unterordner und bereits gemeldete
+ * Dateien: beim Start werden nur Ordner mit geänderter mtime neu gelistet. In den
+ * übrigen werden nur Größe und mtime der bekannten Dateien geprüft (stat, kein Lesen),
+ * denn eine an Ort und Stelle überschriebene Datei ändert die Ordner-mtime nicht.
+ */
+class FolderWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int ScanDelay = 250;    // ms, Event-Schauer zusammenfassen
+    static constexpr int SettleCheck = 500;  // ms, Takt der Prüfung offener Dateien
+    static constexpr int SettleTime = 1500;  // ms unverändert, dann gilt die Datei als fertig
+    static constexpr int SaveDelay = 5000;   // ms, Snapshot gebündelt speichern
+
+    explicit FolderWatcher(QObject *parent = nullptr);
+    ~FolderWatcher() override;
+
+    // Snapshot-Datei je überwachtem Ordner
+    static QString snapshotLocation(const QString &folder);
+
+    // Der erste Scan läuft im Hintergrund, Dateien aus dem Snapshot werden nicht erneut gemeldet
+    bool start(const QString &folder);
+    void stop();
+    bool isActive() const;
+    QString folder() const;
+
+signals:
+    // Fertig geschriebene neue oder geänderte Bilder (absolute Pfade, sortiert)
+    void filesReady(const QStringList &files);
+    void message(const QString &text);
+
+private:
+    struct FileState
+    {
+        qint64 size = 0;
+        qint64 mtime = 0; // ms seit Epoch
+    };
+
+    struct DirState
+    {
+        qint64 mtime = 0; // 0: beim nächsten Scan neu listen
+        QStringList subdirs;
+        QHash<QString, FileState> files; // bereits gemeldet
+    };
+
+    using Snapshot = QHash<QString, DirState>; // absoluter Ordnerpfad -> Stand
+
+    struct ScanResult
+    {
+        Snapshot snapshot;
+        QStringList changed;
+        qint64 startedAt = 0; // ms seit Epoch
+    };
+
+    struct Candidate
+    {
+        FileState state;
+        qint64 stableSince = 0; // m_clock
+    };
+
+    static ScanResult scanTree(const QString &root, Snapshot previous);
+    static void scanDirectory(const QString &path, DirState &state, QStringList &changed);
+    // Ordner unverändert: nur die bekannten Dateien auf neue Größe/mtime prüfen
+    static void checkFiles(const QString &path, DirState &state, QStringList &changed);
+
+    void onScanned(const ScanResult &result);
+    void onDirectoryChanged(const QString &path);
+    void rescanDirty();
+    void removeTree(const QString &path);
+    void addCandidates(const QStringList &files);
+    void checkCandidates();
+
+    bool loadSnapshot();
+    bool saveSnapshot();
+
+    QFileSystemWatcher m_watcher;
+    QString m_folder;
+    QString m_snapshotFile;
+    Snapshot m_snapshot;
+    bool m_active = false;
+    bool m_scanning = false;
+    quint64 m_generation = 0; // verwirft Scan-Ergebnisse nach stop()
+
+    QSet<QString> m_dirty;
+    QHash<QString, Candidate> m_candidates;
+    QElapsedTimer m_clock;
+    QTimer m_scanTimer;
+    QTimer m_settleTimer;
+    QTimer m_saveTimer;
+};
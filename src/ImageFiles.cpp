@@ -0,0 +1,25 @@
+#include "ImageFiles.h"
+
+#include <QDirIterator>
+#include <QMimeDatabase>
+
+QString ImageFiles::dialogFilter()
+{
+    return "Images (" + NAME_FILTERS.join(' ') + ")";
+}
+
+QStringList ImageFiles::scanDirectory(const QString &dirName)
+{
+    QStringList fileNames;
+    QDirIterator it(dirName, NAME_FILTERS, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+        fileNames.append(it.next());
+    fileNames.sort();
+    return fileNames;
+}
+
+QString ImageFiles::mimeType(const QString &filePath)
+{
+    static const QMimeDatabase db;
+    return db.mimeTypeForFile(filePath, QMimeDatabase::MatchExtension).name();
+}
@@ -0,0 +1,30 @@
+/**
+ * @file ImageFiles.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief image file types handled by the client
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+namespace ImageFiles {
+
+// Dateitypen für Datei-Dialog und Ordner-Scan
+inline const QStringList NAME_FILTERS = {"*.png", "*.jpg", "*.jpeg", "*.bmp", "*.tiff", "*.gif"};
+
+// "Images (*.png *.jpg ...)" für QFileDialog
+QString dialogFilter();
+
+// Alle Bilder unterhalb von dirName (rekursiv), sortiert
+QStringList scanDirectory(const QString &dirName);
+
+// MIME-Type anhand der Dateiendung
+QString mimeType(const QString &filePath);
+
+} // namespace ImageFiles
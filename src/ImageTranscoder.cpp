@@ -0,0 +1,77 @@
+#include "ImageTranscoder.h"
+#include "ImageFiles.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QPainter>
+#include <QUuid>
+
+#include <algorithm>
+
+ImageTranscoder::Result ImageTranscoder::transcode(const QString &filePath,
+                                                   const Options &options,
+                                                   const QString &outputDir)
+{
+    Result result;
+
+    QImageReader reader(filePath);
+    reader.setAutoTransform(true);
+    const QByteArray inputFormat = reader.format();
+    const QSize size = reader.size(); // nur Header, noch nicht dekodiert
+    if (!size.isValid()) {
+        result.error = reader.errorString();
+        return result;
+    }
+
+    // GIFs können animiert sein, die bleiben unangetastet
+    const bool tooLarge = std::max(size.width(), size.height()) > options.maxEdge;
+    const bool uncompressed = inputFormat == "bmp" || inputFormat == "tiff";
+    if (inputFormat == "gif" || (!tooLarge && !uncompressed))
+        return result;
+
+    // Bei JPEG dekodiert libjpeg direkt in der Zielgröße, das hält den Speicher klein
+    if (tooLarge)
+        reader.setScaledSize(size.scaled(options.maxEdge, options.maxEdge, Qt::KeepAspectRatio));
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        result.error = reader.errorString();
+        return result;
+    }
+
+    const bool jpeg = options.format == "jpg" || options.format == "jpeg";
+    if (jpeg && image.hasAlphaChannel()) {
+        QImage flat(image.size(), QImage::Format_RGB32);
+        flat.fill(Qt::white);
+        QPainter painter(&flat);
+        painter.drawImage(0, 0, image);
+        painter.end();
+        image = flat;
+    }
+
+    const QString outputPath = outputDir + "/" + QUuid::createUuid().toString(QUuid::WithoutBraces)
+                               + "." + QString::fromLatin1(options.format);
+    QImageWriter writer(outputPath, options.format);
+    writer.setQuality(options.quality);
+    if (!writer.write(image)) {
+        result.error = writer.errorString();
+        QFile::remove(outputPath);
+        return result;
+    }
+
+    const qint64 outputSize = QFileInfo(outputPath).size();
+    if (outputSize >= QFileInfo(filePath).size()) {
+        QFile::remove(outputPath);
+        return result;
+    }
+
+    result.transcoded = true;
+    result.outputPath = outputPath;
+    result.fileName = QFileInfo(filePath).completeBaseName() + "." + QString::fromLatin1(options.format);
+    result.mimeType = ImageFiles::mimeType(outputPath);
+    result.size = outputSize;
+    return result;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file ImageTranscoder.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief downscale and re-encode images before upload
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+class ImageTranscoder
+{
+public:
+    struct Options
+    {
+        bool enabled = false;
+        int maxEdge = 2048;
+        int quality = 85;
+        QByteArray format = "jpg";
+    };
+
+    struct Result
+    {
+        bool transcoded = false; // false: Original hochladen
+        QString outputPath;
+        QString fileName;
+        QString mimeType;
+        qint64 size = 0;
+        QString error;
+    };
+
+    // Läuft in einem Worker-Thread. Dekodiert (wenn möglich bereits verkleinert),
+    // kodiert neu nach outputDir und liefert das Original, wenn sich nichts gewinnen lässt.
+    static Result transcode(const QString &filePath, const Options &options, const QString &outputDir);
+};
@@ -0,0 +1,335 @@
+#include "ImageValidator.h"
+
+#include <QByteArrayView>
+#include <QFile>
+#include <QList>
+#include <QSet>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstdlib>
+
+#include <zlib.h>
+
+namespace {
+using ImageValidator::Format;
+
+constexpr qint64 BlockSize = 256 * 1024;
+// Kameras hängen teils Daten hinter das EOI (Multi-Picture, Hersteller-Trailer)
+constexpr qint64 JpegTailSize = 64 * 1024;
+constexpr int MaxJpegSegments = 4096;
+constexpr int MaxTiffIfds = 64;
+constexpr qint64 MaxTiffStrips = 1 << 20;
+
+QString checkJpeg(QFile &file, qint64 size)
+{
+    // Segmente bis zum Start of Scan: jede Länge muss in der Datei liegen
+    qint64 pos = 2;
+    for (int segments = 0;; ++segments) {
+        if (segments > MaxJpegSegments)
+            return "Too many JPEG segments";
+        if (!file.seek(pos))
+            return file.errorString();
+        const QByteArray marker = file.read(4);
+        if (marker.size() < 2 || uchar(marker.at(0)) != 0xFF)
+            return QString("Invalid JPEG marker at offset %1").arg(pos);
+
+        const uchar type = uchar(marker.at(1));
+        if (type == 0xFF) {
+            ++pos; // Füllbyte
+            continue;
+        }
+        if (type == 0x01 || (type >= 0xD0 && type <= 0xD8)) {
+            pos += 2; // Marker ohne Länge
+            continue;
+        }
+        if (type == 0xD9)
+            return "JPEG ends before the image data";
+        if (marker.size() < 4)
+            return "JPEG header truncated";
+
+        const qint64 length = qFromBigEndian<quint16>(marker.constData() + 2);
+        if (length < 2 || pos + 2 + length > size) {
+            return QString("JPEG segment 0x%1 exceeds the file (truncated?)")
+                .arg(type, 2, 16, QLatin1Char('0'));
+        }
+        pos += 2 + length;
+        if (type == 0xDA)
+            break;
+    }
+
+    // In den Entropie-Daten ist 0xFF gestopft (FF 00), FF D9 kann also nur das EOI sein
+    const qint64 tail = std::min(JpegTailSize, size - pos);
+    if (tail < 2 || !file.seek(size - tail))
+        return "JPEG has no image data";
+    if (!file.read(tail).contains(QByteArrayView("\xFF\xD9", 2)))
+        return "JPEG end marker missing (truncated?)";
+    return QString();
+}
+
+QString checkPng(QFile &file, qint64 size)
+{
+    QByteArray block(BlockSize, Qt::Uninitialized);
+    qint64 pos = 8;
+    bool first = true;
+    while (pos + 12 <= size) {
+        if (!file.seek(pos))
+            return file.errorString();
+        const QByteArray header = file.read(8);
+        if (header.size() < 8)
+            return file.errorString();
+
+        const qint64 length = qFromBigEndian<quint32>(header.constData());
+        const QByteArray type = header.mid(4);
+        if (length > 0x7FFFFFFF || pos + 12 + length > size)
+            return QString("PNG chunk %1 exceeds the file (truncated?)").arg(QString::fromLatin1(type));
+        if (first && type != "IHDR")
+            return "PNG does not start with IHDR";
+        first = false;
+
+        // CRC über Typ und Daten; zlib rechnet mehrere Bytes pro Schritt (je nach Build mit SIMD)
+        uLong crc = crc32(0L, reinterpret_cast<const Bytef *>(type.constData()), 4);
+        for (qint64 left = length; left > 0;) {
+            const qint64 read = file.read(block.data(), std::min(left, BlockSize));
+            if (read <= 0)
+                return file.errorString();
+            crc = crc32(crc, reinterpret_cast<const Bytef *>(block.constData()), static_cast<uInt>(read));
+            left -= read;
+        }
+        const QByteArray stored = file.read(4);
+        if (stored.size() < 4 || qFromBigEndian<quint32>(stored.constData()) != quint32(crc))
+            return QString("PNG chunk %1 has a wrong CRC (corrupt)").arg(QString::fromLatin1(type));
+
+        pos += 12 + length;
+        if (type == "IEND")
+            return QString();
+    }
+    return "PNG end chunk (IEND) missing (truncated?)";
+}
+
+QString checkGif(QFile &file, qint64 size)
+{
+    // Kopf (6), Logical Screen Descriptor (7), Trailer (1)
+    if (size < 14)
+        return "GIF too short";
+    if (!file.seek(size - 1) || file.read(1) != ";")
+        return "GIF trailer missing (truncated?)";
+    return QString();
+}
+
+QString checkBmp(QFile &file, qint64 size)
+{
+    const QByteArray header = file.read(54);
+    if (header.size() < 26)
+        return "BMP header truncated";
+
+    const qint64 declared = qFromLittleEndian<quint32>(header.constData() + 2);
+    const qint64 pixels = qFromLittleEndian<quint32>(header.constData() + 10);
+    if (declared > size)
+        return QString("BMP truncated (%1 of %2 bytes)").arg(size).arg(declared);
+    if (pixels < 26 || pixels >= size)
+        return "BMP pixel data outside the file";
+
+    // Unkomprimiert (BI_RGB) lässt sich die Größe der Pixeldaten ausrechnen
+    if (header.size() >= 34 && qFromLittleEndian<quint32>(header.constData() + 14) >= 40) {
+        const qint64 width = std::abs(qint64(qFromLittleEndian<qint32>(header.constData() + 18)));
+        const qint64 height = std::abs(qint64(qFromLittleEndian<qint32>(header.constData() + 22)));
+        const int bitsPerPixel = qFromLittleEndian<quint16>(header.constData() + 28);
+        const quint32 compression = qFromLittleEndian<quint32>(header.constData() + 30);
+        const qint64 row = (width * bitsPerPixel + 31) / 32 * 4;
+        if (compression == 0 && row > 0 && height > (size - pixels) / row)
+            return "BMP pixel data truncated";
+    }
+    return QString();
+}
+
+// Liest IFDs direkt aus der Datei, nur so viel wie für die Grenzen nötig ist
+struct TiffCheck
+{
+    QFile &file;
+    qint64 size;
+    bool little;
+
+    quint32 u16(const char *data) const
+    {
+        return little ? qFromLittleEndian<quint16>(data) : qFromBigEndian<quint16>(data);
+    }
+
+    quint32 u32(const char *data) const
+    {
+        return little ? qFromLittleEndian<quint32>(data) : qFromBigEndian<quint32>(data);
+    }
+
+    static int typeSize(quint32 type)
+    {
+        switch (type) {
+        case 1: // BYTE
+        case 2: // ASCII
+        case 6: // SBYTE
+        case 7: // UNDEFINED
+            return 1;
+        case 3: // SHORT
+        case 8: // SSHORT
+            return 2;
+        case 4:  // LONG
+        case 9:  // SLONG
+        case 11: // FLOAT
+        case 13: // IFD
+            return 4;
+        case 5:  // RATIONAL
+        case 10: // SRATIONAL
+        case 12: // DOUBLE
+            return 8;
+        default:
+            return 0;
+        }
+    }
+
+    // SHORT/LONG-Werte eines Eintrags (Strip-Offsets bzw. -Längen)
+    QList<qint64> values(const char *entry) const
+    {
+        const quint32 type = u16(entry + 2);
+        const qint64 count = u32(entry + 4);
+        if ((type != 3 && type != 4) || count > MaxTiffStrips)
+            return {};
+
+        const int unit = type == 3 ? 2 : 4;
+        const qint64 bytes = count * unit;
+        QByteArray data;
+        if (bytes <= 4)
+            data = QByteArray(entry + 8, 4);
+        else if (file.seek(u32(entry + 8)))
+            data = file.read(bytes);
+        if (data.size() < bytes)
+            return {};
+
+        QList<qint64> result;
+        result.reserve(count);
+        for (qint64 i = 0; i < count; ++i)
+            result.append(unit == 2 ? u16(data.constData() + i * 2) : u32(data.constData() + i * 4));
+        return result;
+    }
+
+    QString run()
+    {
+        const QByteArray header = file.read(8);
+        if (header.size() < 8)
+            return "TIFF header truncated";
+        if (u16(header.constData() + 2) == 43)
+            return QString(); // BigTIFF: nur die Signatur
+
+        QSet<qint64> visited;
+        for (qint64 ifd = u32(header.constData() + 4); ifd != 0;) {
+            if (visited.contains(ifd) || visited.size() >= MaxTiffIfds)
+                return "TIFF IFD chain loops";
+            visited.insert(ifd);
+            if (ifd < 8 || ifd + 2 > size || !file.seek(ifd))
+                return QString("TIFF IFD at offset %1 outside the file").arg(ifd);
+
+            const qint64 count = u16(file.read(2).constData());
+            const qint64 length = count * 12 + 4;
+            if (ifd + 2 + length > size)
+                return "TIFF IFD exceeds the file (truncated?)";
+            const QByteArray entries = file.read(length);
+            if (entries.size() < length)
+                return file.errorString();
+
+            QList<qint64> offsets;
+            QList<qint64> byteCounts;
+            for (qint64 i = 0; i < count; ++i) {
+                const char *entry = entries.constData() + i * 12;
+                const quint32 tag = u16(entry);
+                const qint64 bytes = qint64(u32(entry + 4)) * typeSize(u16(entry + 2));
+                if (bytes > 4 && qint64(u32(entry + 8)) + bytes > size)
+                    return QString("TIFF tag %1 points outside the file (truncated?)").arg(tag);
+                if (tag == 273 || tag == 324) // StripOffsets, TileOffsets
+                    offsets = values(entry);
+                else if (tag == 279 || tag == 325) // StripByteCounts, TileByteCounts
+                    byteCounts = values(entry);
+            }
+            for (qsizetype i = 0; i < std::min(offsets.size(), byteCounts.size()); ++i) {
+                if (offsets.at(i) + byteCounts.at(i) > size)
+                    return "TIFF image data outside the file (truncated?)";
+            }
+            ifd = u32(entries.constData() + count * 12);
+        }
+        return QString();
+    }
+};
+} // namespace
+
+ImageValidator::Format ImageValidator::sniff(const QByteArray &head)
+{
+    if (head.startsWith("\xFF\xD8\xFF"))
+        return Format::Jpeg;
+    if (head.startsWith("\x89PNG\r\n\x1A\n"))
+        return Format::Png;
+    if (head.startsWith("GIF87a") || head.startsWith("GIF89a"))
+        return Format::Gif;
+    if (head.startsWith("BM") && head.size() >= 14)
+        return Format::Bmp;
+    // Klassisch (42) und BigTIFF (43), Intel- oder Motorola-Byteorder
+    if (head.startsWith(QByteArrayView("II*\0", 4)) || head.startsWith(QByteArrayView("MM\0*", 4))
+        || head.startsWith(QByteArrayView("II+\0", 4)) || head.startsWith(QByteArrayView("MM\0+", 4)))
+        return Format::Tiff;
+    return Format::Unknown;
+}
+
+QString ImageValidator::mimeType(Format format)
+{
+    switch (format) {
+    case Format::Jpeg:
+        return "image/jpeg";
+    case Format::Png:
+        return "image/png";
+    case Format::Gif:
+        return "image/gif";
+    case Format::Bmp:
+        return "image/bmp";
+    case Format::Tiff:
+        return "image/tiff";
+    case Format::Unknown:
+        break;
+    }
+    return "application/octet-stream";
+}
+
+ImageValidator::Result ImageValidator::validate(const QString &filePath)
+{
+    Result result;
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.error = file.errorString();
+        return result;
+    }
+
+    const qint64 size = file.size();
+    result.format = sniff(file.peek(16));
+    if (result.format == Format::Unknown) {
+        result.error = size == 0 ? "Empty file" : "Unknown format (no image signature)";
+        return result;
+    }
+    result.mimeType = mimeType(result.format);
+
+    switch (result.format) {
+    case Format::Jpeg:
+        result.error = checkJpeg(file, size);
+        break;
+    case Format::Png:
+        result.error = checkPng(file, size);
+        break;
+    case Format::Gif:
+        result.error = checkGif(file, size);
+        break;
+    case Format::Bmp:
+        result.error = checkBmp(file, size);
+        break;
+    case Format::Tiff:
+        result.error = TiffCheck{file, size, file.peek(1) == "I"}.run();
+        break;
+    case Format::Unknown:
+        break;
+    }
+    result.valid = result.error.isEmpty();
+    return result;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file ImageValidator.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief pre-flight check: real format from the magic bytes and a cheap structure check per format
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+namespace ImageValidator {
+
+enum class Format { Unknown, Jpeg, Png, Gif, Bmp, Tiff };
+
+struct Result
+{
+    bool valid = false; // false: nicht senden, error sagt warum
+    Format format = Format::Unknown;
+    QString mimeType; // aus den Magic Bytes, nicht aus der Endung
+    QString error;
+};
+
+// Format anhand der ersten Bytes (12 reichen für alle unterstützten)
+Format sniff(const QByteArray &head);
+QString mimeType(Format format);
+
+// Magic Bytes plus Strukturprüfung, ohne zu dekodieren:
+//   JPEG: Segmentlängen bis SOS innerhalb der Datei, EOI im letzten Stück
+//   PNG:  alle Chunks vollständig, CRC (zlib crc32) korrekt, IHDR zuerst, IEND vorhanden
+//   TIFF: IFD-Kette, Tag-Daten und Strips/Tiles innerhalb der Datei
+//   GIF:  Trailer 0x3B, BMP: angegebene Größe und Pixeldaten innerhalb der Datei
+// Nur PNG wird ganz gelesen, sonst Kopf und Ende. Thread-safe, läuft im Worker-Pool der Upload Queue.
+Result validate(const QString &filePath);
+
+} // namespace ImageValidator
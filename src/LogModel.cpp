@@ -0,0 +1,104 @@
+#include "LogModel.h"
+#include "RotatingLogFile.h"
+
+#include <QStringList>
+
+#include <algorithm>
+#include <utility>
+
+LogModel::LogModel(int capacity, QObject *parent)
+    : QAbstractListModel(parent)
+{
+    m_ring.resize(std::max(capacity, 1));
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(FlushInterval);
+    connect(&m_flushTimer, &QTimer::timeout, this, &LogModel::flush);
+}
+
+LogModel::~LogModel()
+{
+    // Was noch nicht in der Datei steht, nicht verlieren
+    writeMirror(m_pending);
+}
+
+int LogModel::capacity() const
+{
+    return m_ring.size();
+}
+
+void LogModel::setMirror(std::unique_ptr<RotatingLogFile> mirror)
+{
+    m_mirror = std::move(mirror);
+}
+
+bool LogModel::isMirrored() const
+{
+    return m_mirror != nullptr;
+}
+
+void LogModel::append(const QString &line)
+{
+    m_pending.append({QDateTime::currentDateTime(), line});
+    if (!m_flushTimer.isActive())
+        m_flushTimer.start();
+}
+
+void LogModel::flush()
+{
+    m_flushTimer.stop();
+    if (m_pending.isEmpty())
+        return;
+    QList<Entry> batch = std::exchange(m_pending, {});
+
+    writeMirror(batch);
+
+    // Mehr als in den Ring passt, wird gar nicht erst angezeigt
+    const int capacity = m_ring.size();
+    if (batch.size() > capacity)
+        batch.remove(0, batch.size() - capacity);
+
+    const int overflow = m_count + static_cast<int>(batch.size()) - capacity;
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        for (int i = 0; i < overflow; ++i) {
+            m_ring[m_head].clear();
+            m_head = (m_head + 1) % capacity;
+        }
+        m_count -= overflow;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), m_count, m_count + static_cast<int>(batch.size()) - 1);
+    for (const Entry &entry : std::as_const(batch)) {
+        m_ring[(m_head + m_count) % capacity] = entry.time.toString("HH:mm:ss") + "  " + entry.text;
+        ++m_count;
+    }
+    endInsertRows();
+    emit flushed();
+}
+
+void LogModel::writeMirror(const QList<Entry> &entries)
+{
+    if (!m_mirror || entries.isEmpty())
+        return;
+
+    QStringList lines;
+    lines.reserve(entries.size());
+    for (const Entry &entry : entries)
+        lines.append(entry.time.toString(Qt::ISODateWithMs) + " " + entry.text);
+    m_mirror->write(lines);
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_count;
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_count
+        || (role != Qt::DisplayRole && role != Qt::ToolTipRole)) {
+        return QVariant();
+    }
+    return m_ring.at((m_head + index.row()) % m_ring.size());
+}
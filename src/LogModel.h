@@ -0,0 +1,64 @@
+/**
+ * @file LogModel.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief fixed-size ring buffer of log lines, flushed to the view in timed batches
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QAbstractListModel>
+#include <QDateTime>
+#include <QList>
+#include <QString>
+#include <QTimer>
+
+#include <memory>
+
+class RotatingLogFile;
+
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DefaultCapacity = 5000;
+    static constexpr int FlushInterval = 100; // ms
+
+    explicit LogModel(int capacity = DefaultCapacity, QObject *parent = nullptr);
+    ~LogModel() override;
+
+    int capacity() const;
+    // Optional jede Zeile zusätzlich in eine rotierende Datei schreiben (nullptr = aus)
+    void setMirror(std::unique_ptr<RotatingLogFile> mirror);
+    bool isMirrored() const;
+
+    // Billig: sammelt nur, die View sieht die Zeilen spätestens nach FlushInterval
+    void append(const QString &line);
+    void flush();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+signals:
+    void flushed();
+
+private:
+    struct Entry
+    {
+        QDateTime time;
+        QString text;
+    };
+
+    void writeMirror(const QList<Entry> &entries);
+
+    QList<QString> m_ring; // feste Größe capacity, Zeile r liegt bei (m_head + r) % capacity
+    int m_head = 0;
+    int m_count = 0;
+    QList<Entry> m_pending;
+    QTimer m_flushTimer;
+    std::unique_ptr<RotatingLogFile> m_mirror;
+};
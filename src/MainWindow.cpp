@@ -1,21 +1,34 @@
 #include "MainWindow.h"
+#include "ImageFiles.h"
+#include "RotatingLogFile.h"
+
 #include <QFile>
 #include <QFileDialog>
 #include <QFormLayout>
 #include <QGroupBox>
 #include <QHBoxLayout>
-#include <QHttpMultiPart>
+#include <QHeaderView>
 #include <QInputDialog>
-#include <QJsonDocument>
-#include <QJsonObject>
 #include <QMenuBar>
 #include <QMessageBox>
+#include <QScrollBar>
 #include <QStatusBar>
 #include <QVBoxLayout>
 
+#include <algorithm>
+
 // Konfiguration (Anpassen falls Server woanders läuft)
 //const QString SERVER_URL = "http://localhost:8080";
 
+namespace {
+QString formatBytes(double bytes)
+{
+    if (bytes >= 1024.0 * 1024.0)
+        return QString::number(bytes / (1024.0 * 1024.0), 'f', 1) + " MB";
+    return QString::number(bytes / 1024.0, 'f', 1) + " KB";
+}
+} // namespace
+
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     QWidget* centralWidget = new QWidget(this);
     setCentralWidget(centralWidget);
@@ -51,11 +64,17 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     // Datei Auswahl
     QHBoxLayout* fileLayout = new QHBoxLayout();
     m_filePathEdit = new QLineEdit(this);
-    m_filePathEdit->setPlaceholderText(tr("Please choose an image file..."));
+    m_filePathEdit->setPlaceholderText(tr("Please choose image files or a folder..."));
     m_filePathEdit->setReadOnly(true);
     m_browseBtn = new QPushButton("Browse...", this);
+    m_folderBtn = new QPushButton("Folder...", this);
+    m_syncBtn = new QPushButton("Sync...", this);
+    m_syncBtn->setToolTip(tr("Upload only new or changed files of a folder (compared with the server)"));
+    m_syncBtn->setEnabled(false); // braucht Login für das Manifest
     fileLayout->addWidget(m_filePathEdit);
     fileLayout->addWidget(m_browseBtn);
+    fileLayout->addWidget(m_folderBtn);
+    fileLayout->addWidget(m_syncBtn);
 
     // Server Pfad
     QHBoxLayout* pathLayout = new QHBoxLayout();
@@ -66,7 +85,7 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     pathLayout->addWidget(pathLabel);
     pathLayout->addWidget(m_serverPathEdit);
 
-    m_uploadBtn = new QPushButton("Upload Photo", this);
+    m_uploadBtn = new QPushButton("Upload Photos", this);
     m_uploadBtn->setEnabled(false); // Erst nach Login aktiv
 
     m_progressBar = new QProgressBar(this);
@@ -76,29 +95,111 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     // Optional: Standardmäßig ausblenden oder auf 0 lassen
     // m_progressBar->setVisible(false);
 
+    // Warteschlange: eine Zeile pro Datei
+    m_queueView = new QTreeWidget(this);
+    m_queueView->setColumnCount(3);
+    m_queueView->setHeaderLabels({tr("File"), tr("Status"), tr("Progress")});
+    m_queueView->setRootIsDecorated(false);
+    m_queueView->setUniformRowHeights(true);
+    m_queueView->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    // Thumbnail-Raster: Bilder werden erst beim Zeichnen angefragt und im Hintergrund dekodiert
+    m_thumbnails = new ThumbnailCache(this);
+    m_thumbnails->setMemoryLimit(QSettings().value("ThumbnailCacheMB", 64).toLongLong() * 1024 * 1024);
+    if (QSettings().value("ThumbnailDiskCache", true).toBool())
+        m_thumbnails->setDiskCache(ThumbnailCache::defaultDiskCache());
+    m_thumbModel = new ThumbnailModel(m_thumbnails, this);
+    const int edge = m_thumbnails->edge();
+    m_thumbView = new QListView(this);
+    m_thumbView->setModel(m_thumbModel);
+    m_thumbView->setViewMode(QListView::IconMode);
+    m_thumbView->setIconSize(QSize(edge, edge));
+    m_thumbView->setGridSize(QSize(edge + 24, edge + 32));
+    m_thumbView->setUniformItemSizes(true);
+    m_thumbView->setLayoutMode(QListView::Batched);
+    m_thumbView->setResizeMode(QListView::Adjust);
+    m_thumbView->setMovement(QListView::Static);
+    m_thumbView->setTextElideMode(Qt::ElideMiddle);
+    m_thumbView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    m_viewTabs = new QTabWidget(this);
+    m_viewTabs->addTab(m_queueView, tr("Queue"));
+    m_viewTabs->addTab(m_thumbView, tr("Thumbnails"));
+
     uploadLayout->addLayout(fileLayout);
     uploadLayout->addLayout(pathLayout);
     uploadLayout->addWidget(m_uploadBtn);
+    uploadLayout->addWidget(m_viewTabs);
     uploadLayout->addWidget(m_progressBar);
 
     mainLayout->addWidget(uploadGroup);
 
     // --- 3. Log Bereich ---
-    m_logArea = new QTextEdit(this);
-    m_logArea->setReadOnly(true);
-    mainLayout->addWidget(m_logArea);
+    m_logModel = new LogModel(QSettings().value("LogLines", LogModel::DefaultCapacity).toInt(), this);
+    m_logView = new QListView(this);
+    m_logView->setModel(m_logModel);
+    m_logView->setUniformItemSizes(true);
+    m_logView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_logView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    mainLayout->addWidget(m_logView);
+
+    QScrollBar *logScroll = m_logView->verticalScrollBar();
+    connect(logScroll, &QScrollBar::valueChanged, this, [this, logScroll](int value) {
+        m_logFollow = value == logScroll->maximum();
+    });
+    connect(m_logModel, &LogModel::flushed, this, [this]() {
+        if (m_logFollow)
+            m_logView->scrollToBottom();
+    });
+
+    m_progressTimer.setSingleShot(true);
+    m_progressTimer.setInterval(1000 / MaxProgressFps);
+    connect(&m_progressTimer, &QTimer::timeout, this, &MainWindow::flushProgress);
 
     // --- Networking Init ---
-    m_netManager = new QNetworkAccessManager(this);
-    
+    m_engine = new UploadEngine(this);
+    m_uploadQueue = m_engine->queue();
+
     // --- Signals & Slots ---
     connect(m_loginBtn, &QPushButton::clicked, this, &MainWindow::onLoginClicked);
     connect(m_logoutBtn, &QPushButton::clicked, this, &MainWindow::onLogoutClicked);
     connect(m_browseBtn, &QPushButton::clicked, this, &MainWindow::onBrowseClicked);
+    connect(m_folderBtn, &QPushButton::clicked, this, &MainWindow::onFolderClicked);
+    connect(m_syncBtn, &QPushButton::clicked, this, &MainWindow::onSyncClicked);
     connect(m_uploadBtn, &QPushButton::clicked, this, &MainWindow::onUploadClicked);
-    
-    // Zentraler Handler für alle Antworten
-    connect(m_netManager, &QNetworkAccessManager::finished, this, &MainWindow::onNetworkFinished);
+
+    connect(m_uploadQueue, &UploadQueue::itemAdded, this, &MainWindow::onQueueItemAdded);
+    connect(m_uploadQueue, &UploadQueue::itemStarted, this, &MainWindow::onQueueItemStarted);
+    connect(m_uploadQueue, &UploadQueue::itemProgress, this, &MainWindow::onQueueItemProgress);
+    connect(m_uploadQueue, &UploadQueue::itemFinished, this, &MainWindow::onQueueItemFinished);
+    connect(m_uploadQueue, &UploadQueue::itemSkipped, this, &MainWindow::onQueueItemSkipped);
+    connect(m_uploadQueue, &UploadQueue::itemRetrying, this, [this](int index, int retry, int delayMs) {
+        if (QTreeWidgetItem *row = m_queueView->topLevelItem(index))
+            row->setText(1, tr("retry %1 in %2 s").arg(retry).arg(delayMs / 1000.0, 0, 'f', 1));
+    });
+    connect(m_uploadQueue, &UploadQueue::progress, this, &MainWindow::onUploadProgress);
+    connect(m_uploadQueue, &UploadQueue::finished, this, &MainWindow::onQueueFinished);
+
+    connect(m_engine, &UploadEngine::message, this, &MainWindow::log);
+    connect(m_engine, &UploadEngine::loggedIn, this, &MainWindow::onLoggedIn);
+    connect(m_engine, &UploadEngine::loginFailed, this, [this]() { resetProgress(); });
+    connect(m_engine, &UploadEngine::loggedOut, this, &MainWindow::resetUI);
+    connect(m_engine, &UploadEngine::sessionExpired, this, &MainWindow::onSessionExpired);
+    connect(m_engine, &UploadEngine::serverChanged, this, [this](const QString &name) {
+        // Nach Failover bzw. Wahl des schnellsten Knotens sichtbar, welcher gerade benutzt wird
+        setWindowTitle(QString("Crow Server Client - %1").arg(name));
+    });
+    connect(m_engine, &UploadEngine::syncFinished, this, [this](int queued, int, const QString &error) {
+        m_syncBtn->setEnabled(m_engine->isLoggedIn());
+        if (error.isEmpty() && queued > 0) {
+            resetProgress();
+            m_engine->start();
+        }
+    });
+
+    m_folderWatcher = new FolderWatcher(this);
+    connect(m_folderWatcher, &FolderWatcher::filesReady, this, &MainWindow::onWatchedFilesReady);
+    connect(m_folderWatcher, &FolderWatcher::message, this, &MainWindow::log);
 
     setWindowTitle("Crow Server Client");
 
@@ -112,92 +213,188 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     statusBar()->addWidget(m_statusMiddle, 1);
     connect(m_statusMiddle, SIGNAL(clicked(bool)), this, SLOT(openGithub()));
 
-    resize(400, 500);
+    // Live-Telemetrie: TTFB ist Serverzeit, queued/connect/send liegen beim Client
+    m_telemetryLabel = new QLabel(this);
+    m_telemetryLabel->setStyleSheet("font-size: 10px;");
+    m_telemetryLabel->setToolTip(tr("Average time to first byte (server) and TLS connect (client)"));
+    statusBar()->addWidget(m_telemetryLabel);
+    m_telemetryTimer.setInterval(1000);
+    connect(&m_telemetryTimer, &QTimer::timeout, this, [this]() {
+        m_telemetryLabel->setText(m_engine->telemetry()->summary());
+    });
+    m_telemetryTimer.start();
+
+    m_statusLabel = new QLabel(this);
+    m_statusLabel->setStyleSheet("font-size: 10px;");
+    statusBar()->addPermanentWidget(m_statusLabel);
+
+    resize(500, 650);
 
     settings = new QSettings;
-    SERVER_URL = settings->contains("Server") ? settings->value("Server").toString() : SERVER_URL;
+    // Früher eine einzelne URL unter "Server"
+    if (settings->contains("Servers"))
+        SERVER_PROFILES = settings->value("Servers").toStringList();
+    else if (settings->contains("Server"))
+        SERVER_PROFILES = {settings->value("Server").toString()};
+    applyServerSettings();
+    m_uploadQueue->setConcurrency(settings->value("Concurrency", 4).toInt());
+    m_uploadQueue->setAdaptiveConcurrency(settings->value("AdaptiveConcurrency", false).toBool());
+    m_uploadQueue->setChunkSize(settings->value("ChunkSize", 0).toLongLong() * 1024 * 1024);
+    m_uploadQueue->setCompression(settings->value("Compress", false).toBool());
+    m_uploadQueue->setSendMetadata(settings->value("SendMetadata", false).toBool());
+    m_uploadQueue->setStripMetadata(settings->value("StripMetadata", false).toBool());
+    m_uploadQueue->setValidation(settings->value("ValidateFiles", true).toBool());
+    m_uploadQueue->setBatching(settings->value("BatchUploads", false).toBool()
+                                   ? UploadQueue::DefaultBatchFiles
+                                   : 1);
+    m_engine->telemetry()->setExportFile(settings->value("MetricsFile").toString());
+    m_uploadQueue->setRateLimits(settings->value("RateLimit", 0).toLongLong() * 1024,
+                                 settings->value("RateLimitPerTransfer", 0).toLongLong() * 1024);
 
     createMenu();
+    applyDedupSettings();
+    applyTranscodeSettings();
+    applyLogSettings();
+
+    // Nach einem Absturz: offene Uploads wieder einreihen, gestartet wird nach dem Login
+    const int restored = m_engine->restoreJournal();
+    if (restored > 0) {
+        log(tr("%1 unfinished upload(s) restored, they continue after login").arg(restored));
+        m_resumeAfterLogin = true;
+    }
+    applyWatchSettings();
 }
 
 MainWindow::~MainWindow() {}
 
 void MainWindow::log(const QString& msg) {
-    m_logArea->append(msg);
+    m_logModel->append(msg);
+}
+
+void MainWindow::scheduleProgress()
+{
+    if (!m_progressTimer.isActive())
+        m_progressTimer.start();
 }
 
-void MainWindow::retryLastUpload()
+void MainWindow::flushProgress()
 {
-    log("Retrying upload with new token...");
+    m_progressTimer.stop();
 
-    // Sicherheitscheck: Ist überhaupt noch ein Pfad ausgewählt?
-    if (m_filePathEdit->text().isEmpty()) {
-        log("Retry failed: No file selected anymore.");
+    for (auto it = m_itemPercent.cbegin(); it != m_itemPercent.cend(); ++it) {
+        if (QTreeWidgetItem *row = m_queueView->topLevelItem(it.key()))
+            row->setText(2, QString::number(it.value()) + "%");
+    }
+    m_itemPercent.clear();
+
+    if (!m_progressDirty)
+        return;
+    m_progressDirty = false;
+    // bytesTotal kann 0 sein, wenn alle Dateien fehlgeschlagen sind
+    if (m_progressTotal > 0)
+        m_progressBar->setValue(static_cast<int>((m_progressSent * 100) / m_progressTotal));
+    QString status = formatBytes(m_progressRate) + "/s";
+    if (m_uploadQueue->adaptiveConcurrency())
+        status += tr(", %1 parallel").arg(m_uploadQueue->currentConcurrency());
+    m_statusLabel->setText(status);
+}
+
+void MainWindow::resetProgress()
+{
+    // Noch ausstehende Werte dürfen den Reset nicht überschreiben
+    m_progressTimer.stop();
+    m_progressDirty = false;
+    m_itemPercent.clear();
+    m_progressBar->setValue(0);
+}
+
+void MainWindow::setSelection(const QStringList &files, const QString &root)
+{
+    m_selectedFiles = files;
+    m_selectionRoot = root;
+
+    if (files.isEmpty())
+        m_filePathEdit->clear();
+    else if (files.size() == 1)
+        m_filePathEdit->setText(files.first());
+    else
+        m_filePathEdit->setText(tr("%1 files selected").arg(files.size()));
+    updateThumbnails();
+}
+
+void MainWindow::updateThumbnails()
+{
+    if (!m_selectedFiles.isEmpty()) {
+        m_thumbModel->setFiles(m_selectedFiles);
         return;
     }
 
-    // Wir rufen einfach die existierende Upload-Logik erneut auf.
-    // Diese baut den MultiPart-Request neu zusammen (inkl. neuem Token)
-    // und sendet ihn ab.
-    onUploadClicked();
+    QStringList files;
+    files.reserve(m_uploadQueue->count());
+    for (int i = 0; i < m_uploadQueue->count(); ++i)
+        files.append(m_uploadQueue->item(i).filePath);
+    m_thumbModel->setFiles(files);
 }
 
 void MainWindow::resetUI()
 {
-    // 1. Tokens löschen
-    m_jwtToken.clear();
-    m_refreshToken.clear();
-
-    // 2. GUI Elemente zurücksetzen
+    // Tokens hat die Engine bereits verworfen, hier nur die GUI zurücksetzen
     m_uploadBtn->setEnabled(false);
+    m_syncBtn->setEnabled(false);
     m_logoutBtn->setEnabled(false);
     m_loginBtn->setEnabled(true); // Login wieder erlauben
     m_userEdit->setEnabled(true);
     m_passEdit->setEnabled(true);
-    m_progressBar->setValue(0);
-
-    log("Logged out locally.");
+    resetProgress();
 }
 
 // --- Logik: Login ---
 void MainWindow::onLoginClicked() {
-    QUrl url(SERVER_URL + "/login");
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-
-    // JSON Body bauen
-    QJsonObject json;
-    json["username"] = m_userEdit->text();
-    json["password"] = m_passEdit->text();
-    QJsonDocument doc(json);
-
-    log("Logging in...");
-    m_netManager->post(request, doc.toJson());
+    m_engine->login(m_userEdit->text(), m_passEdit->text());
 }
 
 void MainWindow::onLogoutClicked()
 {
-    // Wenn wir gar nicht eingeloggt sind, nichts tun
-    if (m_refreshToken.isEmpty()) {
-        resetUI();
-        return;
-    }
+    m_engine->logout();
+}
 
-    log("Logging out...");
+void MainWindow::onLoggedIn()
+{
+    m_uploadBtn->setEnabled(true);
+    m_syncBtn->setEnabled(true);
+    m_logoutBtn->setEnabled(true);
+    m_loginBtn->setEnabled(false);
+    m_userEdit->setEnabled(false);
+    m_passEdit->setEnabled(false);
+
+    if (m_resumeAfterLogin) {
+        m_resumeAfterLogin = false;
+        m_engine->start();
+    }
+}
 
-    // Request an Server senden, um Refresh Token zu invalidieren
-    QUrl url(SERVER_URL + "/logout");
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+void MainWindow::onSessionExpired()
+{
+    m_uploadBtn->setEnabled(false);
+    m_syncBtn->setEnabled(false);
+    resetProgress();
+}
 
-    QJsonObject json;
-    json["refreshToken"] = m_refreshToken;
+void MainWindow::onSyncClicked()
+{
+    QString imagePath = settings->contains("imagePath") ? settings->value("imagePath").toString()
+                                                        : QDir::homePath();
 
-    m_netManager->post(request, QJsonDocument(json).toJson());
+    QString dirName = QFileDialog::getExistingDirectory(this, tr("choose Folder to sync"), imagePath);
+    if (dirName.isEmpty())
+        return;
+    settings->setValue("imagePath", dirName);
 
-    // WICHTIG: Wir resetten die UI sofort, egal was der Server sagt.
-    // Der Server-Call ist "Fire and Forget" aus User-Sicht.
-    resetUI();
+    // Ziel ist der Server-Pfad aus dem Eingabefeld, die Unterordner bleiben erhalten
+    if (m_engine->sync(dirName, m_serverPathEdit->text())) {
+        m_syncBtn->setEnabled(false);
+        log(tr("Comparing %1 with the server...").arg(dirName));
+    }
 }
 
 // --- Logik: Datei wählen ---
@@ -205,192 +402,140 @@ void MainWindow::onBrowseClicked() {
     QString imagePath = settings->contains("imagePath") ? settings->value("imagePath").toString()
                                                         : QDir::homePath();
 
-    QString fileName
-        = QFileDialog::getOpenFileName(this,
-                                       tr("choose Image"),
-                                       imagePath,
-                                       "Images (*.png *.jpg *.jpeg *.bmp *.tiff *.gif)");
-    if (!fileName.isEmpty()) {
-        m_filePathEdit->setText(fileName);
+    QStringList fileNames
+        = QFileDialog::getOpenFileNames(this,
+                                        tr("choose Images"),
+                                        imagePath,
+                                        ImageFiles::dialogFilter());
+    if (!fileNames.isEmpty()) {
+        setSelection(fileNames, QString());
 
-        QFileInfo fileInfo(fileName);
+        QFileInfo fileInfo(fileNames.first());
         m_serverPathEdit->setText(fileInfo.absolutePath());
         settings->setValue("imagePath", fileInfo.absolutePath());
     }
-    m_progressBar->setValue(0);
+    resetProgress();
+}
+
+void MainWindow::onFolderClicked()
+{
+    QString imagePath = settings->contains("imagePath") ? settings->value("imagePath").toString()
+                                                        : QDir::homePath();
+
+    QString dirName = QFileDialog::getExistingDirectory(this, tr("choose Folder"), imagePath);
+    if (dirName.isEmpty())
+        return;
+
+    const QStringList fileNames = ImageFiles::scanDirectory(dirName);
+    if (fileNames.isEmpty()) {
+        log("No images found in " + dirName);
+        return;
+    }
+
+    setSelection(fileNames, dirName);
+    m_serverPathEdit->setText(dirName);
+    settings->setValue("imagePath", dirName);
+    resetProgress();
 }
 
 // --- Logik: Upload ---
 void MainWindow::onUploadClicked() {
-    QString filePath = m_filePathEdit->text();
-    if (filePath.isEmpty()) {
+    if (m_selectedFiles.isEmpty()) {
         QMessageBox::warning(this, "Fehler", "Keine Datei ausgewählt.");
         return;
     }
 
-    QFile* file = new QFile(filePath);
-    if (!file->open(QIODevice::ReadOnly)) {
-        log("Error: Could not open file locally.");
-        delete file;
-        return;
-    }
+    // Einzelne Datei: interaktiv, überholt laufende Ordner-/Mehrfach-Uploads
+    const UploadQueue::Priority priority = m_selectedFiles.size() == 1 && m_selectionRoot.isEmpty()
+                                               ? UploadQueue::Priority::Interactive
+                                               : UploadQueue::Priority::Background;
 
-    QUrl url(SERVER_URL + "/upload");
-    QNetworkRequest request(url);
-    
-    // WICHTIG: Token setzen
-    QString bearer = "Bearer " + m_jwtToken;
-    request.setRawHeader("Authorization", bearer.toUtf8());
-
-    // --- Multipart Zusammenbau ---
-    QHttpMultiPart* multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
-
-    // 1. Part: Das Bild
-    QHttpPart imagePart;
-    // Header für Dateiname und Feldname "photo"
-    QString fileName = QFileInfo(filePath).fileName();
-    imagePart.setHeader(QNetworkRequest::ContentDispositionHeader, 
-                        QVariant("form-data; name=\"photo\"; filename=\"" + fileName + "\""));
-    // Content-Type raten (einfachheitshalber image/jpeg, oder basierend auf Extension)
-    imagePart.setHeader(QNetworkRequest::ContentTypeHeader, QVariant("image/jpeg"));
-    imagePart.setBodyDevice(file);
-    // Das File wird nun Kind vom MultiPart -> wird automatisch gelöscht
-    file->setParent(multiPart); 
-    multiPart->append(imagePart);
-
-    // 2. Part: Der Zielpfad (falls angegeben)
-    if (!m_serverPathEdit->text().isEmpty()) {
-        QHttpPart pathPart;
-        pathPart.setHeader(QNetworkRequest::ContentDispositionHeader, QVariant("form-data; name=\"path\""));
-        pathPart.setBody(m_serverPathEdit->text().toUtf8());
-        multiPart->append(pathPart);
-    }
+    // Bei Ordnerauswahl bleibt die Unterordner-Struktur auf dem Server erhalten
+    m_engine->enqueue(m_selectedFiles, m_selectionRoot, m_serverPathEdit->text(), priority);
 
-    log("Uploading file...");
-    // ProgressBar zurücksetzen
-    m_progressBar->setValue(0);
+    log(QString("Uploading %1 file(s) with %2 parallel transfers...")
+            .arg(m_selectedFiles.size())
+            .arg(m_uploadQueue->concurrency()));
+    setSelection(QStringList(), QString());
+    resetProgress();
 
-    QNetworkReply *reply = m_netManager->post(request, multiPart);
+    m_engine->start();
+}
 
-    // MultiPart muss gelöscht werden, wenn der Reply fertig ist
-    multiPart->setParent(reply);
+void MainWindow::onUploadProgress(qint64 bytesSent, qint64 bytesTotal, double bytesPerSecond)
+{
+    m_progressSent = bytesSent;
+    m_progressTotal = bytesTotal;
+    m_progressRate = bytesPerSecond;
+    m_progressDirty = true;
+    scheduleProgress();
+}
 
-    // bei refresh token ist der input weg
-    //m_filePathEdit->clear();
-    //m_serverPathEdit->clear();
+void MainWindow::onQueueItemAdded(int index)
+{
+    const UploadQueue::Item &item = m_uploadQueue->item(index);
+    QTreeWidgetItem *row = new QTreeWidgetItem(m_queueView);
+    row->setText(0, QFileInfo(item.filePath).fileName());
+    row->setToolTip(0, item.filePath);
+    row->setText(1, tr("queued"));
+    row->setText(2, "0%");
+
+    if (m_selectedFiles.isEmpty())
+        m_thumbModel->append(item.filePath);
+}
 
-    connect(reply, &QNetworkReply::uploadProgress, this, &MainWindow::onUploadProgress);
+void MainWindow::onQueueItemStarted(int index)
+{
+    if (QTreeWidgetItem *row = m_queueView->topLevelItem(index))
+        row->setText(1, tr("uploading"));
 }
 
-// --- Netzwerk Antwort Handler ---
-void MainWindow::onNetworkFinished(QNetworkReply *reply)
+void MainWindow::onQueueItemProgress(int index, qint64 bytesSent, qint64 bytesTotal)
 {
-    // 1. Meta-Daten holen (URL und HTTP Status Code)
-    QString path = reply->request().url().path();
-    int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-
-    // ------------------------------------------------------------------
-    // FALL 1: Token abgelaufen (401) bei normalen Aktionen (z.B. Upload)
-    // ------------------------------------------------------------------
-    if (statusCode == 401 && path != "/login" && path != "/refresh") {
-        reply->deleteLater(); // Antwort verwerfen
-
-        if (!m_refreshToken.isEmpty()) {
-            log("Access Token expired (401). Trying Refresh...");
-            performTokenRefresh();
-        } else {
-            log("Session expired. Please login again.");
-            m_uploadBtn->setEnabled(false);
-            m_progressBar->setValue(0);
-        }
-        return; // Wir brechen hier ab, wir lesen keine Daten
+    if (bytesTotal > 0) {
+        m_itemPercent.insert(index, static_cast<int>((bytesSent * 100) / bytesTotal));
+        scheduleProgress();
     }
+}
 
-    // ------------------------------------------------------------------
-    // Alle anderen Fälle: Wir lesen die Antwortdaten
-    // ------------------------------------------------------------------
-    QByteArray responseData = reply->readAll(); // <--- HIER wird responseData definiert
-    reply->deleteLater();
-
-    // ------------------------------------------------------------------
-    // FALL 2: Refresh Token Antwort (/refresh)
-    // ------------------------------------------------------------------
-    if (path == "/refresh") {
-        m_isRefreshing = false; // Flag zurücksetzen
-
-        if (statusCode == 200) {
-            QJsonDocument doc = QJsonDocument::fromJson(responseData);
-            if (doc.isObject() && doc.object().contains("token")) {
-                m_jwtToken = doc.object()["token"].toString();
-                log("Token refreshed successfully. Retrying last action...");
-
-                // Aktion wiederholen (Hier hardcoded auf Upload,
-                // in komplexen Apps würde man das Request-Objekt speichern)
-                //onUploadClicked();
-                retryLastUpload();
-            }
-        } else {
-            log("Refresh failed (Session invalid). Please login again.");
-            m_jwtToken.clear();
-            m_refreshToken.clear();
-            m_uploadBtn->setEnabled(false);
-        }
+void MainWindow::onQueueItemFinished(int index, bool ok, const QString &message)
+{
+    m_itemPercent.remove(index);
+    QTreeWidgetItem *row = m_queueView->topLevelItem(index);
+    if (!row)
         return;
-    }
 
-    // ------------------------------------------------------------------
-    // FALL 3: Allgemeine Netzwerkfehler (außer 401, das haben wir oben behandelt)
-    // ------------------------------------------------------------------
-    if (reply->error() != QNetworkReply::NoError) {
-        m_progressBar->setValue(0);
-        log("Network Error: " + reply->errorString());
-        log("Server Message: " + responseData); // Hier nutzen wir responseData
-        return;
+    if (ok) {
+        row->setText(1, tr("done"));
+        row->setText(2, "100%");
+    } else {
+        row->setText(1, tr("failed"));
+        row->setToolTip(1, message);
+        log("Upload failed: " + m_uploadQueue->item(index).filePath + " - " + message);
     }
+}
 
-    // ------------------------------------------------------------------
-    // FALL 4: Normale Erfolgsfälle (/login, /upload)
-    // ------------------------------------------------------------------
-    if (path == "/login") {
-        QJsonDocument doc = QJsonDocument::fromJson(responseData);
-        if (doc.isObject()) {
-            QJsonObject obj = doc.object();
-            if (obj.contains("token") && obj.contains("refreshToken")) {
-                m_jwtToken = obj["token"].toString();
-                m_refreshToken = obj["refreshToken"].toString();
-
-                log("Login Success! Tokens received.");
-                m_uploadBtn->setEnabled(true);
-                m_logoutBtn->setEnabled(true);
-                m_loginBtn->setEnabled(false);
-                m_userEdit->setEnabled(false);
-                m_passEdit->setEnabled(false);
-                // Status Label update etc.
-            } else {
-                log("Login failed: Invalid JSON response.");
-            }
-        }
-    } else if (path == "/upload") {
-        m_progressBar->setValue(100);
-        log("Upload finished successfully!");
-        // Optional: responseData anzeigen
-        // log("Server: " + responseData);
-    } else if (path == "/logout") {
-        log("Server confirmed logout.");
+void MainWindow::onQueueItemSkipped(int index)
+{
+    m_itemPercent.remove(index);
+    if (QTreeWidgetItem *row = m_queueView->topLevelItem(index)) {
+        row->setText(1, tr("skipped"));
+        row->setToolTip(1, tr("already uploaded to this folder"));
     }
 }
 
-void MainWindow::onUploadProgress(qint64 bytesSent, qint64 bytesTotal)
+void MainWindow::onQueueFinished(int succeeded, int skipped, int failed, qint64 bytes, qint64 elapsedMs)
 {
-    // bytesTotal kann -1 sein, wenn die Größe unbekannt ist
-    if (bytesTotal > 0) {
-        int percent = static_cast<int>((bytesSent * 100) / bytesTotal);
-        m_progressBar->setValue(percent);
-
-        // Optional: Log update nur alle 10% um Spam zu vermeiden,
-        // oder einfach Statusbar updaten
-        // m_statusLabel->setText(QString("Upload: %1%").arg(percent));
-    }
+    const double seconds = elapsedMs / 1000.0;
+    log(QString("Upload finished: %1 ok, %2 skipped, %3 failed, %4 in %5 s (%6/s)")
+            .arg(succeeded)
+            .arg(skipped)
+            .arg(failed)
+            .arg(formatBytes(bytes))
+            .arg(seconds, 0, 'f', 1)
+            .arg(formatBytes(seconds > 0 ? bytes / seconds : 0)));
+    flushProgress();
+    m_statusLabel->clear();
 }
 
 void MainWindow::openGithub()
@@ -414,24 +559,338 @@ void MainWindow::createMenu()
                             this);
     connect(configAct, &QAction::triggered, this, &MainWindow::appConfig);
 
+    dedupAct = new QAction(tr("&Skip already uploaded files"), this);
+    dedupAct->setCheckable(true);
+    dedupAct->setChecked(settings->value("Dedup", true).toBool());
+    connect(dedupAct, &QAction::toggled, this, [this](bool checked) {
+        settings->setValue("Dedup", checked);
+        applyDedupSettings();
+    });
+
+    askServerAct = new QAction(tr("Ask server for &known files"), this);
+    askServerAct->setCheckable(true);
+    askServerAct->setChecked(settings->value("DedupAskServer", false).toBool());
+    connect(askServerAct, &QAction::toggled, this, [this](bool checked) {
+        settings->setValue("DedupAskServer", checked);
+        applyDedupSettings();
+    });
+
+    transcodeAct = new QAction(tr("&Downscale images before upload"), this);
+    transcodeAct->setCheckable(true);
+    transcodeAct->setChecked(settings->value("Transcode", false).toBool());
+    connect(transcodeAct, &QAction::toggled, this, [this](bool checked) {
+        settings->setValue("Transcode", checked);
+        applyTranscodeSettings();
+    });
+
+    compressAct = new QAction(tr("&Compress uncompressed images (BMP/TIFF)"), this);
+    compressAct->setCheckable(true);
+    compressAct->setChecked(settings->value("Compress", false).toBool());
+    connect(compressAct, &QAction::toggled, this, [this](bool checked) {
+        settings->setValue("Compress", checked);
+        m_uploadQueue->setCompression(checked);
+    });
+
+    metadataAct = new QAction(tr("Send capture &metadata (EXIF/XMP) separately"), this);
+    metadataAct->setCheckable(true);
+    metadataAct->setChecked(m_uploadQueue->sendMetadata());
+    connect(metadataAct, &QAction::toggled, this, [this](bool checked) {
+        settings->setValue("SendMetadata", checked);
+        m_uploadQueue->setSendMetadata(checked);
+    });
+
+    // Falsche Endungen korrigieren und abgeschnittene/kaputte Dateien gar nicht erst senden
+    validateAct = new QAction(tr("&Validate files before upload"), this);
+    validateAct->setCheckable(true);
+    validateAct->setChecked(m_uploadQueue->validation());
+    connect(validateAct, &QAction::toggled, this, [this](bool checked) {
+        settings->setValue("ValidateFiles", checked);
+        m_uploadQueue->setValidation(checked);
+    });
+
+    stripMetadataAct = new QAction(tr("&Remove metadata from uploaded JPEGs"), this);
+    stripMetadataAct->setCheckable(true);
+    stripMetadataAct->setChecked(m_uploadQueue->stripMetadata());
+    connect(stripMetadataAct, &QAction::toggled, this, [this](bool checked) {
+        settings->setValue("StripMetadata", checked);
+        m_uploadQueue->setStripMetadata(checked);
+    });
+
+    batchAct = new QAction(tr("&Batch small files into one request"), this);
+    batchAct->setCheckable(true);
+    batchAct->setChecked(m_uploadQueue->batchFiles() > 1);
+    connect(batchAct, &QAction::toggled, this, [this](bool checked) {
+        settings->setValue("BatchUploads", checked);
+        m_uploadQueue->setBatching(checked ? UploadQueue::DefaultBatchFiles : 1);
+    });
+
+    adaptiveAct = new QAction(tr("&Adapt parallel uploads to the connection"), this);
+    adaptiveAct->setCheckable(true);
+    adaptiveAct->setChecked(m_uploadQueue->adaptiveConcurrency());
+    connect(adaptiveAct, &QAction::toggled, this, [this](bool checked) {
+        settings->setValue("AdaptiveConcurrency", checked);
+        m_uploadQueue->setAdaptiveConcurrency(checked);
+    });
+
+    logFileAct = new QAction(tr("Write &log file"), this);
+    logFileAct->setCheckable(true);
+    logFileAct->setChecked(settings->value("LogFile", false).toBool());
+    logFileAct->setToolTip(RotatingLogFile::defaultLocation());
+    connect(logFileAct, &QAction::toggled, this, [this](bool checked) {
+        settings->setValue("LogFile", checked);
+        applyLogSettings();
+    });
+
+    watchAct = new QAction(tr("&Watch folder (auto upload)..."), this);
+    watchAct->setCheckable(true);
+    watchAct->setChecked(settings->value("WatchEnabled", false).toBool());
+    watchAct->setToolTip(settings->value("WatchFolder").toString());
+    connect(watchAct, &QAction::triggered, this, [this](bool checked) {
+        if (checked) {
+            const QString imagePath = settings->value("imagePath", QDir::homePath()).toString();
+            const QString dirName
+                = QFileDialog::getExistingDirectory(this,
+                                                    tr("choose Watch Folder"),
+                                                    settings->value("WatchFolder", imagePath).toString());
+            if (dirName.isEmpty()) {
+                watchAct->setChecked(false);
+                return;
+            }
+            settings->setValue("WatchFolder", dirName);
+            watchAct->setToolTip(dirName);
+        }
+        settings->setValue("WatchEnabled", checked);
+        applyWatchSettings();
+    });
+
     appMenu = menuBar()->addMenu(tr("&System"));
     appMenu->addAction(aboutAct);
     appMenu->addAction(configAct);
+    appMenu->addSeparator();
+    appMenu->addAction(dedupAct);
+    appMenu->addAction(askServerAct);
+    appMenu->addAction(transcodeAct);
+    appMenu->addAction(compressAct);
+    appMenu->addAction(metadataAct);
+    appMenu->addAction(stripMetadataAct);
+    appMenu->addAction(validateAct);
+    appMenu->addAction(batchAct);
+    appMenu->addAction(adaptiveAct);
+    appMenu->addAction(logFileAct);
+    appMenu->addSeparator();
+    appMenu->addAction(watchAct);
+}
+
+void MainWindow::applyDedupSettings()
+{
+    m_engine->setDedup(dedupAct->isChecked(), askServerAct->isChecked());
+    askServerAct->setEnabled(dedupAct->isChecked());
+}
+
+void MainWindow::applyTranscodeSettings()
+{
+    ImageTranscoder::Options options;
+    options.enabled = transcodeAct->isChecked();
+    options.maxEdge = settings->value("TranscodeMaxEdge", options.maxEdge).toInt();
+    options.quality = settings->value("TranscodeQuality", options.quality).toInt();
+    options.format = settings->value("TranscodeFormat", QString::fromLatin1(options.format))
+                         .toString()
+                         .toLatin1();
+    m_uploadQueue->setTranscodeOptions(options);
+}
+
+void MainWindow::applyLogSettings()
+{
+    if (logFileAct->isChecked() == m_logModel->isMirrored())
+        return;
+
+    m_logModel->flush();
+    if (logFileAct->isChecked()) {
+        m_logModel->setMirror(std::make_unique<RotatingLogFile>(RotatingLogFile::defaultLocation()));
+        log("Writing log file " + RotatingLogFile::defaultLocation());
+    } else {
+        m_logModel->setMirror(nullptr);
+    }
+}
+
+void MainWindow::applyWatchSettings()
+{
+    const QString dirName = settings->value("WatchFolder").toString();
+    if (!watchAct->isChecked() || dirName.isEmpty()) {
+        if (m_folderWatcher->isActive())
+            log("Stopped watching " + m_folderWatcher->folder());
+        m_folderWatcher->stop();
+        return;
+    }
+    if (m_folderWatcher->isActive() && m_folderWatcher->folder() == QFileInfo(dirName).absoluteFilePath())
+        return;
+    if (!m_folderWatcher->start(dirName)) {
+        log("Cannot watch " + dirName);
+        watchAct->setChecked(false);
+    }
+}
+
+void MainWindow::onWatchedFilesReady(const QStringList &files)
+{
+    // Unterordner-Struktur des Hot Folders bleibt unter dem Server-Pfad erhalten
+    m_engine->enqueue(files, m_folderWatcher->folder(), m_serverPathEdit->text());
+    log(QString("Watch folder: %1 new file(s)").arg(files.size()));
+
+    if (m_engine->isLoggedIn()) {
+        m_engine->start();
+    } else {
+        m_resumeAfterLogin = true;
+    }
+}
+
+void MainWindow::applyServerSettings()
+{
+    QList<ServerPool::Server> servers;
+    for (const QString &profile : std::as_const(SERVER_PROFILES))
+        servers.append(ServerPool::parse(profile));
+    m_engine->setServers(servers);
+    // Verbindung aufbauen, während der Benutzer noch die Zugangsdaten eintippt
+    m_engine->prewarm();
 }
 
 void MainWindow::appConfig()
 {
     bool ok;
 
-    QString text = QInputDialog::getText(this,
-                                         tr("Server URL"),
-                                         tr("Please enter the new Server URL"),
-                                         QLineEdit::Normal,
-                                         SERVER_URL,
+    QString text = QInputDialog::getMultiLineText(this,
+                                                  tr("Servers"),
+                                                  tr("One server per line: [name=]URL, optionally with user@ "
+                                                     "(password from the login).\nThe fastest reachable "
+                                                     "server is used; if it fails, the next one takes over."),
+                                                  SERVER_PROFILES.join('\n'),
+                                                  &ok);
+    QStringList profiles;
+    for (const QString &line : text.split('\n', Qt::SkipEmptyParts)) {
+        if (!line.trimmed().isEmpty())
+            profiles.append(ServerPool::format(ServerPool::parse(line))); // ohne Passwort
+    }
+    if (ok && !profiles.isEmpty()) {
+        settings->setValue("Servers", profiles);
+        settings->remove("Server");
+        SERVER_PROFILES = profiles;
+        applyServerSettings();
+    }
+
+    int concurrency = QInputDialog::getInt(this,
+                                           tr("Parallel Uploads"),
+                                           tr("Number of parallel uploads"),
+                                           m_uploadQueue->concurrency(),
+                                           1,
+                                           32,
+                                           1,
+                                           &ok);
+    if (ok) {
+        settings->setValue("Concurrency", concurrency);
+        m_uploadQueue->setConcurrency(concurrency);
+    }
+
+    int chunkSize = QInputDialog::getInt(this,
+                                         tr("Chunked Uploads"),
+                                         tr("Chunk size in MB for resumable uploads (0 = off)"),
+                                         static_cast<int>(m_uploadQueue->chunkSize() / (1024 * 1024)),
+                                         0,
+                                         1024,
+                                         1,
                                          &ok);
-    if (ok && !text.isEmpty()) {
-        settings->setValue("Server", text);
-        SERVER_URL = text;
+    if (ok) {
+        settings->setValue("ChunkSize", chunkSize);
+        m_uploadQueue->setChunkSize(static_cast<qint64>(chunkSize) * 1024 * 1024);
+    }
+
+    // Bandbreite: wirkt sofort, auch auf laufende Uploads
+    int rateLimit = QInputDialog::getInt(this,
+                                         tr("Bandwidth"),
+                                         tr("Upload limit for all transfers in KB/s (0 = unlimited)"),
+                                         static_cast<int>(m_uploadQueue->rateLimit() / 1024),
+                                         0,
+                                         10 * 1024 * 1024,
+                                         64,
+                                         &ok);
+    if (ok) {
+        settings->setValue("RateLimit", rateLimit);
+        m_uploadQueue->setRateLimits(static_cast<qint64>(rateLimit) * 1024,
+                                     m_uploadQueue->transferRateLimit());
+    }
+
+    int transferLimit = QInputDialog::getInt(this,
+                                             tr("Bandwidth"),
+                                             tr("Upload limit per transfer in KB/s (0 = unlimited)"),
+                                             static_cast<int>(m_uploadQueue->transferRateLimit() / 1024),
+                                             0,
+                                             10 * 1024 * 1024,
+                                             64,
+                                             &ok);
+    if (ok) {
+        settings->setValue("RateLimitPerTransfer", transferLimit);
+        m_uploadQueue->setRateLimits(m_uploadQueue->rateLimit(),
+                                     static_cast<qint64>(transferLimit) * 1024);
+    }
+
+    QString metricsFile = QInputDialog::getText(this,
+                                                tr("Metrics"),
+                                                tr("Metrics file for monitoring (*.json or Prometheus "
+                                                   "text, empty = off)"),
+                                                QLineEdit::Normal,
+                                                m_engine->telemetry()->exportFile(),
+                                                &ok);
+    if (ok) {
+        settings->setValue("MetricsFile", metricsFile);
+        m_engine->telemetry()->setExportFile(metricsFile);
+    }
+
+    const ImageTranscoder::Options options = m_uploadQueue->transcodeOptions();
+
+    int maxEdge = QInputDialog::getInt(this,
+                                       tr("Downscale Images"),
+                                       tr("Maximum edge length in pixels"),
+                                       options.maxEdge,
+                                       256,
+                                       16384,
+                                       128,
+                                       &ok);
+    if (ok)
+        settings->setValue("TranscodeMaxEdge", maxEdge);
+
+    int quality = QInputDialog::getInt(this,
+                                       tr("Downscale Images"),
+                                       tr("Encoder quality (1-100)"),
+                                       options.quality,
+                                       1,
+                                       100,
+                                       1,
+                                       &ok);
+    if (ok)
+        settings->setValue("TranscodeQuality", quality);
+
+    const QStringList formats = {"jpg", "webp", "png"};
+    QString format = QInputDialog::getItem(this,
+                                           tr("Downscale Images"),
+                                           tr("Output format"),
+                                           formats,
+                                           std::max<int>(formats.indexOf(QString::fromLatin1(options.format)), 0),
+                                           false,
+                                           &ok);
+    if (ok)
+        settings->setValue("TranscodeFormat", format);
+
+    applyTranscodeSettings();
+
+    int thumbnailMemory = QInputDialog::getInt(this,
+                                               tr("Thumbnails"),
+                                               tr("Memory for thumbnails in MB"),
+                                               static_cast<int>(m_thumbnails->memoryLimit() / (1024 * 1024)),
+                                               8,
+                                               4096,
+                                               8,
+                                               &ok);
+    if (ok) {
+        settings->setValue("ThumbnailCacheMB", thumbnailMemory);
+        m_thumbnails->setMemoryLimit(static_cast<qint64>(thumbnailMemory) * 1024 * 1024);
     }
 }
 
@@ -468,20 +927,3 @@ void MainWindow::appAbout()
     //msgBox.setFixedWidth(900);
     msgBox.exec();
 }
-
-void MainWindow::performTokenRefresh()
-{
-    if (m_isRefreshing)
-        return;
-    m_isRefreshing = true;
-
-    QUrl url(SERVER_URL + "/refresh");
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-
-    QJsonObject json;
-    json["refreshToken"] = m_refreshToken;
-
-    log("Token expired. Attempting refresh...");
-    m_netManager->post(request, QJsonDocument(json).toJson());
-}
@@ -3,16 +3,23 @@
 #include <QApplication>
 #include <QDesktopServices>
 #include <QLabel>
+#include <QHash>
 #include <QLineEdit>
+#include <QListView>
 #include <QMainWindow>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
 #include <QProgressBar>
 #include <QPushButton>
 #include <QSettings>
-#include <QTextEdit>
+#include <QTabWidget>
+#include <QTimer>
+#include <QTreeWidget>
 #include <QUrl>
 
+#include "FolderWatcher.h"
+#include "LogModel.h"
+#include "ThumbnailCache.h"
+#include "ThumbnailModel.h"
+#include "UploadEngine.h"
 #include "includes/rz_config.hpp"
 
 class MainWindow : public QMainWindow
@@ -28,22 +35,52 @@ private slots:
     void onLogoutClicked();
 
     void onBrowseClicked();
+    void onFolderClicked();
+    void onSyncClicked();
     void onUploadClicked();
-    void onNetworkFinished(QNetworkReply *reply);
-    void onUploadProgress(qint64 bytesSent, qint64 bytesTotal);
+    void onLoggedIn();
+    void onSessionExpired();
+    void onUploadProgress(qint64 bytesSent, qint64 bytesTotal, double bytesPerSecond);
+
+    void onQueueItemAdded(int index);
+    void onQueueItemStarted(int index);
+    void onQueueItemProgress(int index, qint64 bytesSent, qint64 bytesTotal);
+    void onQueueItemFinished(int index, bool ok, const QString &message);
+    void onQueueItemSkipped(int index);
+    void onQueueFinished(int succeeded, int skipped, int failed, qint64 bytes, qint64 elapsedMs);
 
     void openGithub();
 
 private:
     QSettings *settings;
-    QString SERVER_URL = "http://localhost:8080";
+    // Server-Profile "[name=]URL", der schnellste erreichbare wird benutzt (ServerPool)
+    QStringList SERVER_PROFILES = {"http://localhost:8080"};
     QPushButton *m_statusMiddle;
+    QLabel *m_telemetryLabel;
+    QTimer m_telemetryTimer;
     QMenu *appMenu;
     QAction *configAct;
     QAction *aboutAct;
+    QAction *dedupAct;
+    QAction *askServerAct;
+    QAction *transcodeAct;
+    QAction *compressAct;
+    QAction *metadataAct;
+    QAction *stripMetadataAct;
+    QAction *validateAct;
+    QAction *batchAct;
+    QAction *adaptiveAct;
+    QAction *logFileAct;
+    QAction *watchAct;
     void createMenu();
     void appConfig();
     void appAbout();
+    void applyServerSettings();
+    void applyDedupSettings();
+    void applyTranscodeSettings();
+    void applyLogSettings();
+    void applyWatchSettings();
+    void onWatchedFilesReady(const QStringList &files);
 
     // GUI Elements
     QLineEdit *m_userEdit;
@@ -55,23 +92,48 @@ private:
     QLineEdit *m_filePathEdit;
     QLineEdit *m_serverPathEdit;
     QPushButton *m_browseBtn;
+    QPushButton *m_folderBtn;
+    QPushButton *m_syncBtn;
     QPushButton *m_uploadBtn;
-
-    QTextEdit *m_logArea;
+    QTreeWidget *m_queueView;
+    QTabWidget *m_viewTabs;
+
+    // Thumbnails der Auswahl bzw. (ohne Auswahl) der Warteschlange
+    ThumbnailCache *m_thumbnails;
+    ThumbnailModel *m_thumbModel;
+    QListView *m_thumbView;
+    bool m_resumeAfterLogin = false; // Uploads aus Journal/Hot Folder warten auf den Login
+    FolderWatcher *m_folderWatcher;
+
+    // Log: Ringpuffer, die View bekommt die Zeilen gebündelt
+    LogModel *m_logModel;
+    QListView *m_logView;
+    bool m_logFollow = true; // am Ende mitscrollen, solange der Benutzer nicht hochscrollt
     QLabel *m_statusLabel;
 
     QProgressBar *m_progressBar;
 
-    // Networking
-    QNetworkAccessManager *m_netManager;
-    QString m_jwtToken;
-    QString m_refreshToken;
-    bool m_isRefreshing = false;
-
-    void performTokenRefresh();
+    // Fortschritt wird gesammelt und höchstens MaxProgressFps mal pro Sekunde gezeichnet
+    static constexpr int MaxProgressFps = 20;
+    QTimer m_progressTimer;
+    bool m_progressDirty = false;
+    qint64 m_progressSent = 0;
+    qint64 m_progressTotal = 0;
+    double m_progressRate = 0.0;
+    QHash<int, int> m_itemPercent; // Queue-Index -> Prozent, noch nicht gezeichnet
+
+    // Networking (Login, Token Refresh, Upload Queue)
+    UploadEngine *m_engine;
+    UploadQueue *m_uploadQueue;
+    QStringList m_selectedFiles;
+    QString m_selectionRoot;
 
     // Helper
     void log(const QString &msg);
-    void retryLastUpload();
+    void scheduleProgress();
+    void flushProgress();
+    void resetProgress();
+    void setSelection(const QStringList &files, const QString &root);
+    void updateThumbnails();
     void resetUI();
 };
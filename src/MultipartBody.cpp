@@ -0,0 +1,179 @@
+#include "MultipartBody.h"
+
+#include <QUuid>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+QByteArray quoted(const QString &value)
+{
+    QByteArray bytes = value.toUtf8();
+    bytes.replace('"', "\\\"");
+    return bytes;
+}
+} // namespace
+
+MultipartBody::MultipartBody(QIODevice *file,
+                             const QString &fileName,
+                             const QString &contentType,
+                             const QString &serverPath,
+                             const QByteArray &contentEncoding,
+                             const QByteArray &metadata,
+                             QObject *parent)
+    : QIODevice(parent)
+    , m_boundary("crow-" + QUuid::createUuid().toByteArray(QUuid::Id128))
+{
+    appendPart({file, fileName, contentType, serverPath, contentEncoding, metadata}, false);
+    appendBytes("--" + m_boundary + "--\r\n");
+
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+MultipartBody::MultipartBody(const QList<FilePart> &parts, QObject *parent)
+    : QIODevice(parent)
+    , m_boundary("crow-" + QUuid::createUuid().toByteArray(QUuid::Id128))
+{
+    for (const FilePart &part : parts)
+        appendPart(part, true);
+    appendBytes("--" + m_boundary + "--\r\n");
+
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+void MultipartBody::appendPart(const FilePart &part, bool alwaysPath)
+{
+    QByteArray head = "--" + m_boundary + "\r\n"
+                      "Content-Disposition: form-data; name=\"photo\"; filename=\""
+                      + quoted(part.fileName) + "\"\r\n"
+                      "Content-Type: " + part.contentType.toUtf8() + "\r\n";
+    if (!part.contentEncoding.isEmpty())
+        head += "Content-Encoding: " + part.contentEncoding + "\r\n";
+    if (!part.idempotencyKey.isEmpty())
+        head += "Idempotency-Key: " + part.idempotencyKey + "\r\n";
+    head += "\r\n";
+    appendBytes(head);
+
+    part.file->setParent(this);
+    Segment segment;
+    segment.file = part.file;
+    segment.lazy = !part.file->isOpen();
+    segment.offset = m_size;
+    segment.size = part.file->size();
+    m_segments.append(segment);
+    m_size += segment.size;
+
+    QByteArray tail = "\r\n";
+    if (alwaysPath || !part.serverPath.isEmpty()) {
+        tail += "--" + m_boundary + "\r\n"
+                "Content-Disposition: form-data; name=\"path\"\r\n\r\n"
+                + part.serverPath.toUtf8() + "\r\n";
+    }
+    if (!part.metadata.isEmpty()) {
+        tail += "--" + m_boundary + "\r\n"
+                "Content-Disposition: form-data; name=\"metadata\"\r\n"
+                "Content-Type: application/json\r\n\r\n"
+                + part.metadata + "\r\n";
+    }
+    appendBytes(tail);
+}
+
+void MultipartBody::appendBytes(const QByteArray &bytes)
+{
+    // Aufeinanderfolgende feste Bytes in einem Segment zusammenfassen
+    if (!m_segments.isEmpty() && !m_segments.last().file) {
+        m_segments.last().bytes += bytes;
+        m_segments.last().size += bytes.size();
+    } else {
+        Segment segment;
+        segment.bytes = bytes;
+        segment.offset = m_size;
+        segment.size = bytes.size();
+        m_segments.append(segment);
+    }
+    m_size += bytes.size();
+}
+
+QByteArray MultipartBody::contentType() const
+{
+    return "multipart/form-data; boundary=" + m_boundary;
+}
+
+qint64 MultipartBody::size() const
+{
+    return m_size;
+}
+
+bool MultipartBody::seek(qint64 pos)
+{
+    if (pos < 0 || pos > m_size || !QIODevice::seek(pos))
+        return false;
+    m_pos = pos;
+    // Dateien werden erst beim Lesen positioniert
+    m_current = 0;
+    while (m_current + 1 < m_segments.size() && m_segments.at(m_current + 1).offset <= pos)
+        ++m_current;
+    return true;
+}
+
+qint64 MultipartBody::readData(char *data, qint64 maxSize)
+{
+    if (m_pos >= m_size)
+        return -1;
+
+    qint64 read = 0;
+    while (read < maxSize && m_current < m_segments.size()) {
+        Segment &segment = m_segments[m_current];
+        const qint64 local = m_pos - segment.offset;
+        if (local >= segment.size) {
+            // Segment fertig: selbst geöffnete Dateien gleich wieder schließen (Batches)
+            if (segment.lazy && segment.file->isOpen())
+                segment.file->close();
+            ++m_current;
+            continue;
+        }
+
+        const qint64 wanted = std::min(maxSize - read, segment.size - local);
+        qint64 length = wanted;
+        if (segment.file) {
+            // Die Datei wird direkt in den Puffer des Aufrufers gelesen
+            length = readFile(segment, data + read, wanted);
+            if (length <= 0)
+                return read > 0 ? read : -1;
+        } else {
+            std::memcpy(data + read, segment.bytes.constData() + local, static_cast<size_t>(length));
+        }
+        read += length;
+        m_pos += length;
+    }
+    return read;
+}
+
+qint64 MultipartBody::readFile(Segment &segment, char *data, qint64 maxSize)
+{
+    QIODevice *file = segment.file;
+    if (!file->isOpen() && !file->open(QIODevice::ReadOnly)) {
+        setErrorString(file->errorString());
+        return -1;
+    }
+
+    const qint64 local = m_pos - segment.offset;
+    if (file->pos() != local && !file->seek(local)) {
+        setErrorString(file->errorString());
+        return -1;
+    }
+
+    const qint64 fileRead = file->read(data, maxSize);
+    if (fileRead < 0) {
+        setErrorString(file->errorString());
+        return -1;
+    }
+    if (fileRead == 0)
+        setErrorString(tr("File shrank during upload."));
+    return fileRead;
+}
+
+qint64 MultipartBody::writeData(const char *, qint64)
+{
+    return -1;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file MultipartBody.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief multipart/form-data upload body streamed from the file, with known size
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QList>
+#include <QString>
+
+// Kopf (Boundary + Part-Header) + Datei + Rest ("path" und "metadata" Part, abschließende
+// Boundary), bei mehreren Dateien (Batch) je Datei ein "photo" Part, gefolgt von ihrem
+// "path" und ggf. "metadata" Part.
+// Wahlfreier Zugriff, damit der Body von vorne gelesen oder gedrosselt werden kann.
+class MultipartBody : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    struct FilePart
+    {
+        QIODevice *file = nullptr; // ungeöffnet: wird erst beim Lesen geöffnet und danach geschlossen
+        QString fileName;
+        QString contentType;
+        QString serverPath;
+        QByteArray contentEncoding;
+        QByteArray metadata; // JSON (ExifReader::toJson), leer = kein "metadata" Part
+        // Als Header des "photo" Parts: im Batch erkennt der Server jede Datei einzeln wieder,
+        // egal mit welchen anderen sie beim Retry zusammen gesendet wird
+        QByteArray idempotencyKey;
+    };
+
+    // Übernimmt file (offen), Part "photo" mit fileName/contentType und optional "path"
+    // und "metadata"
+    MultipartBody(QIODevice *file,
+                  const QString &fileName,
+                  const QString &contentType,
+                  const QString &serverPath,
+                  const QByteArray &contentEncoding = {},
+                  const QByteArray &metadata = {},
+                  QObject *parent = nullptr);
+    // Übernimmt alle Dateien; "path" wird immer gesendet (ggf. leer), damit der Server
+    // jedem "photo" seinen Zielpfad zuordnen kann
+    explicit MultipartBody(const QList<FilePart> &parts, QObject *parent = nullptr);
+
+    // Wert für den Content-Type Header des Requests (mit Boundary)
+    QByteArray contentType() const;
+
+    qint64 size() const override;
+    bool seek(qint64 pos) override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    // Feste Bytes oder eine Datei, hintereinander ergeben sie den Body
+    struct Segment
+    {
+        QByteArray bytes;
+        QIODevice *file = nullptr;
+        qint64 offset = 0; // Beginn im Body
+        qint64 size = 0;
+        bool lazy = false; // selbst geöffnet, nach dem Lesen wieder schließen
+    };
+
+    void appendPart(const FilePart &part, bool alwaysPath);
+    void appendBytes(const QByteArray &bytes);
+    qint64 readFile(Segment &segment, char *data, qint64 maxSize);
+
+    QByteArray m_boundary;
+    QList<Segment> m_segments;
+    qsizetype m_current = 0; // Segment, in dem m_pos liegt
+    qint64 m_size = 0;
+    qint64 m_pos = 0;
+};
@@ -0,0 +1,211 @@
+#include "NetworkCall.h"
+#include "RetryPolicy.h"
+
+#include <utility>
+
+NetworkCall::NetworkCall(QNetworkAccessManager *manager,
+                         const QNetworkRequest &request,
+                         QNetworkAccessManager::Operation operation,
+                         const QByteArray &body,
+                         QObject *context,
+                         Continuation then)
+    // Kontext als Parent: mit ihm verschwindet auch der Call (und bricht den Request ab)
+    : QObject(context ? context : manager)
+    , m_netManager(manager)
+    , m_request(request)
+    , m_operation(operation)
+    , m_body(body)
+    , m_then(std::move(then))
+{
+    m_timeout.setSingleShot(true);
+    m_timeout.setInterval(DefaultTimeoutMs);
+    connect(&m_timeout, &QTimer::timeout, this, &NetworkCall::onTimeout);
+    m_retryTimer.setSingleShot(true);
+    connect(&m_retryTimer, &QTimer::timeout, this, &NetworkCall::send);
+}
+
+NetworkCall *NetworkCall::get(QNetworkAccessManager *manager,
+                              const QNetworkRequest &request,
+                              QObject *context,
+                              Continuation then)
+{
+    NetworkCall *call = new NetworkCall(manager,
+                                        request,
+                                        QNetworkAccessManager::GetOperation,
+                                        QByteArray(),
+                                        context,
+                                        std::move(then));
+    call->send();
+    return call;
+}
+
+NetworkCall *NetworkCall::post(QNetworkAccessManager *manager,
+                               const QNetworkRequest &request,
+                               const QByteArray &body,
+                               QObject *context,
+                               Continuation then)
+{
+    NetworkCall *call = new NetworkCall(manager,
+                                        request,
+                                        QNetworkAccessManager::PostOperation,
+                                        body,
+                                        context,
+                                        std::move(then));
+    call->send();
+    return call;
+}
+
+NetworkCall *NetworkCall::post(QNetworkAccessManager *manager,
+                               const QNetworkRequest &request,
+                               QIODevice *body,
+                               QObject *context,
+                               Continuation then)
+{
+    return stream(manager, request, QNetworkAccessManager::PostOperation, body, context, std::move(then));
+}
+
+NetworkCall *NetworkCall::put(QNetworkAccessManager *manager,
+                              const QNetworkRequest &request,
+                              QIODevice *body,
+                              QObject *context,
+                              Continuation then)
+{
+    return stream(manager, request, QNetworkAccessManager::PutOperation, body, context, std::move(then));
+}
+
+NetworkCall *NetworkCall::stream(QNetworkAccessManager *manager,
+                                 const QNetworkRequest &request,
+                                 QNetworkAccessManager::Operation operation,
+                                 QIODevice *body,
+                                 QObject *context,
+                                 Continuation then)
+{
+    NetworkCall *call = new NetworkCall(manager, request, operation, QByteArray(), context, std::move(then));
+    call->m_device = body;
+    call->send();
+    return call;
+}
+
+NetworkCall::~NetworkCall()
+{
+    abortReply();
+}
+
+void NetworkCall::setTimeout(int ms)
+{
+    m_timeout.setInterval(ms);
+    if (ms <= 0)
+        m_timeout.stop();
+    else if (m_reply)
+        m_timeout.start();
+}
+
+void NetworkCall::setMaxRetries(int maxRetries)
+{
+    m_maxRetries = maxRetries;
+}
+
+QNetworkRequest NetworkCall::request() const
+{
+    return m_request;
+}
+
+QNetworkReply *NetworkCall::reply() const
+{
+    return m_reply;
+}
+
+int NetworkCall::retries() const
+{
+    return m_retries;
+}
+
+void NetworkCall::send()
+{
+    QNetworkRequest request = m_request;
+    RetryPolicy::markAttempt(request, m_retries);
+    QNetworkReply *reply = nullptr;
+    if (m_device) {
+        reply = m_operation == QNetworkAccessManager::PutOperation ? m_netManager->put(request, m_device)
+                                                                   : m_netManager->post(request, m_device);
+        m_device->setParent(reply);
+    } else if (m_operation == QNetworkAccessManager::PostOperation) {
+        reply = m_netManager->post(request, m_body);
+    } else {
+        reply = m_netManager->get(request);
+    }
+    m_reply = reply;
+
+    // Jeder Fortschritt setzt den Timeout zurück: große Antworten dürfen dauern, Stillstand nicht
+    const auto alive = [this]() {
+        if (m_timeout.interval() > 0)
+            m_timeout.start();
+    };
+    connect(reply, &QNetworkReply::uploadProgress, this, alive);
+    connect(reply, &QNetworkReply::downloadProgress, this, alive);
+    connect(reply, &QNetworkReply::finished, this, &NetworkCall::onFinished);
+    alive();
+}
+
+void NetworkCall::onTimeout()
+{
+    if (!m_reply)
+        return;
+    // Merker für RetryPolicy; abort() liefert finished() synchron mit OperationCanceledError
+    m_reply->setProperty(RetryPolicy::TimedOutProperty, true);
+    m_reply->abort();
+}
+
+void NetworkCall::onFinished()
+{
+    m_timeout.stop();
+    QNetworkReply *reply = m_reply;
+    m_reply.clear();
+    if (!reply || m_done)
+        return;
+    reply->deleteLater();
+
+    if (!m_device && m_retries < m_maxRetries && RetryPolicy::isRetryable(reply)) {
+        ++m_retries;
+        const int delayMs = RetryPolicy::delayMs(m_retries, reply);
+        emit retrying(m_retries, delayMs, RetryPolicy::reason(reply));
+        m_retryTimer.start(delayMs);
+        return;
+    }
+
+    m_done = true;
+    // Die Continuation darf den Kontext (und damit diesen Call) löschen
+    const QPointer<NetworkCall> self(this);
+    if (m_then)
+        m_then(reply);
+    if (self)
+        complete();
+}
+
+void NetworkCall::cancel()
+{
+    if (m_done)
+        return;
+    m_done = true;
+    m_retryTimer.stop();
+    m_timeout.stop();
+    abortReply();
+    complete();
+}
+
+void NetworkCall::abortReply()
+{
+    if (!m_reply)
+        return;
+    QNetworkReply *reply = m_reply;
+    m_reply.clear();
+    disconnect(reply, nullptr, this, nullptr);
+    reply->abort();
+    reply->deleteLater();
+}
+
+void NetworkCall::complete()
+{
+    emit finished();
+    deleteLater();
+}
@@ -0,0 +1,124 @@
+/**
+ * @file NetworkCall.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief one request with its own continuation, inactivity timeout, retries and cancellation
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QTimer>
+
+#include <functional>
+
+/*
+ * Statt eines zentralen QNetworkAccessManager::finished Handlers, der am Pfad
+ * erraten muss, wozu eine Antwort gehört, trägt jeder Request seine Continuation
+ * selbst. Sie läuft genau einmal: mit der Antwort, dem letzten Fehler nach allen
+ * Wiederholungen oder nach dem Timeout (reply->error() ist dann gesetzt,
+ * RetryPolicy::isRetryable() liefert true). Nach cancel() oder wenn der Kontext
+ * (Parent) zerstört wird, läuft sie nicht mehr und der Request wird abgebrochen.
+ *
+ *   NetworkCall *call = NetworkCall::post(manager, request, body, this, [this](QNetworkReply *reply) {
+ *       ...
+ *   });
+ *   call->setMaxRetries(RetryPolicy::MaxRetries);
+ *
+ * Uploads mit gestreamtem Body (QIODevice, z.B. ThrottledDevice) bekommen Timeout
+ * und Abbruch genauso, aber keine eigenen Wiederholungen: der Body ist nach dem
+ * ersten Versuch verbraucht, die Upload Queue bzw. ChunkedUpload wiederholt selbst.
+ */
+class NetworkCall : public QObject
+{
+    Q_OBJECT
+
+public:
+    // reply gehört dem Call und lebt bis zum Ende der Continuation
+    using Continuation = std::function<void(QNetworkReply *reply)>;
+
+    // Ohne Daten in eine der beiden Richtungen so lange: Request abbrechen
+    static constexpr int DefaultTimeoutMs = 30000;
+
+    static NetworkCall *get(QNetworkAccessManager *manager,
+                            const QNetworkRequest &request,
+                            QObject *context,
+                            Continuation then);
+    static NetworkCall *post(QNetworkAccessManager *manager,
+                             const QNetworkRequest &request,
+                             const QByteArray &body,
+                             QObject *context,
+                             Continuation then);
+    // body geht an den Reply über und wird mit ihm gelöscht
+    static NetworkCall *post(QNetworkAccessManager *manager,
+                             const QNetworkRequest &request,
+                             QIODevice *body,
+                             QObject *context,
+                             Continuation then);
+    static NetworkCall *put(QNetworkAccessManager *manager,
+                            const QNetworkRequest &request,
+                            QIODevice *body,
+                            QObject *context,
+                            Continuation then);
+    ~NetworkCall() override;
+
+    // Inaktivität in ms, 0 = kein Timeout; gilt sofort, auch für den laufenden Versuch
+    void setTimeout(int ms);
+    // Vorübergehende Fehler (RetryPolicy) so oft mit Backoff wiederholen (Standard 0, mit QIODevice-Body immer 0)
+    void setMaxRetries(int maxRetries);
+    // Request bzw. geplante Wiederholung verwerfen; die Continuation läuft nicht mehr
+    void cancel();
+
+    QNetworkRequest request() const;
+    // Laufender Versuch, nullptr zwischen Wiederholungen und nach dem Ende
+    QNetworkReply *reply() const;
+    int retries() const;
+
+signals:
+    // Vorübergehender Fehler: nächster Versuch (1..maxRetries) in delayMs
+    void retrying(int retry, int delayMs, const QString &reason);
+    // Genau einmal am Ende, auch nach Timeout und cancel(); danach wird der Call gelöscht
+    void finished();
+
+private:
+    NetworkCall(QNetworkAccessManager *manager,
+                const QNetworkRequest &request,
+                QNetworkAccessManager::Operation operation,
+                const QByteArray &body,
+                QObject *context,
+                Continuation then);
+    static NetworkCall *stream(QNetworkAccessManager *manager,
+                               const QNetworkRequest &request,
+                               QNetworkAccessManager::Operation operation,
+                               QIODevice *body,
+                               QObject *context,
+                               Continuation then);
+
+    void send();
+    void onFinished();
+    void onTimeout();
+    void abortReply();
+    void complete();
+
+    QNetworkAccessManager *m_netManager;
+    QNetworkRequest m_request;
+    QNetworkAccessManager::Operation m_operation;
+    QByteArray m_body; // für Wiederholungen
+    QIODevice *m_device = nullptr; // gestreamter Body, gehört nach send() dem Reply
+    Continuation m_then;
+    QPointer<QNetworkReply> m_reply;
+    QTimer m_timeout;
+    QTimer m_retryTimer;
+    int m_maxRetries = 0;
+    int m_retries = 0;
+    bool m_done = false;
+};
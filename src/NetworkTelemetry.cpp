@@ -0,0 +1,377 @@
+#include "NetworkTelemetry.h"
+#include "RetryPolicy.h"
+#include "TlsSessionCache.h"
+
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QPointer>
+#include <QSaveFile>
+
+namespace {
+
+// Hängt jeden erzeugten Reply an die Telemetrie, bevor jemand anders ihn sieht
+class InstrumentedManager : public QNetworkAccessManager
+{
+public:
+    InstrumentedManager(NetworkTelemetry *telemetry, TlsSessionCache *sessions, QObject *parent)
+        : QNetworkAccessManager(parent)
+        , m_telemetry(telemetry)
+        , m_sessions(sessions)
+    {}
+
+protected:
+    QNetworkReply *createRequest(Operation op,
+                                 const QNetworkRequest &request,
+                                 QIODevice *outgoingData) override
+    {
+        // HTTP/2 anbieten (Qt 6 Default, hier ausdrücklich): bietet der Server h2 per ALPN an,
+        // teilen sich alle parallelen Uploads eine Verbindung
+        QNetworkRequest prepared(request);
+        prepared.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+        if (m_sessions)
+            m_sessions->apply(prepared);
+
+        QNetworkReply *reply = QNetworkAccessManager::createRequest(op, prepared, outgoingData);
+        if (m_telemetry)
+            m_telemetry->watch(reply);
+        if (m_sessions)
+            m_sessions->watch(reply);
+        return reply;
+    }
+
+private:
+    QPointer<NetworkTelemetry> m_telemetry;
+    QPointer<TlsSessionCache> m_sessions;
+};
+
+QByteArray labelValue(const QString &value)
+{
+    QString escaped = value;
+    escaped.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+    return escaped.toUtf8();
+}
+
+QByteArray number(double value)
+{
+    return QByteArray::number(value, 'g', 10);
+}
+
+} // namespace
+
+void NetworkTelemetry::Histogram::add(double ms)
+{
+    qsizetype bucket = 0;
+    while (bucket < qsizetype(Buckets.size()) && ms > Buckets[bucket])
+        ++bucket;
+    ++counts[bucket];
+    ++count;
+    sum += ms;
+}
+
+double NetworkTelemetry::Histogram::mean() const
+{
+    return count > 0 ? sum / count : 0.0;
+}
+
+NetworkTelemetry::NetworkTelemetry(QObject *parent)
+    : QObject(parent)
+{
+    m_clock.start();
+    connect(&m_exportTimer, &QTimer::timeout, this, [this]() { exportNow(); });
+}
+
+QNetworkAccessManager *NetworkTelemetry::createManager(NetworkTelemetry *telemetry,
+                                                       TlsSessionCache *sessions,
+                                                       QObject *parent)
+{
+    return new InstrumentedManager(telemetry, sessions, parent);
+}
+
+QString NetworkTelemetry::phaseName(Phase phase)
+{
+    switch (phase) {
+    case Queued:
+        return "queued";
+    case Connect:
+        return "connect";
+    case Send:
+        return "send";
+    case Ttfb:
+        return "ttfb";
+    case Receive:
+        return "receive";
+    case Total:
+    case PhaseCount:
+        break;
+    }
+    return "total";
+}
+
+QString NetworkTelemetry::kindOf(const QNetworkRequest &request)
+{
+    const QString path = request.url().path();
+    if (path == "/login")
+        return "login";
+    if (path == "/refresh")
+        return "refresh";
+    if (path == "/logout")
+        return "logout";
+    if (path == "/upload")
+        return "upload";
+    if (path == "/upload/exists")
+        return "exists";
+    if (path == "/upload/batch")
+        return "batch";
+    if (path == "/upload/manifest")
+        return "manifest";
+    if (path.startsWith("/upload/chunked"))
+        return "chunked";
+    return "other";
+}
+
+qint64 NetworkTelemetry::now() const
+{
+    return m_clock.nsecsElapsed();
+}
+
+void NetworkTelemetry::watch(QNetworkReply *reply)
+{
+    Trace trace;
+    trace.kind = kindOf(reply->request());
+    trace.attempt = RetryPolicy::attempt(reply);
+    trace.created = now();
+    m_traces.insert(reply, trace);
+
+    // Nur Zeitstempel setzen, ausgewertet wird einmal am Ende
+    connect(reply, &QNetworkReply::socketStartedConnecting, this, [this, reply]() {
+        m_traces[reply].connecting = now();
+    });
+    connect(reply, &QNetworkReply::encrypted, this, [this, reply]() {
+        m_traces[reply].encrypted = now();
+    });
+    connect(reply, &QNetworkReply::requestSent, this, [this, reply]() {
+        m_traces[reply].sent = now();
+    });
+    connect(reply, &QNetworkReply::metaDataChanged, this, [this, reply]() {
+        Trace &trace = m_traces[reply];
+        if (trace.firstByte < 0)
+            trace.firstByte = now();
+    });
+    connect(reply, &QNetworkReply::uploadProgress, this, [this, reply](qint64 bytesSent, qint64) {
+        m_traces[reply].bytesSent = bytesSent;
+    });
+    connect(reply, &QNetworkReply::downloadProgress, this, [this, reply](qint64 bytesReceived, qint64) {
+        m_traces[reply].bytesReceived = bytesReceived;
+    });
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() { onFinished(reply); });
+    connect(reply, &QObject::destroyed, this, [this, reply]() { m_traces.remove(reply); });
+}
+
+void NetworkTelemetry::onFinished(QNetworkReply *reply)
+{
+    const auto it = m_traces.constFind(reply);
+    if (it == m_traces.constEnd())
+        return;
+    const Trace trace = *it;
+    m_traces.erase(it);
+
+    const qint64 finished = now();
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    KindStats &stats = m_stats[trace.kind];
+    ++stats.responses[status > 0 ? QString::number(status) : QString("error")];
+    stats.bytesSent += trace.bytesSent;
+    stats.bytesReceived += trace.bytesReceived;
+    if (trace.attempt > 0)
+        ++stats.retries;
+    if (reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool())
+        ++stats.http2;
+
+    const auto record = [&stats](Phase phase, qint64 from, qint64 to) {
+        if (from >= 0 && to >= from)
+            stats.phases[phase].add((to - from) / 1e6);
+    };
+    // Ohne neuen Verbindungsaufbau beginnt das Senden direkt bei der Erzeugung
+    const qint64 sendStart = trace.encrypted >= 0    ? trace.encrypted
+                             : trace.connecting >= 0 ? trace.connecting
+                                                     : trace.created;
+    record(Queued, trace.created, trace.connecting);
+    if (trace.connecting >= 0)
+        record(Connect, trace.connecting, trace.encrypted);
+    record(Send, sendStart, trace.sent);
+    record(Ttfb, trace.sent, trace.firstByte);
+    record(Receive, trace.firstByte, finished);
+    record(Total, trace.created, finished);
+
+    emit requestFinished(trace.kind, status, (finished - trace.created) / 1000000);
+}
+
+void NetworkTelemetry::recordStartup(const QString &name, double ms)
+{
+    m_startup.insert(name, ms);
+}
+
+void NetworkTelemetry::setExportFile(const QString &filePath, int intervalMs)
+{
+    m_exportFile = filePath;
+    m_exportTimer.stop();
+    if (!filePath.isEmpty() && intervalMs > 0)
+        m_exportTimer.start(intervalMs);
+}
+
+QString NetworkTelemetry::exportFile() const
+{
+    return m_exportFile;
+}
+
+bool NetworkTelemetry::exportNow() const
+{
+    if (m_exportFile.isEmpty())
+        return false;
+
+    // Atomar ersetzen, damit der Scraper nie eine halbe Datei liest
+    const bool json = QFileInfo(m_exportFile).suffix().toLower() == "json";
+    const QByteArray data = json ? QJsonDocument(toJson()).toJson(QJsonDocument::Indented)
+                                 : toPrometheus();
+    QSaveFile file(m_exportFile);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size())
+        return false;
+    return file.commit();
+}
+
+QJsonObject NetworkTelemetry::toJson() const
+{
+    QJsonArray bounds;
+    for (const double bound : Buckets)
+        bounds.append(bound);
+
+    QJsonObject kinds;
+    for (auto it = m_stats.constBegin(); it != m_stats.constEnd(); ++it) {
+        const KindStats &stats = it.value();
+
+        QJsonObject responses;
+        for (auto r = stats.responses.constBegin(); r != stats.responses.constEnd(); ++r)
+            responses[r.key()] = r.value();
+
+        QJsonObject phases;
+        for (int phase = 0; phase < PhaseCount; ++phase) {
+            const Histogram &histogram = stats.phases[phase];
+            if (histogram.count == 0)
+                continue;
+            QJsonArray counts;
+            for (const qint64 count : histogram.counts)
+                counts.append(count);
+            phases[phaseName(Phase(phase))] = QJsonObject{{"count", histogram.count},
+                                                          {"sumMs", histogram.sum},
+                                                          {"meanMs", histogram.mean()},
+                                                          {"buckets", counts}};
+        }
+
+        kinds[it.key()] = QJsonObject{{"responses", responses},
+                                      {"bytesSent", stats.bytesSent},
+                                      {"bytesReceived", stats.bytesReceived},
+                                      {"retries", stats.retries},
+                                      {"http2", stats.http2},
+                                      {"phases", phases}};
+    }
+    QJsonObject startup;
+    for (auto it = m_startup.constBegin(); it != m_startup.constEnd(); ++it)
+        startup[it.key() + "Ms"] = it.value();
+
+    return {{"uptimeMs", m_clock.elapsed()},
+            {"bucketBoundsMs", bounds},
+            {"requests", kinds},
+            {"startup", startup}};
+}
+
+QByteArray NetworkTelemetry::toPrometheus() const
+{
+    QByteArray out;
+    out += "# HELP crow_client_requests_total Finished HTTP requests by kind and status.\n"
+           "# TYPE crow_client_requests_total counter\n";
+    for (auto it = m_stats.constBegin(); it != m_stats.constEnd(); ++it) {
+        for (auto r = it->responses.constBegin(); r != it->responses.constEnd(); ++r) {
+            out += "crow_client_requests_total{kind=\"" + labelValue(it.key()) + "\",status=\""
+                   + labelValue(r.key()) + "\"} " + QByteArray::number(r.value()) + "\n";
+        }
+    }
+
+    const auto counter = [this, &out](const QByteArray &name,
+                                      const QByteArray &help,
+                                      qint64 KindStats::*field) {
+        out += "# HELP " + name + " " + help + "\n# TYPE " + name + " counter\n";
+        for (auto it = m_stats.constBegin(); it != m_stats.constEnd(); ++it)
+            out += name + "{kind=\"" + labelValue(it.key()) + "\"} "
+                   + QByteArray::number((*it).*field) + "\n";
+    };
+    counter("crow_client_sent_bytes_total", "Request bytes sent.", &KindStats::bytesSent);
+    counter("crow_client_received_bytes_total", "Response bytes received.", &KindStats::bytesReceived);
+    counter("crow_client_retries_total", "Requests that were retries.", &KindStats::retries);
+    counter("crow_client_http2_requests_total", "Requests sent over HTTP/2.", &KindStats::http2);
+
+    if (!m_startup.isEmpty()) {
+        out += "# HELP crow_client_startup_seconds One-off startup timings.\n"
+               "# TYPE crow_client_startup_seconds gauge\n";
+        for (auto it = m_startup.constBegin(); it != m_startup.constEnd(); ++it)
+            out += "crow_client_startup_seconds{metric=\"" + labelValue(it.key()) + "\"} "
+                   + number(it.value() / 1000.0) + "\n";
+    }
+
+    out += "# HELP crow_client_request_phase_seconds Duration of request phases.\n"
+           "# TYPE crow_client_request_phase_seconds histogram\n";
+    for (auto it = m_stats.constBegin(); it != m_stats.constEnd(); ++it) {
+        for (int phase = 0; phase < PhaseCount; ++phase) {
+            const Histogram &histogram = it->phases[phase];
+            if (histogram.count == 0)
+                continue;
+            const QByteArray labels = "kind=\"" + labelValue(it.key()) + "\",phase=\""
+                                      + phaseName(Phase(phase)).toUtf8() + "\"";
+            qint64 cumulative = 0;
+            for (qsizetype i = 0; i < histogram.counts.size(); ++i) {
+                cumulative += histogram.counts[i];
+                const QByteArray le = i < qsizetype(Buckets.size()) ? number(Buckets[i] / 1000.0)
+                                                                    : QByteArray("+Inf");
+                out += "crow_client_request_phase_seconds_bucket{" + labels + ",le=\"" + le + "\"} "
+                       + QByteArray::number(cumulative) + "\n";
+            }
+            out += "crow_client_request_phase_seconds_sum{" + labels + "} "
+                   + number(histogram.sum / 1000.0) + "\n";
+            out += "crow_client_request_phase_seconds_count{" + labels + "} "
+                   + QByteArray::number(histogram.count) + "\n";
+        }
+    }
+    return out;
+}
+
+QString NetworkTelemetry::summary() const
+{
+    qint64 requests = 0;
+    qint64 failed = 0;
+    qint64 retries = 0;
+    Histogram ttfb;
+    Histogram connect;
+    for (auto it = m_stats.constBegin(); it != m_stats.constEnd(); ++it) {
+        for (auto r = it->responses.constBegin(); r != it->responses.constEnd(); ++r) {
+            requests += r.value();
+            if (r.key() == "error" || r.key().toInt() >= 400)
+                failed += r.value();
+        }
+        retries += it->retries;
+        ttfb.count += it->phases[Ttfb].count;
+        ttfb.sum += it->phases[Ttfb].sum;
+        connect.count += it->phases[Connect].count;
+        connect.sum += it->phases[Connect].sum;
+    }
+    if (requests == 0)
+        return QString();
+
+    QString text = tr("%1 req, %2 failed, TTFB %3 ms")
+                       .arg(requests)
+                       .arg(failed)
+                       .arg(ttfb.mean(), 0, 'f', 0);
+    if (connect.count > 0)
+        text += tr(", TLS connect %1 ms").arg(connect.mean(), 0, 'f', 0);
+    const qint64 refreshes = m_stats.value("refresh").phases[Total].count;
+    return text + tr(", %1 retries, %2 refreshes").arg(retries).arg(refreshes);
+}
@@ -0,0 +1,119 @@
+/**
+ * @file NetworkTelemetry.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief per-request timings and byte counts, aggregated into histograms
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QMap>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <array>
+
+class TlsSessionCache;
+
+/*
+ * Phasen eines Requests (ms, soweit QNetworkReply sie meldet):
+ *   queued   Erzeugung bis Verbindungsaufbau (Warten auf einen freien Slot pro Host)
+ *   connect  Verbindungsaufbau bis TLS fertig (DNS + TCP + TLS, nur bei https)
+ *   send     bis Request inkl. Body gesendet ist
+ *   ttfb     Request gesendet bis Antwort-Header da (Serverzeit)
+ *   receive  Antwort-Header bis Ende
+ *   total    Erzeugung bis Ende
+ * Wiederverwendete keep-alive Verbindungen haben kein queued/connect.
+ */
+class NetworkTelemetry : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Phase { Queued, Connect, Send, Ttfb, Receive, Total, PhaseCount };
+
+    // Feste Bucket-Grenzen in ms: Speicher bleibt konstant, egal wie viele Requests
+    static constexpr std::array<double, 13> Buckets
+        = {5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000, 60000};
+
+    struct Histogram
+    {
+        std::array<qint64, Buckets.size() + 1> counts{}; // letzter Bucket: +Inf
+        qint64 count = 0;
+        double sum = 0.0;
+
+        void add(double ms);
+        double mean() const;
+    };
+
+    struct KindStats
+    {
+        QMap<QString, qint64> responses; // HTTP Status (oder "error") -> Anzahl
+        qint64 bytesSent = 0;
+        qint64 bytesReceived = 0;
+        qint64 retries = 0;
+        qint64 http2 = 0; // über HTTP/2 (per ALPN ausgehandelt)
+        std::array<Histogram, PhaseCount> phases;
+    };
+
+    explicit NetworkTelemetry(QObject *parent = nullptr);
+
+    // QNetworkAccessManager, dessen Replies automatisch erfasst werden.
+    // Mit sessions bekommt jeder https Request das gespeicherte TLS Session Ticket.
+    static QNetworkAccessManager *createManager(NetworkTelemetry *telemetry,
+                                                TlsSessionCache *sessions = nullptr,
+                                                QObject *parent = nullptr);
+    void watch(QNetworkReply *reply);
+
+    // Einmalige Messwerte beim Start (z.B. Zeit bis zum ersten Login), in ms
+    void recordStartup(const QString &name, double ms);
+
+    // Metriken regelmäßig schreiben: *.json als JSON, sonst Prometheus Text-Format
+    void setExportFile(const QString &filePath, int intervalMs = 10000);
+    QString exportFile() const;
+    bool exportNow() const;
+
+    QJsonObject toJson() const;
+    QByteArray toPrometheus() const;
+    // Kurzfassung für die Statusleiste
+    QString summary() const;
+
+    static QString phaseName(Phase phase);
+
+signals:
+    void requestFinished(const QString &kind, int status, qint64 totalMs);
+
+private:
+    struct Trace
+    {
+        QString kind;
+        int attempt = 0;
+        qint64 created = -1;
+        qint64 connecting = -1;
+        qint64 encrypted = -1;
+        qint64 sent = -1;
+        qint64 firstByte = -1;
+        qint64 bytesSent = 0;
+        qint64 bytesReceived = 0;
+    };
+
+    static QString kindOf(const QNetworkRequest &request);
+    qint64 now() const;
+    void onFinished(QNetworkReply *reply);
+
+    QElapsedTimer m_clock;
+    QHash<QNetworkReply *, Trace> m_traces;
+    QMap<QString, KindStats> m_stats;
+    QMap<QString, double> m_startup;
+    QTimer m_exportTimer;
+    QString m_exportFile;
+};
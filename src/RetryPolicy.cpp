@@ -0,0 +1,124 @@
+#include "RetryPolicy.h"
+
+#include <QDateTime>
+#include <QLocale>
+#include <QNetworkRequest>
+#include <QRandomGenerator>
+#include <QTimeZone>
+#include <QUuid>
+
+#include <algorithm>
+
+namespace {
+constexpr auto AttemptAttribute = static_cast<QNetworkRequest::Attribute>(QNetworkRequest::User + 1);
+}
+
+bool RetryPolicy::isRetryable(const QNetworkReply *reply)
+{
+    if (reply->property(TimedOutProperty).toBool())
+        return true;
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status > 0)
+        return status == 408 || status == 429 || status == 502 || status == 503 || status == 504;
+
+    switch (reply->error()) {
+    case QNetworkReply::ConnectionRefusedError: // Server startet gerade neu
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::ProxyConnectionClosedError:
+    case QNetworkReply::ProxyTimeoutError:
+    case QNetworkReply::UnknownNetworkError:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool RetryPolicy::isUnreachable(const QNetworkReply *reply)
+{
+    if (reply->property(TimedOutProperty).toBool())
+        return true;
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status > 0)
+        return status == 502 || status == 504;
+
+    switch (reply->error()) {
+    case QNetworkReply::ConnectionRefusedError:
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+        return true;
+    default:
+        return false;
+    }
+}
+
+qint64 RetryPolicy::retryAfterMs(const QNetworkReply *reply)
+{
+    const QByteArray value = reply->rawHeader("Retry-After").trimmed();
+    if (value.isEmpty())
+        return -1;
+
+    bool ok = false;
+    const qint64 seconds = value.toLongLong(&ok);
+    if (ok)
+        return seconds >= 0 ? seconds * 1000 : -1;
+
+    // HTTP-Datum, z.B. "Wed, 21 Oct 2026 07:28:00 GMT"
+    const QDateTime at = QLocale::c().toDateTime(QString::fromLatin1(value.left(25)),
+                                                 "ddd, dd MMM yyyy HH:mm:ss");
+    if (!at.isValid())
+        return -1;
+    const QDateTime utc(at.date(), at.time(), QTimeZone::utc());
+    return std::max<qint64>(0, QDateTime::currentDateTimeUtc().msecsTo(utc));
+}
+
+int RetryPolicy::delayMs(int retry, const QNetworkReply *reply)
+{
+    QRandomGenerator *random = QRandomGenerator::global();
+    if (reply) {
+        const qint64 retryAfter = retryAfterMs(reply);
+        if (retryAfter >= 0) {
+            // Etwas Streuung, damit nicht alle abgewiesenen Clients in derselben ms zurückkommen
+            const qint64 capped = std::min<qint64>(retryAfter, MaxRetryAfterMs);
+            return int(capped + random->bounded(int(capped / 10) + 1));
+        }
+    }
+
+    const int exponent = std::clamp(retry - 1, 0, 16);
+    const int cap = int(std::min<qint64>(MaxDelayMs, qint64(BaseDelayMs) << exponent));
+    return cap / 2 + random->bounded(cap / 2 + 1);
+}
+
+QString RetryPolicy::reason(const QNetworkReply *reply)
+{
+    if (reply->property(TimedOutProperty).toBool())
+        return QStringLiteral("Timeout (no data)");
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status > 0) {
+        const QString phrase = reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toString();
+        return phrase.isEmpty() ? QString::number(status) : QString("%1 %2").arg(status).arg(phrase);
+    }
+    return reply->errorString();
+}
+
+void RetryPolicy::markAttempt(QNetworkRequest &request, int attempt)
+{
+    if (attempt > 0)
+        request.setAttribute(AttemptAttribute, attempt);
+}
+
+int RetryPolicy::attempt(const QNetworkReply *reply)
+{
+    return reply->request().attribute(AttemptAttribute).toInt();
+}
+
+QByteArray RetryPolicy::newKey()
+{
+    return QUuid::createUuid().toByteArray(QUuid::WithoutBraces);
+}
@@ -0,0 +1,60 @@
+/**
+ * @file RetryPolicy.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief retryable vs. fatal network errors, capped exponential backoff with jitter, idempotency keys
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QString>
+
+namespace RetryPolicy {
+
+// Wiederholungen nach dem ersten Versuch
+constexpr int MaxRetries = 5;
+constexpr int BaseDelayMs = 500;
+constexpr int MaxDelayMs = 30000;
+// Längeres Retry-After vom Server wird gedeckelt, sonst hängt die Queue minutenlang
+constexpr int MaxRetryAfterMs = 120000;
+
+// Der Server verwirft Requests mit bereits bekanntem Schlüssel (z.B. nach einem Retry,
+// dessen erster Versuch doch angekommen ist) und liefert die erste Antwort erneut
+inline constexpr char IdempotencyHeader[] = "Idempotency-Key";
+
+// Dynamische Property am Reply: der Client hat wegen Inaktivität abgebrochen (NetworkCall)
+inline constexpr char TimedOutProperty[] = "crowTimedOut";
+
+// Vorübergehend: Timeout (auch der eigene, siehe TimedOutProperty), Verbindungsabbruch/-verweigerung, 408, 429, 502, 503, 504.
+// Alles andere (übrige 4xx, 500, TLS, Dateifehler) ist endgültig; 401 behandelt der Aufrufer.
+bool isRetryable(const QNetworkReply *reply);
+
+// Der Knoten selbst ist weg bzw. hängt: eigener Timeout, Verbindung verweigert/abgebrochen, 502, 504.
+// Überlast (429, 503) gehört nicht dazu, darauf reagiert der ConcurrencyController.
+bool isUnreachable(const QNetworkReply *reply);
+
+// Retry-After (Sekunden oder HTTP-Datum) in ms, -1 ohne gültigen Header
+qint64 retryAfterMs(const QNetworkReply *reply);
+
+// Wartezeit vor Wiederholung retry (1, 2, ...): min(MaxDelayMs, BaseDelayMs * 2^(retry-1)),
+// davon die obere Hälfte zufällig ("equal jitter"), damit nicht alle gleichzeitig wiederkommen.
+// Ein Retry-After des Servers hat Vorrang.
+int delayMs(int retry, const QNetworkReply *reply = nullptr);
+
+// Kurzer Grund für das Log, z.B. "503 Service Unavailable" oder "Connection closed"
+QString reason(const QNetworkReply *reply);
+
+// Wiederholungen tragen ihre Nummer (1, 2, ...) als Request-Attribut, für die Telemetrie
+void markAttempt(QNetworkRequest &request, int attempt);
+int attempt(const QNetworkReply *reply);
+
+// Neuer zufälliger Schlüssel für den Idempotency-Key Header
+QByteArray newKey();
+
+} // namespace RetryPolicy
@@ -0,0 +1,63 @@
+#include "RotatingLogFile.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+#include <algorithm>
+
+RotatingLogFile::RotatingLogFile(const QString &filePath, qint64 maxSize, int backups)
+    : m_file(filePath)
+    , m_maxSize(std::max<qint64>(maxSize, 64 * 1024))
+    , m_backups(std::max(backups, 1))
+{}
+
+QString RotatingLogFile::defaultLocation()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/logs/upload.log";
+}
+
+QString RotatingLogFile::filePath() const
+{
+    return m_file.fileName();
+}
+
+bool RotatingLogFile::open()
+{
+    if (m_file.isOpen())
+        return true;
+    QDir().mkpath(QFileInfo(m_file.fileName()).absolutePath());
+    return m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+}
+
+bool RotatingLogFile::write(const QStringList &lines)
+{
+    if (lines.isEmpty())
+        return true;
+
+    QByteArray data;
+    for (const QString &line : lines)
+        data += line.toUtf8() + '\n';
+
+    if (!open())
+        return false;
+    if (m_file.size() > 0 && m_file.size() + data.size() > m_maxSize) {
+        rotate();
+        if (!open())
+            return false;
+    }
+    const bool ok = m_file.write(data) == data.size();
+    m_file.flush();
+    return ok;
+}
+
+void RotatingLogFile::rotate()
+{
+    // name.log -> name.log.1 -> ... -> name.log.n, die älteste fällt weg
+    m_file.close();
+    const QString base = m_file.fileName();
+    QFile::remove(base + "." + QString::number(m_backups));
+    for (int i = m_backups - 1; i >= 1; --i)
+        QFile::rename(base + "." + QString::number(i), base + "." + QString::number(i + 1));
+    QFile::rename(base, base + ".1");
+}
@@ -0,0 +1,40 @@
+/**
+ * @file RotatingLogFile.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief append-only log file, rotated to name.1 .. name.n at a size limit
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+
+class RotatingLogFile
+{
+public:
+    static constexpr qint64 DefaultMaxSize = 4 * 1024 * 1024;
+    static constexpr int DefaultBackups = 3;
+
+    explicit RotatingLogFile(const QString &filePath,
+                             qint64 maxSize = DefaultMaxSize,
+                             int backups = DefaultBackups);
+
+    static QString defaultLocation();
+
+    // Hängt die Zeilen in einem write() an, rotiert vorher, wenn die Grenze überschritten wäre
+    bool write(const QStringList &lines);
+    QString filePath() const;
+
+private:
+    bool open();
+    void rotate();
+
+    QFile m_file;
+    qint64 m_maxSize;
+    int m_backups;
+};
@@ -0,0 +1,253 @@
+#include "ServerPool.h"
+#include "NetworkCall.h"
+#include "RetryPolicy.h"
+
+#include <QNetworkRequest>
+#include <QUrl>
+
+namespace {
+// Gewicht der neuen Messung im gleitenden Mittel; einzelne Ausreißer schalten nicht um
+constexpr double LATENCY_WEIGHT = 0.3;
+} // namespace
+
+ServerPool::ServerPool(QObject *parent)
+    : QObject(parent)
+    , m_probeManager(new QNetworkAccessManager(this))
+{
+    m_clock.start();
+    m_probeTimer.setInterval(DefaultProbeIntervalMs);
+    connect(&m_probeTimer, &QTimer::timeout, this, &ServerPool::probeNow);
+}
+
+ServerPool::Server ServerPool::parse(const QString &spec)
+{
+    Server server;
+    QString text = spec.trimmed();
+
+    // "name=" nur vor dem Schema, '=' kann auch in der Query stehen
+    const qsizetype equals = text.indexOf('=');
+    const qsizetype scheme = text.indexOf("://");
+    if (equals > 0 && (scheme < 0 || equals < scheme)) {
+        server.name = text.left(equals).trimmed();
+        text = text.mid(equals + 1).trimmed();
+    }
+
+    QUrl url(text);
+    server.username = url.userName();
+    server.password = url.password();
+    url.setUserInfo(QString());
+    server.url = url.toString(QUrl::StripTrailingSlash);
+    if (server.name.isEmpty())
+        server.name = url.port() > 0 ? QString("%1:%2").arg(url.host()).arg(url.port()) : url.host();
+    if (server.name.isEmpty())
+        server.name = server.url;
+    return server;
+}
+
+QString ServerPool::format(const Server &server)
+{
+    QUrl url(server.url);
+    url.setUserName(server.username);
+    return server.name + "=" + url.toString();
+}
+
+void ServerPool::setServers(const QList<Server> &servers)
+{
+    // Der aktive Knoten bleibt aktiv, wenn er weiterhin dabei ist
+    const QString current = activeUrl();
+    m_servers = servers;
+    m_active = 0;
+    for (int index = 0; index < m_servers.size(); ++index) {
+        if (m_servers.at(index).url == current)
+            m_active = index;
+    }
+
+    ++m_round;
+    m_outstanding = 0;
+    m_probed = false;
+    if (m_servers.size() > 1 && m_probeTimer.interval() > 0)
+        m_probeTimer.start();
+    else
+        m_probeTimer.stop();
+    probeNow();
+}
+
+QList<ServerPool::Server> ServerPool::servers() const
+{
+    return m_servers;
+}
+
+int ServerPool::count() const
+{
+    return m_servers.size();
+}
+
+ServerPool::Server ServerPool::server(int index) const
+{
+    return m_servers.value(index);
+}
+
+int ServerPool::indexOf(const QString &requestUrl) const
+{
+    int found = -1;
+    qsizetype length = 0;
+    for (int index = 0; index < m_servers.size(); ++index) {
+        const QString &url = m_servers.at(index).url;
+        if (url.size() > length && requestUrl.startsWith(url)) {
+            found = index;
+            length = url.size();
+        }
+    }
+    return found;
+}
+
+int ServerPool::activeIndex() const
+{
+    return m_active;
+}
+
+ServerPool::Server ServerPool::active() const
+{
+    return m_servers.value(m_active);
+}
+
+QString ServerPool::activeUrl() const
+{
+    return m_servers.value(m_active).url;
+}
+
+void ServerPool::setProbeInterval(int ms)
+{
+    m_probeTimer.setInterval(ms);
+    if (ms > 0 && m_servers.size() > 1)
+        m_probeTimer.start();
+    else
+        m_probeTimer.stop();
+}
+
+bool ServerPool::hasProbed() const
+{
+    return m_probed || m_servers.size() < 2;
+}
+
+void ServerPool::probeNow()
+{
+    // Ein einzelner Knoten hat keine Alternative; laufende Runde nicht überholen
+    if (m_servers.size() < 2 || m_outstanding > 0)
+        return;
+
+    const quint64 round = ++m_round;
+    m_outstanding = m_servers.size();
+    for (int index = 0; index < m_servers.size(); ++index) {
+        QNetworkRequest request(QUrl(m_servers.at(index).url + "/health"));
+        request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+
+        const qint64 sentAt = m_clock.nsecsElapsed();
+        NetworkCall *call = NetworkCall::get(m_probeManager,
+                                             request,
+                                             this,
+                                             [this, index, round, sentAt](QNetworkReply *reply) {
+                                                 const int status = reply->attribute(
+                                                                             QNetworkRequest::HttpStatusCodeAttribute)
+                                                                        .toInt();
+                                                 const bool ok = status > 0 && status < 500;
+                                                 onProbe(index,
+                                                         round,
+                                                         ok,
+                                                         (m_clock.nsecsElapsed() - sentAt) / 1e6,
+                                                         ok ? QString() : RetryPolicy::reason(reply));
+                                             });
+        call->setTimeout(ProbeTimeoutMs);
+    }
+}
+
+void ServerPool::onProbe(int index, quint64 round, bool ok, double latencyMs, const QString &error)
+{
+    if (round != m_round || index >= m_servers.size())
+        return;
+
+    Server &server = m_servers[index];
+    if (ok) {
+        server.healthy = true;
+        server.failures = 0;
+        server.lastError.clear();
+        server.latencyMs = server.latencyMs < 0
+                               ? latencyMs
+                               : LATENCY_WEIGHT * latencyMs + (1 - LATENCY_WEIGHT) * server.latencyMs;
+    } else {
+        server.healthy = false;
+        ++server.failures;
+        server.lastError = error;
+    }
+
+    if (--m_outstanding > 0)
+        return;
+    evaluate();
+    m_probed = true;
+    emit probed();
+}
+
+void ServerPool::evaluate()
+{
+    const int best = bestIndex();
+    if (best < 0 || best == m_active)
+        return; // keiner erreichbar: beim aktiven bleiben, die Uploads wiederholen ohnehin
+
+    const Server &current = m_servers.at(m_active);
+    const Server &candidate = m_servers.at(best);
+    if (!current.healthy) {
+        switchTo(best, tr("%1 unreachable (%2)").arg(current.name, current.lastError));
+    } else if (!m_probed) {
+        // Erste Runde: einfach den schnellsten nehmen
+        switchTo(best, tr("lowest latency (%1 ms)").arg(candidate.latencyMs, 0, 'f', 1));
+    } else if (current.latencyMs > candidate.latencyMs * SlowFactor
+               && current.latencyMs - candidate.latencyMs > SlowMarginMs) {
+        switchTo(best,
+                 tr("%1 slow (%2 ms vs. %3 ms)")
+                     .arg(current.name)
+                     .arg(current.latencyMs, 0, 'f', 1)
+                     .arg(candidate.latencyMs, 0, 'f', 1));
+    }
+}
+
+int ServerPool::bestIndex() const
+{
+    int best = -1;
+    for (int index = 0; index < m_servers.size(); ++index) {
+        const Server &server = m_servers.at(index);
+        if (!server.healthy)
+            continue;
+        if (best < 0) {
+            best = index;
+            continue;
+        }
+        const double latency = m_servers.at(best).latencyMs;
+        if (server.latencyMs >= 0 && (latency < 0 || server.latencyMs < latency))
+            best = index;
+    }
+    return best;
+}
+
+void ServerPool::reportFailure(const QString &requestUrl, const QString &reason)
+{
+    const int index = indexOf(requestUrl);
+    if (index < 0)
+        return;
+
+    Server &server = m_servers[index];
+    server.healthy = false;
+    ++server.failures;
+    server.lastError = reason;
+    if (index != m_active)
+        return;
+
+    const int best = bestIndex();
+    if (best >= 0)
+        switchTo(best, tr("%1 failed (%2)").arg(server.name, reason));
+}
+
+void ServerPool::switchTo(int index, const QString &reason)
+{
+    m_active = index;
+    emit activeChanged(index, reason);
+}
@@ -0,0 +1,102 @@
+/**
+ * @file ServerPool.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief several Crow ingest nodes: health/latency probes, choice of the fastest healthy node, failover
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+/*
+ * Profile als Text, eins pro Zeile bzw. --server Option:
+ *   [name=]http[s]://[user[:password]@]host:port
+ * Ohne Benutzer gelten die Zugangsdaten des Logins.
+ *
+ * Probe: GET <url>/health mit kurzem Timeout über einen eigenen Manager, damit sie
+ * nicht hinter laufenden Uploads auf einen freien Slot wartet. Jede HTTP-Antwort
+ * unter 500 zählt als erreichbar (auch 404 eines Servers ohne /health).
+ */
+class ServerPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Server
+    {
+        QString name;
+        QString url;      // ohne Benutzerdaten, z.B. "http://127.0.0.1:8081"
+        QString username; // leer = Zugangsdaten des Logins
+        QString password; // wird nicht gespeichert (format())
+
+        // Laufzeit
+        bool healthy = true;   // bis zur ersten Probe als erreichbar angenommen
+        double latencyMs = -1; // geglättet, -1 = noch nicht gemessen
+        int failures = 0;      // Fehler seit der letzten erfolgreichen Probe
+        QString lastError;
+    };
+
+    static constexpr int DefaultProbeIntervalMs = 15000;
+    static constexpr int ProbeTimeoutMs = 3000;
+    // Wechsel wegen Latenz erst, wenn der aktive Knoten deutlich langsamer ist
+    static constexpr double SlowFactor = 3.0;
+    static constexpr double SlowMarginMs = 100.0;
+
+    explicit ServerPool(QObject *parent = nullptr);
+
+    static Server parse(const QString &spec);
+    // Ohne Passwort, z.B. für QSettings
+    static QString format(const Server &server);
+
+    // Setzt den aktiven Knoten auf den ersten; Proben laufen bei mehr als einem Knoten
+    void setServers(const QList<Server> &servers);
+    QList<Server> servers() const;
+    int count() const;
+    Server server(int index) const;
+    // Knoten, zu dem requestUrl gehört (längster passender Präfix), -1 = keiner
+    int indexOf(const QString &requestUrl) const;
+
+    int activeIndex() const;
+    Server active() const;
+    QString activeUrl() const;
+
+    // 0 = keine periodischen Proben
+    void setProbeInterval(int ms);
+    void probeNow();
+    // Mindestens eine vollständige Probenrunde: die erste Wahl ist getroffen
+    bool hasProbed() const;
+
+    // Verbindungsfehler/Timeout/502/504 im Upload-Verkehr: Knoten sofort als down markieren
+    // und, falls es der aktive war, auf den besten erreichbaren wechseln
+    void reportFailure(const QString &requestUrl, const QString &reason);
+
+signals:
+    void activeChanged(int index, const QString &reason);
+    // Eine Probenrunde ist fertig (alle Knoten haben geantwortet oder den Timeout erreicht)
+    void probed();
+
+private:
+    void onProbe(int index, quint64 round, bool ok, double latencyMs, const QString &error);
+    void evaluate();
+    // Erreichbarer Knoten mit der geringsten Latenz (ungemessen zählt als langsam), -1 = keiner
+    int bestIndex() const;
+    void switchTo(int index, const QString &reason);
+
+    QNetworkAccessManager *m_probeManager;
+    QTimer m_probeTimer;
+    QElapsedTimer m_clock; // Latenz der Proben
+    QList<Server> m_servers;
+    int m_active = 0;
+    quint64 m_round = 0; // verwirft Antworten einer Runde vor setServers()
+    int m_outstanding = 0;
+    bool m_probed = false;
+};
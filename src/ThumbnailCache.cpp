@@ -0,0 +1,222 @@
+#include "ThumbnailCache.h"
+#include "ExifReader.h"
+#include "FileHasher.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <QTransform>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+
+namespace {
+constexpr qint64 SampleSize = 64 * 1024;
+constexpr int DiskQuality = 85;
+
+// Schlüssel für den Disk-Cache: Größe plus Anfang und Ende des Inhalts. Liest höchstens
+// 128 KiB statt der ganzen Datei, erkennt aber Umbenennen/Verschieben als gleichen Inhalt.
+QByteArray contentKey(const QString &filePath, int edge)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+
+    const qint64 size = file.size();
+    QCryptographicHash hash(FileHasher::Algorithm);
+    hash.addData(QByteArray::number(size));
+    hash.addData(file.read(SampleSize));
+    if (size > 2 * SampleSize && file.seek(size - SampleSize))
+        hash.addData(file.read(SampleSize));
+    return hash.result().toHex().left(32) + '-' + QByteArray::number(edge);
+}
+
+// EXIF-Orientierung auf das eingebettete Vorschaubild anwenden (das Hauptbild macht
+// QImageReader::setAutoTransform), Reihenfolge wie in Qt: spiegeln, dann drehen
+QImage applyTransformation(QImage image, QImageIOHandler::Transformations transformation)
+{
+    if (transformation & QImageIOHandler::TransformationMirror)
+        image = image.mirrored(true, false);
+    if (transformation & QImageIOHandler::TransformationFlip)
+        image = image.mirrored(false, true);
+    if (transformation & QImageIOHandler::TransformationRotate90)
+        image = image.transformed(QTransform().rotate(90));
+    return image;
+}
+
+QImage fitInto(const QImage &image, int edge)
+{
+    if (image.width() <= edge && image.height() <= edge)
+        return image;
+    return image.scaled(edge, edge, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+}
+} // namespace
+
+ThumbnailCache::ThumbnailCache(QObject *parent)
+    : QObject(parent)
+{
+    // Die Upload-Pools sollen nicht warten, Thumbnails sind nur Komfort
+    m_pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2));
+    setMemoryLimit(DefaultMemoryLimit);
+}
+
+ThumbnailCache::~ThumbnailCache()
+{
+    m_pending.clear();
+    m_pool.waitForDone();
+}
+
+QString ThumbnailCache::defaultDiskCache()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbnails";
+}
+
+void ThumbnailCache::setMemoryLimit(qint64 bytes)
+{
+    m_cache.setMaxCost(std::max<qint64>(bytes / 1024, 1));
+}
+
+qint64 ThumbnailCache::memoryLimit() const
+{
+    return m_cache.maxCost() * 1024;
+}
+
+qint64 ThumbnailCache::memoryUsed() const
+{
+    return m_cache.totalCost() * 1024;
+}
+
+void ThumbnailCache::setDiskCache(const QString &dir)
+{
+    m_diskCache = dir;
+    if (!dir.isEmpty())
+        QDir().mkpath(dir);
+}
+
+QString ThumbnailCache::diskCache() const
+{
+    return m_diskCache;
+}
+
+void ThumbnailCache::setEdge(int edge)
+{
+    if (edge == m_edge)
+        return;
+    m_edge = edge;
+    ++m_generation;
+    m_cache.clear();
+    m_failed.clear();
+    // Laufende Dekodierungen liefern noch die alte Größe, die werden verworfen
+    m_pending.clear();
+    m_requested.clear();
+}
+
+int ThumbnailCache::edge() const
+{
+    return m_edge;
+}
+
+QImage ThumbnailCache::thumbnail(const QString &filePath)
+{
+    // object() zählt als Zugriff und schiebt den Eintrag im LRU nach vorn
+    if (const QImage *image = m_cache.object(filePath))
+        return *image;
+    if (m_failed.contains(filePath))
+        return QImage();
+
+    if (m_requested.contains(filePath)) {
+        // Wieder sichtbar: nach vorn holen, falls noch nicht in Arbeit
+        if (m_pending.removeOne(filePath))
+            m_pending.append(filePath);
+        return QImage();
+    }
+
+    m_requested.insert(filePath);
+    m_pending.append(filePath);
+    if (m_pending.size() > MaxPending)
+        m_requested.remove(m_pending.takeFirst());
+    scheduleNext();
+    return QImage();
+}
+
+void ThumbnailCache::clearPending()
+{
+    for (const QString &filePath : std::as_const(m_pending))
+        m_requested.remove(filePath);
+    m_pending.clear();
+}
+
+void ThumbnailCache::scheduleNext()
+{
+    // Nur so viele wie Threads starten, damit die Reihenfolge bis zuletzt änderbar bleibt
+    while (m_running < m_pool.maxThreadCount() && !m_pending.isEmpty()) {
+        const QString filePath = m_pending.takeLast();
+        const quint64 generation = m_generation;
+        ++m_running;
+        QtConcurrent::run(&m_pool, &ThumbnailCache::decode, filePath, m_edge, m_diskCache)
+            .then(this, [this, filePath, generation](const QImage &image) {
+                --m_running;
+                if (generation == m_generation) {
+                    m_requested.remove(filePath);
+                    if (image.isNull()) {
+                        m_failed.insert(filePath);
+                    } else {
+                        m_cache.insert(filePath,
+                                       new QImage(image),
+                                       std::max<qsizetype>(image.sizeInBytes() / 1024, 1));
+                        emit thumbnailReady(filePath, image);
+                    }
+                }
+                scheduleNext();
+            });
+    }
+}
+
+QImage ThumbnailCache::decode(const QString &filePath, int edge, const QString &diskCache)
+{
+    QString cachePath;
+    if (!diskCache.isEmpty()) {
+        const QByteArray key = contentKey(filePath, edge);
+        if (!key.isEmpty()) {
+            cachePath = diskCache + "/" + QString::fromLatin1(key) + ".jpg";
+            QImage cached(cachePath);
+            if (!cached.isNull())
+                return cached;
+        }
+    }
+
+    QImageReader reader(filePath);
+    reader.setAutoTransform(true);
+    const QSize size = reader.size(); // nur Header
+    QImage image;
+
+    // Eingebettetes EXIF-Vorschaubild, wenn es für die Zielgröße reicht (meist 160x120)
+    const QByteArray exif = reader.format() == "jpeg" ? ExifReader::thumbnail(filePath) : QByteArray();
+    if (!exif.isEmpty()) {
+        const QImage preview = QImage::fromData(exif, "JPEG");
+        if (!preview.isNull() && std::max(preview.width(), preview.height()) >= edge)
+            image = applyTransformation(preview, reader.transformation());
+    }
+
+    if (image.isNull()) {
+        // JPEG dekodiert libjpeg direkt verkleinert, die volle Auflösung liegt nie im Speicher
+        if (size.isValid() && (size.width() > edge || size.height() > edge))
+            reader.setScaledSize(size.scaled(edge, edge, Qt::KeepAspectRatio));
+        image = reader.read();
+        if (image.isNull())
+            return QImage();
+    }
+    image = fitInto(image, edge);
+
+    if (!cachePath.isEmpty() && !image.hasAlphaChannel()) {
+        QSaveFile file(cachePath);
+        if (file.open(QIODevice::WriteOnly) && image.save(&file, "JPG", DiskQuality))
+            file.commit();
+    }
+    return image;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file ThumbnailCache.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief thumbnails decoded on worker threads, memory-bounded LRU and optional disk cache
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QCache>
+#include <QImage>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+
+/*
+ * thumbnail() antwortet sofort aus dem Speicher oder stellt die Datei in die Warteschlange.
+ * Die zuletzt angefragten Dateien (gerade sichtbar) werden zuerst dekodiert, weggescrollte
+ * Anfragen verfallen nach MaxPending. Dekodiert wird das EXIF-Vorschaubild, sonst per
+ * QImageReader direkt in Zielgröße.
+ */
+class ThumbnailCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DefaultEdge = 128;
+    static constexpr qint64 DefaultMemoryLimit = 64 * 1024 * 1024;
+    static constexpr int MaxPending = 512;
+
+    explicit ThumbnailCache(QObject *parent = nullptr);
+    ~ThumbnailCache() override;
+
+    static QString defaultDiskCache();
+
+    // Obergrenze für die dekodierten Bilder im Speicher, älteste fliegen zuerst raus
+    void setMemoryLimit(qint64 bytes);
+    qint64 memoryLimit() const;
+    qint64 memoryUsed() const;
+    // Verzeichnis für Thumbnails nach Inhalts-Hash (leer = aus)
+    void setDiskCache(const QString &dir);
+    QString diskCache() const;
+    // Längste Kante in Pixeln, verwirft den Speicher-Cache
+    void setEdge(int edge);
+    int edge() const;
+
+    // Leeres Bild: noch nicht da, thumbnailReady folgt (außer die Datei ist kein Bild)
+    QImage thumbnail(const QString &filePath);
+    // Noch nicht gestartete Anfragen verwerfen (z.B. bei neuer Auswahl)
+    void clearPending();
+
+    // Thread-safe, läuft im Worker-Pool
+    static QImage decode(const QString &filePath, int edge, const QString &diskCache);
+
+signals:
+    void thumbnailReady(const QString &filePath, const QImage &image);
+
+private:
+    void scheduleNext();
+
+    QCache<QString, QImage> m_cache; // Kosten in KiB
+    QList<QString> m_pending;        // LIFO: neueste Anfrage zuerst
+    QSet<QString> m_requested;       // wartend oder in Arbeit
+    QSet<QString> m_failed;
+    int m_running = 0;
+    int m_edge = DefaultEdge;
+    QString m_diskCache;
+    QThreadPool m_pool;
+    quint64 m_generation = 0; // Ergebnisse nach setEdge() verwerfen
+};
@@ -0,0 +1,81 @@
+#include "ThumbnailModel.h"
+#include "ThumbnailCache.h"
+
+#include <QFileInfo>
+
+ThumbnailModel::ThumbnailModel(ThumbnailCache *cache, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_cache(cache)
+{
+    updatePlaceholder();
+    connect(m_cache, &ThumbnailCache::thumbnailReady, this, &ThumbnailModel::onThumbnailReady);
+}
+
+void ThumbnailModel::setFiles(const QStringList &files)
+{
+    beginResetModel();
+    m_cache->clearPending();
+    updatePlaceholder();
+    m_files = files;
+    m_rows.clear();
+    m_rows.reserve(files.size());
+    for (int row = 0; row < files.size(); ++row)
+        m_rows.insert(files.at(row), row);
+    endResetModel();
+}
+
+void ThumbnailModel::append(const QString &filePath)
+{
+    const int row = static_cast<int>(m_files.size());
+    beginInsertRows(QModelIndex(), row, row);
+    m_files.append(filePath);
+    m_rows.insert(filePath, row);
+    endInsertRows();
+}
+
+QStringList ThumbnailModel::files() const
+{
+    return m_files;
+}
+
+int ThumbnailModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_files.size());
+}
+
+QVariant ThumbnailModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_files.size())
+        return QVariant();
+
+    const QString &filePath = m_files.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        return QFileInfo(filePath).fileName();
+    case Qt::ToolTipRole:
+        return filePath;
+    case Qt::DecorationRole: {
+        const QImage image = m_cache->thumbnail(filePath);
+        return image.isNull() ? m_placeholder : image;
+    }
+    default:
+        return QVariant();
+    }
+}
+
+void ThumbnailModel::onThumbnailReady(const QString &filePath)
+{
+    const auto it = m_rows.constFind(filePath);
+    if (it == m_rows.cend())
+        return;
+    const QModelIndex changed = index(*it);
+    emit dataChanged(changed, changed, {Qt::DecorationRole});
+}
+
+void ThumbnailModel::updatePlaceholder()
+{
+    if (m_placeholder.width() == m_cache->edge())
+        return;
+    m_placeholder = QImage(m_cache->edge(), m_cache->edge(), QImage::Format_ARGB32_Premultiplied);
+    m_placeholder.fill(Qt::transparent);
+}
@@ -0,0 +1,43 @@
+/**
+ * @file ThumbnailModel.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief list model for the thumbnail grid, images come lazily from ThumbnailCache
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QImage>
+#include <QStringList>
+
+class ThumbnailCache;
+
+// Fragt Thumbnails erst an, wenn die View sie zeichnen will (nur sichtbare Zeilen)
+class ThumbnailModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit ThumbnailModel(ThumbnailCache *cache, QObject *parent = nullptr);
+
+    void setFiles(const QStringList &files);
+    void append(const QString &filePath);
+    QStringList files() const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    void onThumbnailReady(const QString &filePath);
+    void updatePlaceholder();
+
+    ThumbnailCache *m_cache;
+    QStringList m_files;
+    QHash<QString, int> m_rows; // Pfad -> Zeile
+    QImage m_placeholder;       // hält die Zellen gleich groß, solange dekodiert wird
+};
@@ -0,0 +1,160 @@
+#include "TlsSessionCache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QUrl>
+
+namespace {
+constexpr quint32 SessionMagic = 0x4352544b; // "CRTK"
+constexpr quint32 SessionVersion = 1;
+// Ohne Lifetime Hint vom Server: konservativ eine Stunde (RFC 8446 erlaubt bis 7 Tage)
+constexpr qint64 DefaultLifetime = 3600;
+constexpr qint64 MaxLifetime = 7 * 24 * 3600;
+} // namespace
+
+TlsSessionCache::TlsSessionCache(const QString &fileName, QObject *parent)
+    : QObject(parent)
+    , m_fileName(fileName)
+{}
+
+TlsSessionCache::~TlsSessionCache()
+{
+    save();
+}
+
+QString TlsSessionCache::defaultLocation()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/tls-sessions.dat";
+}
+
+QString TlsSessionCache::key(const QString &host, int port)
+{
+    return host.toLower() + ':' + QString::number(port);
+}
+
+bool TlsSessionCache::load()
+{
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint64 count = 0;
+    in >> magic >> version >> count;
+    if (magic != SessionMagic || version != SessionVersion)
+        return false;
+
+    // Abgelaufene Tickets gar nicht erst übernehmen
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    m_entries.clear();
+    for (qint64 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString host;
+        Entry entry;
+        in >> host >> entry.ticket >> entry.expires;
+        if (in.status() == QDataStream::Ok && entry.expires > now)
+            m_entries.insert(host, entry);
+        else
+            m_dirty = true;
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+bool TlsSessionCache::save()
+{
+    if (!m_dirty)
+        return true;
+
+    QDir().mkpath(QFileInfo(m_fileName).absolutePath());
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+
+    QDataStream out(&file);
+    out << SessionMagic << SessionVersion << static_cast<qint64>(m_entries.size());
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it)
+        out << it.key() << it->ticket << it->expires;
+    if (!file.commit())
+        return false;
+
+    m_dirty = false;
+    return true;
+}
+
+qsizetype TlsSessionCache::count() const
+{
+    return m_entries.size();
+}
+
+#if QT_CONFIG(ssl)
+QSslConfiguration TlsSessionCache::configuration(const QString &host, int port) const
+{
+    QSslConfiguration config = QSslConfiguration::defaultConfiguration();
+    // Sonst liefert Qt kein Ticket heraus, das man speichern könnte
+    config.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+
+    const auto it = m_entries.constFind(key(host, port));
+    if (it != m_entries.constEnd() && it->expires > QDateTime::currentSecsSinceEpoch())
+        config.setSessionTicket(it->ticket);
+    return config;
+}
+#endif
+
+void TlsSessionCache::apply(QNetworkRequest &request) const
+{
+#if QT_CONFIG(ssl)
+    const QUrl url = request.url();
+    if (url.scheme() != "https")
+        return;
+
+    QSslConfiguration config = request.sslConfiguration();
+    config.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+    const auto it = m_entries.constFind(key(url.host(), url.port(443)));
+    if (it != m_entries.constEnd() && it->expires > QDateTime::currentSecsSinceEpoch())
+        config.setSessionTicket(it->ticket);
+    request.setSslConfiguration(config);
+#else
+    Q_UNUSED(request);
+#endif
+}
+
+void TlsSessionCache::watch(QNetworkReply *reply)
+{
+#if QT_CONFIG(ssl)
+    if (reply->url().scheme() == "https")
+        connect(reply, &QNetworkReply::finished, this, [this, reply]() { capture(reply); });
+#else
+    Q_UNUSED(reply);
+#endif
+}
+
+void TlsSessionCache::capture(QNetworkReply *reply)
+{
+#if QT_CONFIG(ssl)
+    const QSslConfiguration config = reply->sslConfiguration();
+    const QByteArray ticket = config.sessionTicket();
+    if (ticket.isEmpty())
+        return;
+
+    const QUrl url = reply->url();
+    Entry &entry = m_entries[key(url.host(), url.port(443))];
+    if (entry.ticket == ticket)
+        return;
+
+    const int hint = config.sessionTicketLifeTimeHint();
+    entry.ticket = ticket;
+    entry.expires = QDateTime::currentSecsSinceEpoch()
+                    + (hint > 0 ? qMin<qint64>(hint, MaxLifetime) : DefaultLifetime);
+    m_dirty = true;
+    // Selten (einmal pro Verbindung), deshalb direkt schreiben: ein Absturz verliert nichts
+    save();
+#else
+    Q_UNUSED(reply);
+#endif
+}
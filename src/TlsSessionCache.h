@@ -0,0 +1,66 @@
+/**
+ * @file TlsSessionCache.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief TLS session tickets per host, persisted across restarts for session resumption
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QObject>
+#include <QString>
+
+#if QT_CONFIG(ssl)
+#include <QSslConfiguration>
+#endif
+
+/*
+ * Der Server schickt nach dem Handshake ein Session Ticket. Wird es beim nächsten
+ * Start mitgegeben, reicht ein verkürzter Handshake (Resumption) statt des vollen.
+ * Innerhalb eines Laufs erledigt das Qt selbst, hier geht es um den Kaltstart.
+ * Tickets sind Geheimnisse: die Datei ist nur für den Benutzer lesbar.
+ */
+class TlsSessionCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TlsSessionCache(const QString &fileName = defaultLocation(), QObject *parent = nullptr);
+    ~TlsSessionCache() override;
+
+    static QString defaultLocation();
+
+    bool load();
+    bool save();
+
+    // Persistenz einschalten und ein noch gültiges Ticket für Host:Port mitgeben
+    void apply(QNetworkRequest &request) const;
+#if QT_CONFIG(ssl)
+    QSslConfiguration configuration(const QString &host, int port) const;
+#endif
+    // Neues Ticket aus der Antwort übernehmen, sobald sie fertig ist
+    void watch(QNetworkReply *reply);
+
+    qsizetype count() const;
+
+private:
+    struct Entry
+    {
+        QByteArray ticket;
+        qint64 expires = 0; // s seit Epoch
+    };
+
+    static QString key(const QString &host, int port);
+    void capture(QNetworkReply *reply);
+
+    QString m_fileName;
+    QHash<QString, Entry> m_entries;
+    bool m_dirty = false;
+};
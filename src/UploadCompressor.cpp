@@ -0,0 +1,128 @@
+#include "UploadCompressor.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QUuid>
+
+#include <algorithm>
+
+#include <zlib.h>
+
+namespace {
+constexpr qint64 SampleSize = 64 * 1024;
+constexpr qint64 MinFileSize = 16 * 1024;
+constexpr qint64 BlockSize = 256 * 1024;
+// Unter 10 % Ersparnis lohnt sich das Komprimieren nicht
+constexpr double MaxRatio = 0.9;
+
+const QStringList COMPRESSED_SUFFIXES = {"jpg", "jpeg", "png", "gif", "webp"};
+} // namespace
+
+bool UploadCompressor::isCompressible(const QString &filePath)
+{
+    const QFileInfo info(filePath);
+    if (COMPRESSED_SUFFIXES.contains(info.suffix().toLower()) || info.size() < MinFileSize)
+        return false;
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const qint64 size = file.size();
+    const qint64 offsets[] = {0, size / 2 - SampleSize / 2, size - SampleSize};
+
+    qint64 original = 0;
+    qint64 compressed = 0;
+    QByteArray output(compressBound(SampleSize), Qt::Uninitialized);
+    for (const qint64 offset : offsets) {
+        if (!file.seek(std::max<qint64>(0, offset)))
+            return false;
+        const QByteArray sample = file.read(SampleSize);
+        if (sample.isEmpty())
+            return false;
+
+        uLongf outputSize = static_cast<uLongf>(output.size());
+        if (compress2(reinterpret_cast<Bytef *>(output.data()),
+                      &outputSize,
+                      reinterpret_cast<const Bytef *>(sample.constData()),
+                      static_cast<uLong>(sample.size()),
+                      Z_BEST_SPEED)
+            != Z_OK) {
+            return false;
+        }
+        original += sample.size();
+        compressed += static_cast<qint64>(outputSize);
+    }
+    return compressed < original * MaxRatio;
+}
+
+UploadCompressor::Result UploadCompressor::compress(const QString &filePath, const QString &outputDir)
+{
+    Result result;
+    if (!isCompressible(filePath))
+        return result;
+
+    QFile input(filePath);
+    if (!input.open(QIODevice::ReadOnly)) {
+        result.error = input.errorString();
+        return result;
+    }
+    QFile output(outputDir + "/" + QUuid::createUuid().toString(QUuid::WithoutBraces) + ".gz");
+    if (!output.open(QIODevice::WriteOnly)) {
+        result.error = output.errorString();
+        return result;
+    }
+
+    // windowBits 15 + 16: gzip statt zlib Header, wie für Content-Encoding: gzip verlangt
+    z_stream stream{};
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        result.error = "deflateInit2 failed";
+        return result;
+    }
+
+    QByteArray in(BlockSize, Qt::Uninitialized);
+    QByteArray out(BlockSize, Qt::Uninitialized);
+    bool ok = true;
+    int flush = Z_NO_FLUSH;
+    while (ok && flush != Z_FINISH) {
+        const qint64 read = input.read(in.data(), in.size());
+        if (read < 0) {
+            result.error = input.errorString();
+            ok = false;
+            break;
+        }
+        flush = input.atEnd() || read == 0 ? Z_FINISH : Z_NO_FLUSH;
+        stream.next_in = reinterpret_cast<Bytef *>(in.data());
+        stream.avail_in = static_cast<uInt>(read);
+
+        // Ausgabe-Puffer leeren, bis der Block verarbeitet ist
+        do {
+            stream.next_out = reinterpret_cast<Bytef *>(out.data());
+            stream.avail_out = static_cast<uInt>(out.size());
+            if (deflate(&stream, flush) == Z_STREAM_ERROR) {
+                result.error = "deflate failed";
+                ok = false;
+                break;
+            }
+            const qint64 produced = out.size() - stream.avail_out;
+            if (output.write(out.constData(), produced) != produced) {
+                result.error = output.errorString();
+                ok = false;
+                break;
+            }
+        } while (stream.avail_out == 0);
+    }
+    deflateEnd(&stream);
+    output.close();
+
+    // Stichprobe war zu optimistisch: dann doch das Original senden
+    if (!ok || output.size() >= input.size() * MaxRatio) {
+        output.remove();
+        return result;
+    }
+
+    result.compressed = true;
+    result.outputPath = output.fileName();
+    result.size = output.size();
+    return result;
+}
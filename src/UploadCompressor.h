@@ -0,0 +1,37 @@
+/**
+ * @file UploadCompressor.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief gzip compression of compressible uploads (uncompressed BMP/TIFF scans)
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+namespace UploadCompressor {
+
+// Wert für den Content-Encoding Header des Datei-Parts bzw. "contentEncoding" im Chunked Upload
+inline const QByteArray Encoding = "gzip";
+
+struct Result
+{
+    bool compressed = false; // false: Original hochladen
+    QString outputPath;
+    qint64 size = 0;
+    QString error;
+};
+
+// Schnelltest: bereits komprimierte Formate (JPEG, PNG, GIF, WebP) anhand der Endung,
+// sonst je 64 KiB vom Anfang, aus der Mitte und vom Ende mit schneller Stufe komprimieren.
+bool isCompressible(const QString &filePath);
+
+// Komprimiert gzip-kodiert nach outputDir, gelesen und geschrieben in festen Blöcken.
+// Thread-safe, läuft im Worker-Pool der Upload Queue.
+Result compress(const QString &filePath, const QString &outputDir);
+
+} // namespace UploadCompressor
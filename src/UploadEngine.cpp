@@ -0,0 +1,568 @@
+#include "UploadEngine.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkRequest>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace {
+// Refresh so viele Sekunden vor Ablauf des Access Tokens
+constexpr qint64 REFRESH_LEAD_TIME = 60;
+// Requests mit weniger Restlaufzeit warten auf den Refresh
+constexpr qint64 TOKEN_EXPIRY_MARGIN = 15;
+
+// "exp" Claim aus dem Payload des JWT lesen (ohne Signaturprüfung, das macht der Server)
+QDateTime jwtExpiry(const QString &token)
+{
+    const QStringList parts = token.split('.');
+    if (parts.size() < 2)
+        return QDateTime();
+
+    const QByteArray payload = QByteArray::fromBase64(parts.at(1).toLatin1(),
+                                                      QByteArray::Base64UrlEncoding);
+    const QJsonValue exp = QJsonDocument::fromJson(payload).object().value("exp");
+    if (!exp.isDouble())
+        return QDateTime();
+    return QDateTime::fromSecsSinceEpoch(exp.toInteger());
+}
+} // namespace
+
+UploadEngine::UploadEngine(QObject *parent)
+    : UploadEngine(UploadIndex::defaultLocation(), parent)
+{}
+
+UploadEngine::UploadEngine(const QString &indexFile, QObject *parent)
+    : QObject(parent)
+    , m_telemetry(new NetworkTelemetry(this))
+    , m_tlsSessions(new TlsSessionCache(TlsSessionCache::defaultLocation(), this))
+    , m_netManager(NetworkTelemetry::createManager(m_telemetry, m_tlsSessions, this))
+    , m_uploadQueue(new UploadQueue(m_netManager, this))
+    , m_uploadIndex(indexFile)
+    , m_folderSync(new FolderSync(m_netManager, &m_uploadIndex, this))
+    , m_servers(new ServerPool(this))
+    , m_refreshTimer(new QTimer(this))
+{
+    m_startClock.start();
+    m_tlsSessions->load();
+    m_uploadQueue->setServerUrl(m_serverUrl);
+    m_servers->setServers({ServerPool::parse(m_serverUrl)});
+    m_uploadQueue->setDispatcher(
+        [this](const Authorization::Call &call) { sendAuthorized(call); });
+    m_uploadIndex.load();
+    m_folderSync->setDispatcher([this](const Authorization::Call &call) { sendAuthorized(call); });
+    connect(m_folderSync, &FolderSync::finished, this, [this](const FolderSync::Result &result) {
+        if (!result.error.isEmpty()) {
+            emit message("Sync failed: " + result.error);
+            emit syncFinished(0, 0, result.error);
+            return;
+        }
+        enqueue(result.upload, result.root, result.serverPath);
+        emit message(QString("Sync %1: %2 new, %3 changed, %4 unchanged (%5 ms)")
+                         .arg(result.root)
+                         .arg(result.added)
+                         .arg(result.changed)
+                         .arg(result.unchanged)
+                         .arg(result.elapsedMs));
+        emit syncFinished(result.upload.size(), result.unchanged, QString());
+    });
+
+    m_refreshTimer->setSingleShot(true);
+    connect(m_refreshTimer, &QTimer::timeout, this, [this]() {
+        if (!m_refreshToken.isEmpty()) {
+            emit message("Access Token expires soon. Refreshing...");
+            performTokenRefresh();
+        }
+    });
+
+    connect(m_uploadQueue,
+            &UploadQueue::itemRetrying,
+            this,
+            [this](int index, int retry, int delayMs, const QString &reason) {
+                emit message(QString("Retry %1/%2 in %3 ms: %4 (%5)")
+                                 .arg(retry)
+                                 .arg(UploadQueue::MaxRetries)
+                                 .arg(delayMs)
+                                 .arg(QFileInfo(m_uploadQueue->item(index).filePath).fileName(), reason));
+            });
+    connect(m_uploadQueue,
+            &UploadQueue::authenticationRequired,
+            this,
+            &UploadEngine::onQueueAuthenticationRequired);
+
+    // Failover: der Pool entscheidet, die Engine zieht Queue, Sync und Tokens nach
+    connect(m_uploadQueue, &UploadQueue::serverUnreachable, m_servers, &ServerPool::reportFailure);
+    connect(m_servers, &ServerPool::activeChanged, this, [this](int index, const QString &reason) {
+        const ServerPool::Server server = m_servers->server(index);
+        emit message(QString("Switching to server %1 (%2): %3").arg(server.name, server.url, reason));
+        useServer(server.url);
+        prewarm();
+        emit serverChanged(server.name, server.url, reason);
+    });
+}
+
+UploadEngine::~UploadEngine()
+{
+    m_uploadIndex.save();
+    m_telemetry->exportNow();
+}
+
+void UploadEngine::setServerUrl(const QString &url)
+{
+    setServers({ServerPool::parse(url)});
+}
+
+void UploadEngine::setServers(const QList<ServerPool::Server> &servers)
+{
+    if (servers.isEmpty())
+        return;
+    m_servers->setServers(servers);
+    useServer(m_servers->activeUrl());
+}
+
+ServerPool *UploadEngine::servers() const
+{
+    return m_servers;
+}
+
+QString UploadEngine::serverUrl() const
+{
+    return m_serverUrl;
+}
+
+void UploadEngine::prewarm()
+{
+    const QUrl url(m_serverUrl);
+    if (!url.isValid() || url.host().isEmpty())
+        return;
+
+    // Die Verbindung landet im Pool des Managers, der erste Request übernimmt sie
+    if (url.scheme() == "https") {
+#if QT_CONFIG(ssl)
+        QSslConfiguration config = m_tlsSessions->configuration(url.host(), url.port(443));
+        config.setAllowedNextProtocols({QSslConfiguration::ALPNProtocolHTTP2,
+                                        QSslConfiguration::NextProtocolHttp1_1});
+        m_netManager->connectToHostEncrypted(url.host(), url.port(443), config);
+#endif
+    } else {
+        m_netManager->connectToHost(url.host(), url.port(80));
+    }
+}
+
+QNetworkAccessManager *UploadEngine::networkManager() const
+{
+    return m_netManager;
+}
+
+NetworkTelemetry *UploadEngine::telemetry() const
+{
+    return m_telemetry;
+}
+
+UploadQueue *UploadEngine::queue() const
+{
+    return m_uploadQueue;
+}
+
+UploadIndex &UploadEngine::index()
+{
+    return m_uploadIndex;
+}
+
+void UploadEngine::setDedup(bool enabled, bool askServer)
+{
+    m_uploadQueue->setIndex(enabled ? &m_uploadIndex : nullptr);
+    m_uploadQueue->setAskServer(enabled && askServer);
+}
+
+bool UploadEngine::isLoggedIn() const
+{
+    return !m_jwtToken.isEmpty();
+}
+
+void UploadEngine::login(const QString &username, const QString &password)
+{
+    // Gemerkt für den Login bei einem anderen Knoten nach einem Failover
+    m_username = username;
+    m_password = password;
+    m_relogin = false;
+    sendLogin(username, password);
+}
+
+void UploadEngine::sendLogin(const QString &username, const QString &password)
+{
+    // JSON Body bauen
+    QJsonObject json;
+    json["username"] = username;
+    json["password"] = password;
+
+    emit message("Logging in...");
+    m_loginClock.start();
+    if (m_loginCall)
+        m_loginCall->cancel(); // nur die Antwort des letzten Logins zählt
+    m_loginCall = postJson(m_serverUrl, "/login", json, [this](QNetworkReply *reply) { onLoginFinished(reply); });
+    m_loginCall->setMaxRetries(RetryPolicy::MaxRetries);
+}
+
+NetworkCall *UploadEngine::logout()
+{
+    // Laufender Login/Refresh darf danach keine Tokens mehr setzen
+    if (m_loginCall)
+        m_loginCall->cancel();
+    if (m_refreshCall)
+        m_refreshCall->cancel();
+    m_isRefreshing = false;
+    m_relogin = false;
+    m_resumedSession = false;
+
+    // Sessions bei den übrigen Knoten ebenfalls beenden, ohne auf die Antwort zu warten
+    for (auto it = m_sessions.cbegin(); it != m_sessions.cend(); ++it) {
+        if (!it->refreshToken.isEmpty())
+            postJson(it.key(), "/logout", {{"refreshToken", it->refreshToken}}, {});
+    }
+    m_sessions.clear();
+    m_username.clear();
+    m_password.clear();
+
+    // Wenn wir eingeloggt sind: Request an Server senden, um Refresh Token zu invalidieren
+    NetworkCall *call = nullptr;
+    if (!m_refreshToken.isEmpty()) {
+        emit message("Logging out...");
+
+        QJsonObject json;
+        json["refreshToken"] = m_refreshToken;
+
+        call = postJson(m_serverUrl, "/logout", json, [this](QNetworkReply *reply) {
+            if (reply->error() == QNetworkReply::NoError)
+                emit message("Server confirmed logout.");
+            else
+                emit message("Logout on server failed: " + reply->errorString());
+        });
+    }
+
+    // WICHTIG: Lokal sofort abmelden, egal was der Server sagt.
+    clearTokens();
+    replayPendingRequests();
+    emit message("Logged out locally.");
+    emit loggedOut();
+    return call;
+}
+
+int UploadEngine::enqueue(const QStringList &files,
+                          const QString &root,
+                          const QString &serverPath,
+                          UploadQueue::Priority priority)
+{
+    const QDir rootDir(root);
+    for (const QString &filePath : files) {
+        QString targetPath = serverPath;
+        if (!root.isEmpty()) {
+            const QString relDir = rootDir.relativeFilePath(QFileInfo(filePath).absolutePath());
+            if (relDir != ".")
+                targetPath = serverPath.isEmpty() ? relDir : serverPath + "/" + relDir;
+        }
+        m_uploadQueue->enqueue(filePath, targetPath, priority);
+    }
+    return files.size();
+}
+
+bool UploadEngine::sync(const QString &root, const QString &serverPath)
+{
+    m_folderSync->setServerUrl(m_serverUrl);
+    // Transkodierte Uploads haben remote einen anderen Inhalt, dann zählt nur "vorhanden"
+    m_folderSync->setPresenceOnly(m_uploadQueue->transcodeOptions().enabled);
+    return m_folderSync->start(root, serverPath);
+}
+
+void UploadEngine::start()
+{
+    m_uploadQueue->setServerUrl(m_serverUrl);
+    m_uploadQueue->setToken(m_jwtToken);
+    m_uploadQueue->start();
+}
+
+int UploadEngine::restoreJournal(const QString &fileName)
+{
+    if (m_journal)
+        return 0;
+
+    m_journal = new UploadJournal(fileName, this);
+    const QList<UploadJournal::Pending> pending = m_journal->load();
+    m_journal->attach(m_uploadQueue);
+
+    int restored = 0;
+    for (const UploadJournal::Pending &entry : pending) {
+        const QFileInfo info(entry.filePath);
+        if (!info.isFile())
+            continue; // inzwischen gelöscht oder verschoben
+
+        const int index = m_uploadQueue->enqueue(entry.filePath, entry.serverPath, entry.priority);
+        ++restored;
+        if (entry.uploadId.isEmpty())
+            continue;
+
+        // Datei seit dem Journal-Eintrag verändert: Session nicht fortsetzen
+        const QByteArray hash = m_uploadIndex.cachedHash(entry.filePath,
+                                                         info.size(),
+                                                         info.lastModified().toMSecsSinceEpoch());
+        if (entry.hash.isEmpty() || hash.isEmpty() || hash == entry.hash)
+            m_uploadQueue->setResumePoint(index, entry.uploadId, entry.committed);
+    }
+
+    if (!m_journal->open())
+        emit message(tr("Could not write upload journal %1").arg(fileName));
+    return restored;
+}
+
+void UploadEngine::clearTokens()
+{
+    m_jwtToken.clear();
+    m_refreshToken.clear();
+    m_tokenExpiry = QDateTime();
+    m_refreshTimer->stop();
+}
+
+void UploadEngine::scheduleTokenRefresh()
+{
+    m_refreshTimer->stop();
+    m_tokenExpiry = jwtExpiry(m_jwtToken);
+    if (!m_tokenExpiry.isValid())
+        return; // Kein JWT: wir merken den Ablauf erst am 401
+
+    const qint64 ms = QDateTime::currentDateTimeUtc().msecsTo(m_tokenExpiry)
+                      - REFRESH_LEAD_TIME * 1000;
+    m_refreshTimer->start(static_cast<int>(std::clamp<qint64>(ms, 0, std::numeric_limits<int>::max())));
+}
+
+bool UploadEngine::tokenExpiresSoon() const
+{
+    return m_tokenExpiry.isValid()
+           && QDateTime::currentDateTimeUtc().secsTo(m_tokenExpiry) < TOKEN_EXPIRY_MARGIN;
+}
+
+void UploadEngine::sendAuthorized(const Authorization::Call &call)
+{
+    // Während eines Refresh (oder kurz vor Ablauf) warten statt einen 401 zu riskieren
+    if (m_isRefreshing || tokenExpiresSoon()) {
+        m_pendingRequests.append(call);
+        performTokenRefresh();
+        return;
+    }
+    call(m_jwtToken);
+}
+
+void UploadEngine::replayPendingRequests()
+{
+    // Gesammelte Requests mit dem neuen Token ausführen (leeres Token = abbrechen)
+    const QList<Authorization::Call> pending = std::exchange(m_pendingRequests, {});
+    for (const Authorization::Call &call : pending)
+        call(m_jwtToken);
+
+    // Nach einem 401 angehaltene Uploads fortsetzen
+    if (!m_jwtToken.isEmpty() && m_uploadQueue->isPaused()) {
+        emit message("Resuming upload queue with new token...");
+        m_uploadQueue->setToken(m_jwtToken);
+        m_uploadQueue->start();
+    }
+}
+
+void UploadEngine::performTokenRefresh()
+{
+    if (m_isRefreshing)
+        return;
+    if (m_refreshToken.isEmpty()) {
+        replayPendingRequests(); // Ohne Refresh Token kein neues Access Token
+        return;
+    }
+    m_isRefreshing = true;
+
+    QJsonObject json;
+    json["refreshToken"] = m_refreshToken;
+
+    emit message("Refreshing access token...");
+    // Vorübergehende Fehler wiederholt der Call; wartende Requests bleiben solange gesammelt
+    m_refreshCall = postJson(m_serverUrl, "/refresh", json, [this](QNetworkReply *reply) { onRefreshFinished(reply); });
+    m_refreshCall->setMaxRetries(RetryPolicy::MaxRetries);
+}
+
+NetworkCall *UploadEngine::postJson(const QString &serverUrl,
+                                    const QString &path,
+                                    const QJsonObject &json,
+                                    const NetworkCall::Continuation &then)
+{
+    QNetworkRequest request(QUrl(serverUrl + path));
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+
+    NetworkCall *call = NetworkCall::post(m_netManager, request, QJsonDocument(json).toJson(), this, then);
+    connect(call, &NetworkCall::retrying, this, [this, path](int retry, int delayMs, const QString &reason) {
+        emit message(QString("%1 failed (%2), retry %3/%4 in %5 ms")
+                         .arg(path, reason)
+                         .arg(retry)
+                         .arg(RetryPolicy::MaxRetries)
+                         .arg(delayMs));
+    });
+    return call;
+}
+
+void UploadEngine::relogin()
+{
+    const ServerPool::Server server = m_servers->active();
+    const QString username = server.username.isEmpty() ? m_username : server.username;
+    const QString password = server.password.isEmpty() ? m_password : server.password;
+    m_relogin = true;
+    m_isRefreshing = true;
+    emit message(QString("Logging in at %1 as %2...").arg(server.name, username));
+    sendLogin(username, password);
+}
+
+void UploadEngine::useServer(const QString &url)
+{
+    if (url.isEmpty() || url == m_serverUrl)
+        return;
+
+    // Login/Refresh beim alten Knoten sind hinfällig, wartende Requests bleiben gesammelt
+    const bool loggingIn = !m_loginCall.isNull();
+    if (m_loginCall)
+        m_loginCall->cancel();
+    if (m_refreshCall)
+        m_refreshCall->cancel();
+    m_isRefreshing = false;
+    m_relogin = false;
+    const bool session = loggingIn || !m_jwtToken.isEmpty() || !m_refreshToken.isEmpty();
+
+    // Tokens gelten nur bei dem Knoten, der sie ausgestellt hat
+    if (!m_refreshToken.isEmpty())
+        m_sessions.insert(m_serverUrl, {m_jwtToken, m_refreshToken});
+    const Session stored = m_sessions.take(url);
+    m_jwtToken = stored.token;
+    m_refreshToken = stored.refreshToken;
+    m_resumedSession = !m_refreshToken.isEmpty();
+    m_serverUrl = url;
+    if (m_jwtToken.isEmpty()) {
+        m_refreshTimer->stop();
+        m_tokenExpiry = QDateTime();
+    } else {
+        scheduleTokenRefresh();
+    }
+
+    // Erst Token bzw. Wartezustand, dann umschalten: Chunked Uploads senden sofort neu
+    if (session) {
+        if (!m_jwtToken.isEmpty() && !tokenExpiresSoon())
+            m_uploadQueue->setToken(m_jwtToken);
+        else if (!m_refreshToken.isEmpty())
+            performTokenRefresh();
+        else
+            relogin();
+    }
+    m_uploadQueue->setServerUrl(url);
+    m_folderSync->setServerUrl(url);
+}
+
+bool UploadEngine::failOver(const QNetworkReply *reply)
+{
+    if (!RetryPolicy::isUnreachable(reply))
+        return false;
+    const QString before = m_serverUrl;
+    m_servers->reportFailure(reply->url().toString(), RetryPolicy::reason(reply));
+    return m_serverUrl != before;
+}
+
+void UploadEngine::onQueueAuthenticationRequired()
+{
+    if (m_relogin)
+        return; // Login beim neuen Knoten läuft, danach geht die Queue weiter
+    if (!m_refreshToken.isEmpty()) {
+        emit message("Access Token expired (401). Trying Refresh...");
+        performTokenRefresh();
+    } else {
+        emit message("Session expired. Please login again.");
+        emit sessionExpired();
+    }
+}
+
+// --- Netzwerk Antwort Handler (je Request) ---
+void UploadEngine::onRefreshFinished(QNetworkReply *reply)
+{
+    m_isRefreshing = false; // Flag zurücksetzen
+
+    const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
+    if (statusCode == 200 && doc.isObject() && doc.object().contains("token")) {
+        m_jwtToken = doc.object()["token"].toString();
+        m_resumedSession = false;
+        scheduleTokenRefresh();
+        emit message("Token refreshed successfully. Replaying waiting requests...");
+        emit tokenRefreshed();
+    } else {
+        if (reply->error() != QNetworkReply::NoError)
+            emit message("Network Error: " + reply->errorString());
+        if (failOver(reply))
+            return; // useServer() kümmert sich um Token und wartende Requests
+        if (std::exchange(m_resumedSession, false) && !m_username.isEmpty()) {
+            // Gemerkte Session des Knotens ist inzwischen abgelaufen
+            m_refreshToken.clear();
+            relogin();
+            return;
+        }
+        emit message("Refresh failed (Session invalid). Please login again.");
+        clearTokens();
+        emit sessionExpired();
+    }
+
+    // Wartende Requests generisch wiederholen (bzw. mit leerem Token abbrechen)
+    replayPendingRequests();
+}
+
+void UploadEngine::onLoginFinished(QNetworkReply *reply)
+{
+    const QByteArray responseData = reply->readAll();
+    // Login nach einem Serverwechsel: Requests warten darauf wie auf einen Refresh
+    const bool relogin = std::exchange(m_relogin, false);
+    if (relogin)
+        m_isRefreshing = false;
+
+    // Netzwerkfehler bzw. Fehlerstatus (auch 401 = falsche Zugangsdaten)
+    if (reply->error() != QNetworkReply::NoError) {
+        emit message("Network Error: " + reply->errorString());
+        emit message("Server Message: " + responseData);
+        if (failOver(reply))
+            return; // Login läuft schon beim nächsten Knoten
+        if (relogin)
+            replayPendingRequests(); // ohne Token: abbrechen, die Queue hält an
+        emit loginFailed(reply->errorString());
+        return;
+    }
+
+    QJsonObject obj = QJsonDocument::fromJson(responseData).object();
+    if (obj.contains("token") && obj.contains("refreshToken")) {
+        m_jwtToken = obj["token"].toString();
+        m_refreshToken = obj["refreshToken"].toString();
+        m_resumedSession = false;
+        scheduleTokenRefresh();
+
+        emit message("Login Success! Tokens received.");
+        if (!m_firstLoginDone) {
+            m_firstLoginDone = true;
+            const double sinceStart = m_startClock.nsecsElapsed() / 1e6;
+            const double request = m_loginClock.nsecsElapsed() / 1e6;
+            m_telemetry->recordStartup("firstLogin", sinceStart);
+            m_telemetry->recordStartup("firstLoginRequest", request);
+            emit message(QString("First login after %1 ms (request %2 ms)")
+                             .arg(sinceStart, 0, 'f', 0)
+                             .arg(request, 0, 'f', 0));
+        }
+        emit loggedIn();
+
+        // Nach erneutem Login angehaltene Uploads fortsetzen
+        replayPendingRequests();
+    } else {
+        emit message("Login failed: Invalid JSON response.");
+        if (relogin)
+            replayPendingRequests(); // ohne Token: abbrechen, die Queue hält an
+        emit loginFailed(tr("Invalid JSON response."));
+    }
+}
@@ -0,0 +1,160 @@
+/**
+ * @file UploadEngine.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief login, token refresh and upload queue without any widgets (GUI and CLI)
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include "Authorization.h"
+#include "FolderSync.h"
+#include "NetworkCall.h"
+#include "NetworkTelemetry.h"
+#include "RetryPolicy.h"
+#include "ServerPool.h"
+#include "TlsSessionCache.h"
+#include "UploadIndex.h"
+#include "UploadJournal.h"
+#include "UploadQueue.h"
+
+class UploadEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UploadEngine(QObject *parent = nullptr);
+    UploadEngine(const QString &indexFile, QObject *parent = nullptr);
+    ~UploadEngine() override;
+
+    // Ein einzelner Server (ohne Proben und Failover)
+    void setServerUrl(const QString &url);
+    // Mehrere Knoten: der schnellste erreichbare wird genommen, bei Ausfall auch mitten im Lauf
+    // gewechselt. Tokens gelten je Knoten; ohne eigene gibt es einen Login mit den Zugangsdaten
+    // des Profils bzw. des letzten login().
+    void setServers(const QList<ServerPool::Server> &servers);
+    ServerPool *servers() const;
+    // Aktiver Knoten
+    QString serverUrl() const;
+    // DNS, TCP und TLS zum Server schon vorab, damit der Login nicht darauf wartet
+    void prewarm();
+
+    QNetworkAccessManager *networkManager() const;
+    // Zeiten und Bytes aller Requests des networkManager()
+    NetworkTelemetry *telemetry() const;
+    UploadQueue *queue() const;
+    UploadIndex &index();
+    // Bereits hochgeladene Dateien überspringen (optional zusätzlich beim Server nachfragen)
+    void setDedup(bool enabled, bool askServer);
+
+    void login(const QString &username, const QString &password);
+    // Refresh Token beim Server invalidieren ("Fire and Forget") und lokal abmelden.
+    // Liefert den Logout-Request (finished() = Server hat geantwortet) oder nullptr.
+    NetworkCall *logout();
+    bool isLoggedIn() const;
+
+    // Bei einem Ordner (root) bleibt die Unterordner-Struktur unter serverPath erhalten
+    int enqueue(const QStringList &files,
+                const QString &root,
+                const QString &serverPath,
+                UploadQueue::Priority priority = UploadQueue::Priority::Background);
+    void start();
+    // Offene Uploads aus dem Journal wieder einreihen und ab jetzt mitschreiben.
+    // Liefert die Anzahl der wieder eingereihten Dateien.
+    int restoreJournal(const QString &fileName = UploadJournal::defaultLocation());
+    // Ordner mit dem Manifest von serverPath abgleichen und nur neue/geänderte Dateien
+    // einreihen (nicht starten); Ergebnis per syncFinished(). Braucht einen Login.
+    bool sync(const QString &root, const QString &serverPath);
+
+signals:
+    void message(const QString &text);
+    void loggedIn();
+    void tokenRefreshed();
+    void loginFailed(const QString &reason);
+    void loggedOut();
+    // Failover bzw. schnellerer Knoten: ab jetzt gehen alle Requests an url
+    void serverChanged(const QString &name, const QString &url, const QString &reason);
+    // Kein gültiges Token mehr zu bekommen: neu einloggen
+    void sessionExpired();
+    // queued Dateien eingereiht; bei Fehler ist error gesetzt und nichts eingereiht
+    void syncFinished(int queued, int unchanged, const QString &error);
+
+private:
+    // Tokens eines Knotens, solange ein anderer aktiv ist
+    struct Session
+    {
+        QString token;
+        QString refreshToken;
+    };
+
+    // POST serverUrl + path mit JSON Body; then läuft genau einmal mit der Antwort dieses Requests
+    NetworkCall *postJson(const QString &serverUrl,
+                          const QString &path,
+                          const QJsonObject &json,
+                          const NetworkCall::Continuation &then);
+    void sendLogin(const QString &username, const QString &password);
+    // Login beim aktiven Knoten mit dessen Profil bzw. den gemerkten Zugangsdaten;
+    // Requests warten solange wie bei einem Refresh
+    void relogin();
+    void useServer(const QString &url);
+    // Nach einem Verbindungsfehler: true, wenn der Pool deshalb den Knoten gewechselt hat
+    bool failOver(const QNetworkReply *reply);
+    void onLoginFinished(QNetworkReply *reply);
+    void onRefreshFinished(QNetworkReply *reply);
+    void onQueueAuthenticationRequired();
+    void performTokenRefresh();
+    void scheduleTokenRefresh();
+    bool tokenExpiresSoon() const;
+    void sendAuthorized(const Authorization::Call &call);
+    void replayPendingRequests();
+    void clearTokens();
+
+    NetworkTelemetry *m_telemetry;
+    TlsSessionCache *m_tlsSessions;
+    QNetworkAccessManager *m_netManager;
+    UploadQueue *m_uploadQueue;
+    UploadIndex m_uploadIndex;
+    UploadJournal *m_journal = nullptr;
+    FolderSync *m_folderSync;
+    ServerPool *m_servers;
+    QString m_serverUrl = "http://localhost:8080";
+
+    QString m_jwtToken;
+    QString m_refreshToken;
+    // Refresh oder Login nach einem Serverwechsel läuft: Requests warten
+    bool m_isRefreshing = false;
+    bool m_relogin = false;
+    // Tokens stammen aus m_sessions (früher beim Knoten geholt): scheitert der Refresh, neu einloggen
+    bool m_resumedSession = false;
+    QHash<QString, Session> m_sessions; // je Server URL, ohne den aktiven
+    // Für den Login bei einem anderen Knoten; nur im Speicher, beim Logout verworfen
+    QString m_username;
+    QString m_password;
+    // Laufende Login/Refresh Requests, beim Logout verworfen
+    QPointer<NetworkCall> m_loginCall;
+    QPointer<NetworkCall> m_refreshCall;
+    QTimer *m_refreshTimer;
+    QDateTime m_tokenExpiry;
+    QList<Authorization::Call> m_pendingRequests;
+
+    // Startmetrik: Erzeugung der Engine bzw. Absenden des Logins bis zum ersten Erfolg
+    QElapsedTimer m_startClock;
+    QElapsedTimer m_loginClock;
+    bool m_firstLoginDone = false;
+};
@@ -0,0 +1,128 @@
+#include "UploadIndex.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <utility>
+
+namespace {
+constexpr quint32 IndexMagic = 0x43524958; // "CRIX"
+constexpr quint32 IndexVersion = 1;
+} // namespace
+
+UploadIndex::UploadIndex(const QString &fileName)
+    : m_fileName(fileName)
+{}
+
+QString UploadIndex::defaultLocation()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/upload-index.dat";
+}
+
+bool UploadIndex::load()
+{
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint64 count = 0;
+    in >> magic >> version >> count;
+    if (magic != IndexMagic || version != IndexVersion)
+        return false;
+
+    m_entries.clear();
+    m_uploaded.clear();
+    m_entries.reserve(count);
+    for (qint64 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        Entry entry;
+        in >> path >> entry.size >> entry.mtime >> entry.hash >> entry.serverPaths;
+        for (const QString &serverPath : std::as_const(entry.serverPaths))
+            m_uploaded.insert(uploadKey(entry.hash, serverPath));
+        m_entries.insert(path, entry);
+    }
+    m_dirty = false;
+    return in.status() == QDataStream::Ok;
+}
+
+bool UploadIndex::save()
+{
+    if (!m_dirty)
+        return true;
+
+    QDir().mkpath(QFileInfo(m_fileName).absolutePath());
+    // QSaveFile: bei Absturz bleibt der alte Index intakt
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out << IndexMagic << IndexVersion << static_cast<qint64>(m_entries.size());
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+        const Entry &entry = it.value();
+        out << it.key() << entry.size << entry.mtime << entry.hash << entry.serverPaths;
+    }
+    if (!file.commit())
+        return false;
+
+    m_dirty = false;
+    return true;
+}
+
+QByteArray UploadIndex::cachedHash(const QString &filePath, qint64 size, qint64 mtime) const
+{
+    const auto it = m_entries.constFind(filePath);
+    if (it == m_entries.cend() || it->size != size || it->mtime != mtime)
+        return QByteArray();
+    return it->hash;
+}
+
+void UploadIndex::updateHash(const QString &filePath, qint64 size, qint64 mtime, const QByteArray &hash)
+{
+    Entry &entry = m_entries[filePath];
+    if (entry.size == size && entry.mtime == mtime && entry.hash == hash)
+        return;
+
+    // Inhalt hat sich geändert: alte Upload-Ziele gelten nicht mehr für diese Datei
+    entry.size = size;
+    entry.mtime = mtime;
+    entry.hash = hash;
+    entry.serverPaths.clear();
+    m_dirty = true;
+}
+
+bool UploadIndex::contains(const QByteArray &hash, const QString &serverPath) const
+{
+    return !hash.isEmpty() && m_uploaded.contains(uploadKey(hash, serverPath));
+}
+
+void UploadIndex::recordUpload(const QString &filePath,
+                               qint64 size,
+                               qint64 mtime,
+                               const QByteArray &hash,
+                               const QString &serverPath)
+{
+    updateHash(filePath, size, mtime, hash);
+
+    Entry &entry = m_entries[filePath];
+    if (!entry.serverPaths.contains(serverPath))
+        entry.serverPaths.append(serverPath);
+    m_uploaded.insert(uploadKey(hash, serverPath));
+    m_dirty = true;
+}
+
+qsizetype UploadIndex::count() const
+{
+    return m_entries.size();
+}
+
+QByteArray UploadIndex::uploadKey(const QByteArray &hash, const QString &serverPath)
+{
+    return hash + '\0' + serverPath.toUtf8();
+}
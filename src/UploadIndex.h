@@ -0,0 +1,57 @@
+/**
+ * @file UploadIndex.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief persistent index of uploaded files (path, size, mtime, hash, server path)
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+class UploadIndex
+{
+public:
+    struct Entry
+    {
+        qint64 size = 0;
+        qint64 mtime = 0; // ms seit Epoch
+        QByteArray hash;
+        QStringList serverPaths;
+    };
+
+    explicit UploadIndex(const QString &fileName = defaultLocation());
+
+    static QString defaultLocation();
+
+    bool load();
+    bool save();
+
+    // Hash aus dem Index, solange Größe und Änderungszeit noch passen
+    QByteArray cachedHash(const QString &filePath, qint64 size, qint64 mtime) const;
+    void updateHash(const QString &filePath, qint64 size, qint64 mtime, const QByteArray &hash);
+
+    bool contains(const QByteArray &hash, const QString &serverPath) const;
+    void recordUpload(const QString &filePath,
+                      qint64 size,
+                      qint64 mtime,
+                      const QByteArray &hash,
+                      const QString &serverPath);
+
+    qsizetype count() const;
+
+private:
+    static QByteArray uploadKey(const QByteArray &hash, const QString &serverPath);
+
+    QString m_fileName;
+    QHash<QString, Entry> m_entries;
+    QSet<QByteArray> m_uploaded; // hash + Zielpfad
+    bool m_dirty = false;
+};
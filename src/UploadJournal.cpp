@@ -0,0 +1,271 @@
+#include "UploadJournal.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <utility>
+
+#include <zlib.h>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr quint32 JournalMagic = 0x43524a4c; // "CRJL"
+constexpr quint32 JournalVersion = 1;
+constexpr quint32 MaxRecordSize = 1024 * 1024;
+// Größere Puffer sofort schreiben statt auf den Timer zu warten
+constexpr qsizetype MaxBuffered = 256 * 1024;
+
+quint32 checksum(const QByteArray &data)
+{
+    return static_cast<quint32>(
+        crc32(0, reinterpret_cast<const Bytef *>(data.constData()), static_cast<uInt>(data.size())));
+}
+} // namespace
+
+UploadJournal::UploadJournal(const QString &fileName, QObject *parent)
+    : QObject(parent)
+    , m_fileName(fileName)
+{
+    m_writer.setMaxThreadCount(1);
+    m_syncTimer.setSingleShot(true);
+    m_syncTimer.setInterval(SyncInterval);
+    connect(&m_syncTimer, &QTimer::timeout, this, &UploadJournal::flush);
+}
+
+UploadJournal::~UploadJournal()
+{
+    sync();
+}
+
+QString UploadJournal::defaultLocation()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/upload-journal.dat";
+}
+
+QList<UploadJournal::Pending> UploadJournal::load() const
+{
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != JournalMagic || version != JournalVersion)
+        return {};
+
+    QHash<qint64, Pending> pending;
+    QList<qint64> order;
+    while (!in.atEnd()) {
+        quint32 size = 0;
+        quint32 crc = 0;
+        in >> size >> crc;
+        if (in.status() != QDataStream::Ok || size > MaxRecordSize)
+            break;
+        QByteArray payload(size, Qt::Uninitialized);
+        if (in.readRawData(payload.data(), static_cast<int>(size)) != static_cast<int>(size)
+            || checksum(payload) != crc) {
+            break; // Record beim Absturz nur halb geschrieben
+        }
+
+        QDataStream record(payload);
+        quint8 type = 0;
+        qint64 id = 0;
+        record >> type >> id;
+        switch (static_cast<Record>(type)) {
+        case Record::Queued: {
+            Pending entry;
+            quint8 priority = 0;
+            record >> entry.filePath >> entry.serverPath >> priority;
+            entry.priority = static_cast<UploadQueue::Priority>(priority);
+            pending.insert(id, entry);
+            order.append(id);
+            break;
+        }
+        case Record::Started: {
+            QByteArray hash;
+            record >> hash;
+            if (pending.contains(id) && !hash.isEmpty())
+                pending[id].hash = hash;
+            break;
+        }
+        case Record::Committed: {
+            QString uploadId;
+            qint64 committed = 0;
+            record >> uploadId >> committed;
+            if (pending.contains(id)) {
+                pending[id].uploadId = uploadId;
+                pending[id].committed = committed;
+            }
+            break;
+        }
+        case Record::Finished:
+            pending.remove(id);
+            break;
+        }
+    }
+
+    QList<Pending> result;
+    for (const qint64 id : std::as_const(order)) {
+        const auto it = pending.constFind(id);
+        if (it != pending.constEnd())
+            result.append(*it);
+    }
+    return result;
+}
+
+void UploadJournal::attach(UploadQueue *queue)
+{
+    m_queue = queue;
+
+    connect(queue, &UploadQueue::itemAdded, this, [this](int index) {
+        const UploadQueue::Item &item = m_queue->item(index);
+        const qint64 id = m_nextId++;
+        m_ids.insert(index, id);
+        append(Record::Queued, id, [&item](QDataStream &out) {
+            out << item.filePath << item.serverPath << static_cast<quint8>(item.priority);
+        });
+    });
+    connect(queue, &UploadQueue::itemStarted, this, [this](int index) {
+        const QByteArray hash = m_queue->item(index).hash;
+        append(Record::Started, m_ids.value(index), [&hash](QDataStream &out) { out << hash; });
+    });
+    connect(queue,
+            &UploadQueue::itemCommitted,
+            this,
+            [this](int index, const QString &uploadId, qint64 offset) {
+                append(Record::Committed, m_ids.value(index), [&](QDataStream &out) {
+                    out << uploadId << offset;
+                });
+            });
+    connect(queue, &UploadQueue::itemFinished, this, [this](int index, bool ok) {
+        const UploadQueue::Item &item = m_queue->item(index);
+        append(Record::Finished, m_ids.value(index), [&item, ok](QDataStream &out) {
+            out << static_cast<quint8>(ok ? UploadQueue::State::Done : UploadQueue::State::Failed)
+                << item.hash;
+        });
+    });
+    connect(queue, &UploadQueue::itemSkipped, this, [this](int index) {
+        const UploadQueue::Item &item = m_queue->item(index);
+        append(Record::Finished, m_ids.value(index), [&item](QDataStream &out) {
+            out << static_cast<quint8>(UploadQueue::State::Skipped) << item.hash;
+        });
+    });
+    // Alles erledigt: das Journal wieder auf die offenen Uploads eindampfen
+    connect(queue, &UploadQueue::finished, this, &UploadJournal::compact);
+}
+
+void UploadJournal::append(Record type, qint64 id, const std::function<void(QDataStream &)> &fields)
+{
+    QByteArray payload;
+    {
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out << static_cast<quint8>(type) << id;
+        fields(out);
+    }
+
+    QDataStream out(&m_buffer, QIODevice::WriteOnly | QIODevice::Append);
+    out << static_cast<quint32>(payload.size()) << checksum(payload);
+    out.writeRawData(payload.constData(), static_cast<int>(payload.size()));
+
+    if (m_buffer.size() >= MaxBuffered)
+        flush();
+    else if (!m_syncTimer.isActive())
+        m_syncTimer.start();
+}
+
+bool UploadJournal::writeAndSync(QFile *file, const QByteArray &data)
+{
+    if (file->write(data) != data.size() || !file->flush())
+        return false;
+#ifdef Q_OS_WIN
+    return _commit(file->handle()) == 0;
+#else
+    return ::fsync(file->handle()) == 0;
+#endif
+}
+
+void UploadJournal::flush()
+{
+    m_syncTimer.stop();
+    if (!m_file || m_buffer.isEmpty())
+        return; // Vor open() wird nur gesammelt
+
+    // Schreiben und fsync im Writer-Thread, die Uploads warten nicht auf die Platte
+    m_writer.start([file = m_file, data = std::exchange(m_buffer, {})]() {
+        writeAndSync(file.get(), data);
+    });
+}
+
+void UploadJournal::sync()
+{
+    flush();
+    m_writer.waitForDone();
+}
+
+bool UploadJournal::open()
+{
+    m_syncTimer.stop();
+    m_writer.waitForDone();
+    m_file.reset();
+
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << JournalMagic << JournalVersion;
+    }
+    data += std::exchange(m_buffer, {});
+
+    QDir().mkpath(QFileInfo(m_fileName).absolutePath());
+    // QSaveFile: das alte Journal bleibt gültig, bis das neue vollständig ist
+    QSaveFile save(m_fileName);
+    if (!save.open(QIODevice::WriteOnly) || save.write(data) != data.size() || !save.commit())
+        return false;
+
+    auto file = std::make_shared<QFile>(m_fileName);
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Append))
+        return false;
+    m_file = file;
+    return true;
+}
+
+void UploadJournal::compact()
+{
+    if (!m_file || !m_queue)
+        return;
+
+    // Nur noch offene Items neu schreiben (nach einem vollständigen Durchlauf: keine)
+    m_syncTimer.stop();
+    m_buffer.clear();
+    QList<int> indexes = m_ids.keys();
+    std::sort(indexes.begin(), indexes.end());
+    m_ids.clear();
+
+    for (const int index : std::as_const(indexes)) {
+        const UploadQueue::Item &item = m_queue->item(index);
+        if (item.state == UploadQueue::State::Done || item.state == UploadQueue::State::Skipped
+            || item.state == UploadQueue::State::Failed) {
+            continue;
+        }
+        const qint64 id = m_nextId++;
+        m_ids.insert(index, id);
+        append(Record::Queued, id, [&item](QDataStream &out) {
+            out << item.filePath << item.serverPath << static_cast<quint8>(item.priority);
+        });
+        if (!item.uploadId.isEmpty()) {
+            append(Record::Committed, id, [&item](QDataStream &out) {
+                out << item.uploadId << item.committed;
+            });
+        }
+    }
+    open();
+}
@@ -0,0 +1,84 @@
+/**
+ * @file UploadJournal.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief append-only journal of queued, running and finished uploads for resume after a crash
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <functional>
+#include <memory>
+
+#include "UploadQueue.h"
+
+/*
+ * Datei: Magic, Version, danach Records [Länge][CRC-32][Payload].
+ * Ein abgeschnittener oder beschädigter Record am Ende (Absturz beim Schreiben)
+ * beendet das Lesen, alles davor gilt.
+ * Records werden gesammelt und im Hintergrund gebündelt geschrieben + gesynct.
+ */
+class UploadJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int SyncInterval = 500; // ms
+
+    struct Pending
+    {
+        QString filePath;
+        QString serverPath;
+        UploadQueue::Priority priority = UploadQueue::Priority::Background;
+        QByteArray hash;
+        QString uploadId; // Chunked Session, falls schon Chunks bestätigt sind
+        qint64 committed = 0;
+    };
+
+    explicit UploadJournal(const QString &fileName, QObject *parent = nullptr);
+    ~UploadJournal() override;
+
+    static QString defaultLocation();
+
+    // Noch nicht abgeschlossene Uploads aus dem vorhandenen Journal
+    QList<Pending> load() const;
+
+    // Ab jetzt alle Änderungen der Queue mitschreiben
+    void attach(UploadQueue *queue);
+    // Ersetzt das alte Journal atomar durch die bisher gesammelten Records und schreibt
+    // danach fortlaufend an; vorher erzeugte Records (z.B. beim Wiedereinreihen) gehen nicht verloren
+    bool open();
+    // Gesammelte Records sofort schreiben und auf die Platte bringen
+    void sync();
+
+private:
+    enum class Record : quint8 { Queued = 1, Started, Committed, Finished };
+
+    void append(Record type, qint64 id, const std::function<void(QDataStream &)> &fields);
+    void flush();
+    void compact();
+    static bool writeAndSync(QFile *file, const QByteArray &data);
+
+    QString m_fileName;
+    UploadQueue *m_queue = nullptr;
+    QHash<int, qint64> m_ids; // Queue-Index -> Journal-Id
+    qint64 m_nextId = 0;
+
+    QByteArray m_buffer;
+    QTimer m_syncTimer;
+    std::shared_ptr<QFile> m_file; // gehört danach dem Writer-Thread
+    QThreadPool m_writer;          // ein Thread: Writes bleiben in Reihenfolge
+};
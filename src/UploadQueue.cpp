@@ -0,0 +1,1134 @@
+#include "UploadQueue.h"
+#include "ChunkedUpload.h"
+#include "FileHasher.h"
+#include "ImageFiles.h"
+#include "NetworkCall.h"
+#include "UploadIndex.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkRequest>
+#include <QThread>
+#include <QUrlQuery>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+#include <utility>
+
+UploadQueue::UploadQueue(QNetworkAccessManager *manager, QObject *parent)
+    : QObject(parent)
+    , m_netManager(manager)
+{
+    // Dekodierte Bilder sind groß: höchstens so viele gleichzeitig wie Kerne, max. 4
+    m_transcodePool.setMaxThreadCount(std::clamp(QThread::idealThreadCount(), 1, 4));
+
+    m_clock.start();
+    m_retryTimer.setSingleShot(true);
+    connect(&m_retryTimer, &QTimer::timeout, this, [this]() {
+        startNext();
+        armRetryTimer();
+    });
+
+    m_windowTimer.setInterval(ConcurrencyController::Window);
+    connect(&m_windowTimer, &QTimer::timeout, this, &UploadQueue::onWindow);
+    connect(&m_controller, &ConcurrencyController::limitChanged, this, [this](int limit) {
+        emit concurrencyChanged(limit);
+        startNext();
+    });
+}
+
+QNetworkRequest UploadQueue::uploadRequest(const QString &serverUrl, const QString &token)
+{
+    QNetworkRequest request(QUrl(serverUrl + "/upload"));
+    request.setRawHeader("Authorization", ("Bearer " + token).toUtf8());
+    return request;
+}
+
+QNetworkRequest UploadQueue::batchRequest(const QString &serverUrl, const QString &token)
+{
+    QNetworkRequest request(QUrl(serverUrl + "/upload/batch"));
+    request.setRawHeader("Authorization", ("Bearer " + token).toUtf8());
+    return request;
+}
+
+MultipartBody *UploadQueue::uploadBody(QIODevice *file,
+                                       const QString &fileName,
+                                       const QString &contentType,
+                                       const QString &serverPath,
+                                       const QByteArray &contentEncoding,
+                                       const QByteArray &metadata)
+{
+    return new MultipartBody(file, fileName, contentType, serverPath, contentEncoding, metadata);
+}
+
+void UploadQueue::setServerUrl(const QString &url)
+{
+    if (url == m_serverUrl)
+        return;
+    m_serverUrl = url;
+    for (auto it = m_chunked.cbegin(); it != m_chunked.cend(); ++it)
+        it.key()->setServerUrl(url);
+
+    // Der Backoff galt dem alten Knoten: wartende Wiederholungen gleich beim neuen
+    bool waiting = false;
+    for (Item &item : m_items) {
+        if (item.state == State::Pending && item.retryAt > 0) {
+            item.retryAt = 0;
+            waiting = true;
+        }
+    }
+    if (waiting && m_running)
+        m_retryTimer.start(0);
+}
+
+void UploadQueue::setToken(const QString &token)
+{
+    m_jwtToken = token;
+}
+
+void UploadQueue::setDispatcher(const Authorization::Dispatcher &dispatcher)
+{
+    m_dispatcher = dispatcher;
+}
+
+void UploadQueue::setConcurrency(int concurrency)
+{
+    m_concurrency = std::max(1, concurrency);
+    if (m_adaptive)
+        m_controller.reset(m_concurrency, 1, MaxAdaptiveConcurrency);
+    startNext();
+}
+
+int UploadQueue::concurrency() const
+{
+    return m_concurrency;
+}
+
+void UploadQueue::setAdaptiveConcurrency(bool enabled)
+{
+    m_adaptive = enabled;
+    if (enabled) {
+        m_controller.reset(m_concurrency, 1, MaxAdaptiveConcurrency);
+        if (m_running && !m_windowTimer.isActive()) {
+            m_windowBytes = bytesSent();
+            m_windowClock.start();
+            m_windowTimer.start();
+        }
+    } else {
+        m_windowTimer.stop();
+    }
+    emit concurrencyChanged(currentConcurrency());
+    startNext();
+}
+
+bool UploadQueue::adaptiveConcurrency() const
+{
+    return m_adaptive;
+}
+
+int UploadQueue::currentConcurrency() const
+{
+    return m_adaptive ? m_controller.limit() : m_concurrency;
+}
+
+void UploadQueue::setChunkSize(qint64 chunkSize)
+{
+    m_chunkSize = std::max<qint64>(0, chunkSize);
+}
+
+qint64 UploadQueue::chunkSize() const
+{
+    return m_chunkSize;
+}
+
+void UploadQueue::setBatching(int maxFiles, qint64 maxBytes, qint64 maxFileSize)
+{
+    m_batchFiles = std::max(1, maxFiles);
+    m_batchBytes = std::max<qint64>(1, maxBytes);
+    m_batchFileSize = std::max<qint64>(0, maxFileSize);
+    // Neuer Versuch, vielleicht kann es der (neue) Server inzwischen
+    m_batchUnsupported = false;
+}
+
+int UploadQueue::batchFiles() const
+{
+    return m_batchFiles;
+}
+
+void UploadQueue::setIndex(UploadIndex *index)
+{
+    m_index = index;
+}
+
+void UploadQueue::setAskServer(bool askServer)
+{
+    m_askServer = askServer;
+}
+
+void UploadQueue::setTranscodeOptions(const ImageTranscoder::Options &options)
+{
+    m_transcodeOptions = options;
+}
+
+ImageTranscoder::Options UploadQueue::transcodeOptions() const
+{
+    return m_transcodeOptions;
+}
+
+void UploadQueue::setCompression(bool enabled)
+{
+    m_compress = enabled;
+}
+
+bool UploadQueue::compression() const
+{
+    return m_compress;
+}
+
+void UploadQueue::setSendMetadata(bool enabled)
+{
+    m_sendMetadata = enabled;
+}
+
+bool UploadQueue::sendMetadata() const
+{
+    return m_sendMetadata;
+}
+
+void UploadQueue::setStripMetadata(bool enabled)
+{
+    m_stripMetadata = enabled;
+}
+
+bool UploadQueue::stripMetadata() const
+{
+    return m_stripMetadata;
+}
+
+void UploadQueue::setValidation(bool enabled)
+{
+    m_validate = enabled;
+}
+
+bool UploadQueue::validation() const
+{
+    return m_validate;
+}
+
+void UploadQueue::setRateLimits(qint64 totalRate, qint64 transferRate)
+{
+    m_limiter.setRates(totalRate, transferRate);
+}
+
+qint64 UploadQueue::rateLimit() const
+{
+    return m_limiter.totalRate();
+}
+
+qint64 UploadQueue::transferRateLimit() const
+{
+    return m_limiter.transferRate();
+}
+
+int UploadQueue::enqueue(const QString &filePath, const QString &serverPath, Priority priority)
+{
+    Item item;
+    item.filePath = filePath;
+    item.serverPath = serverPath;
+    item.priority = priority;
+    const QFileInfo info(filePath);
+    item.fileSize = info.size();
+    item.mtime = info.lastModified().toMSecsSinceEpoch();
+    item.uploadPath = filePath;
+    item.uploadName = info.fileName();
+    item.contentType = ImageFiles::mimeType(filePath);
+    item.bytesTotal = item.fileSize;
+    item.idempotencyKey = RetryPolicy::newKey();
+    m_items.append(item);
+    if (m_running)
+        m_bytesTotal += item.bytesTotal;
+    if (priority == Priority::Interactive)
+        ++m_interactive;
+
+    const int index = m_items.size() - 1;
+    emit itemAdded(index);
+    if (m_index)
+        hashItem(index);
+    return index;
+}
+
+void UploadQueue::start()
+{
+    if (!m_running) {
+        // Neuer Durchlauf: Statistik nur über die noch offenen Items
+        m_running = true;
+        m_succeeded = 0;
+        m_skipped = 0;
+        m_failed = 0;
+        m_bytesDone = 0;
+        m_bytesTotal = 0;
+        for (const Item &item : std::as_const(m_items)) {
+            if (item.state != State::Done && item.state != State::Skipped
+                && item.state != State::Failed)
+                m_bytesTotal += item.bytesTotal;
+        }
+        m_elapsed.start();
+        m_windowBytes = 0;
+        m_windowClock.start();
+        if (m_adaptive)
+            m_windowTimer.start();
+    }
+    m_paused = false;
+
+    // Chunked Uploads, die auf ein neues Token gewartet haben, setzen am bestätigten Offset fort
+    for (auto it = m_chunked.cbegin(); it != m_chunked.cend(); ++it) {
+        if (it.key()->isWaitingForAuth())
+            it.key()->start(m_jwtToken);
+    }
+    startNext();
+}
+
+void UploadQueue::setResumePoint(int index, const QString &uploadId, qint64 committed)
+{
+    Item &item = m_items[index];
+    item.uploadId = uploadId;
+    // Offset ist nur ein Hinweis, maßgeblich ist was der Server beim Fortsetzen meldet
+    item.committed = committed;
+    emit itemCommitted(index, uploadId, committed);
+}
+
+int UploadQueue::count() const
+{
+    return m_items.size();
+}
+
+const UploadQueue::Item &UploadQueue::item(int index) const
+{
+    return m_items.at(index);
+}
+
+bool UploadQueue::isRunning() const
+{
+    return m_running;
+}
+
+bool UploadQueue::isPaused() const
+{
+    return m_paused;
+}
+
+qint64 UploadQueue::bytesTotal() const
+{
+    return m_bytesTotal;
+}
+
+qint64 UploadQueue::bytesSent() const
+{
+    qint64 sent = m_bytesDone;
+    for (const int index : m_active)
+        sent += m_items.at(index).bytesSent;
+    for (const int index : m_chunked)
+        sent += m_items.at(index).bytesSent;
+    for (const QList<int> &indices : m_batches) {
+        for (const int index : indices)
+            sent += m_items.at(index).bytesSent;
+    }
+    return sent;
+}
+
+int UploadQueue::activeCount() const
+{
+    // Ein Batch belegt einen Slot, egal wie viele Dateien er enthält
+    return m_active.size() + m_chunked.size() + m_batches.size() + m_checks.size()
+           + m_waitingForToken;
+}
+
+double UploadQueue::bytesPerSecond() const
+{
+    if (!m_running || !m_elapsed.isValid())
+        return 0.0;
+    const qint64 ms = m_elapsed.elapsed();
+    return ms > 0 ? bytesSent() * 1000.0 / ms : 0.0;
+}
+
+void UploadQueue::startNext()
+{
+    // Kann indirekt aus der Schleife unten erneut aufgerufen werden
+    if (!m_running || m_paused || m_inStartNext)
+        return;
+    m_inStartNext = true;
+
+    if (m_interactive > 0)
+        startPending(Priority::Interactive);
+    startPending(Priority::Background);
+
+    prepareAhead();
+
+    // Alles vor m_nextIndex läuft bereits oder ist erledigt
+    while (m_nextIndex < m_items.size()) {
+        const State state = m_items.at(m_nextIndex).state;
+        if (state == State::Pending || state == State::Hashing || state == State::Preparing)
+            break;
+        ++m_nextIndex;
+    }
+    m_inStartNext = false;
+
+    if (m_running && activeCount() == 0 && m_nextIndex >= m_items.size()) {
+        m_running = false;
+        m_windowTimer.stop();
+        if (m_index)
+            m_index->save();
+        emit finished(m_succeeded, m_skipped, m_failed, m_bytesDone, m_elapsed.elapsed());
+    }
+}
+
+void UploadQueue::startPending(Priority priority)
+{
+    // Interaktive Uploads dürfen einen Slot mehr belegen, damit sie nicht hinter
+    // einem langen Batch auf einen freien Slot warten
+    const int slots = currentConcurrency() + (priority == Priority::Interactive ? 1 : 0);
+
+    for (int index = m_nextIndex; index < m_items.size() && activeCount() < slots; ++index) {
+        const Item &item = m_items.at(index);
+        if (item.state != State::Pending || item.priority != priority || isWaitingForRetry(item))
+            continue;
+
+        // Index vor dem Aufbau des Requests befragen
+        if (m_index && m_index->contains(item.hash, item.serverPath))
+            skipItem(index);
+        else if (m_index && m_askServer && !item.hash.isEmpty() && !item.serverChecked)
+            checkServer(index);
+        else if (needsPreparation(item))
+            continue; // übernimmt prepareAhead()
+        else if (m_chunkSize > 0 && item.bytesTotal > m_chunkSize)
+            startChunkedItem(index);
+        else if (isBatchable(item))
+            startBatch(index);
+        else
+            startItem(index);
+    }
+}
+
+void UploadQueue::dispatch(const Authorization::Call &call)
+{
+    // Solange auf ein Token gewartet wird, zählt der Request als aktiv
+    ++m_waitingForToken;
+    const Authorization::Call counted = [this, call](const QString &token) {
+        --m_waitingForToken;
+        call(token);
+    };
+    if (m_dispatcher)
+        m_dispatcher(counted);
+    else
+        counted(m_jwtToken);
+}
+
+void UploadQueue::startItem(int index)
+{
+    Item &item = m_items[index];
+    item.state = State::Uploading;
+    item.bytesSent = 0;
+    emit itemStarted(index);
+
+    dispatch([this, index](const QString &token) { sendItem(index, token); });
+}
+
+void UploadQueue::sendItem(int index, const QString &token)
+{
+    if (token.isEmpty()) {
+        requeueItem(index);
+        return;
+    }
+
+    Item &item = m_items[index];
+    QFile *file = new QFile(item.uploadPath);
+    if (!file->open(QIODevice::ReadOnly)) {
+        delete file;
+        failItem(index, tr("Could not open file locally."));
+        startNext();
+        return;
+    }
+
+    QNetworkRequest request = uploadRequest(m_serverUrl, token);
+    RetryPolicy::markAttempt(request, item.attempts);
+    request.setRawHeader(RetryPolicy::IdempotencyHeader, item.idempotencyKey);
+    MultipartBody *body = uploadBody(file,
+                                     item.uploadName,
+                                     item.contentType,
+                                     item.serverPath,
+                                     item.contentEncoding,
+                                     item.metadata);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, body->contentType());
+    // Immer gedrosselt senden, damit geänderte Grenzen auch laufende Uploads treffen
+    ThrottledDevice *device = ThrottledDevice::wrap(request, body, &m_limiter);
+
+    // Eigener Timeout bei Stillstand: der Slot wird frei, RetryPolicy wiederholt
+    NetworkCall *call = NetworkCall::post(m_netManager, request, device, this, [this](QNetworkReply *reply) {
+        onReplyFinished(reply);
+    });
+    QNetworkReply *reply = call->reply();
+    m_active.insert(reply, index);
+
+    connect(reply,
+            &QNetworkReply::uploadProgress,
+            this,
+            [this, index, reply](qint64 bytesSent, qint64 bytesTotal) {
+                if (bytesTotal > 0 && bytesSent == bytesTotal && !m_sentAt.contains(reply))
+                    m_sentAt.insert(reply, m_elapsed.elapsed());
+                // bytesTotal enthält den Multipart-Overhead, wir rechnen auf die Dateigröße um
+                Item &item = m_items[index];
+                if (bytesTotal > 0)
+                    item.bytesSent = bytesSent * item.bytesTotal / bytesTotal;
+                emit itemProgress(index, item.bytesSent, item.bytesTotal);
+                emitProgress();
+            });
+}
+
+bool UploadQueue::isBatchable(const Item &item) const
+{
+    return m_batchFiles > 1 && !m_batchUnsupported && item.bytesTotal <= m_batchFileSize;
+}
+
+void UploadQueue::startBatch(int index)
+{
+    // Ab index weitere sendefertige kleine Dateien gleicher Priorität einsammeln;
+    // was noch übersprungen, nachgefragt oder vorbereitet werden muss, kommt später
+    const Priority priority = m_items.at(index).priority;
+    QList<int> indices{index};
+    qint64 bytes = m_items.at(index).bytesTotal;
+    for (int next = index + 1; next < m_items.size() && indices.size() < m_batchFiles; ++next) {
+        const Item &item = m_items.at(next);
+        if (item.state != State::Pending || item.priority != priority || !isBatchable(item)
+            || isWaitingForRetry(item))
+            continue;
+        if (m_index && m_index->contains(item.hash, item.serverPath))
+            continue;
+        if (m_index && m_askServer && !item.hash.isEmpty() && !item.serverChecked)
+            continue;
+        if (needsPreparation(item))
+            continue;
+        if (bytes + item.bytesTotal > m_batchBytes)
+            break;
+        indices.append(next);
+        bytes += item.bytesTotal;
+    }
+
+    if (indices.size() == 1) {
+        startItem(index);
+        return;
+    }
+
+    for (const int batched : std::as_const(indices)) {
+        Item &item = m_items[batched];
+        item.state = State::Uploading;
+        item.bytesSent = 0;
+        emit itemStarted(batched);
+    }
+    dispatch([this, indices](const QString &token) { sendBatch(indices, token); });
+}
+
+void UploadQueue::sendBatch(const QList<int> &indices, const QString &token)
+{
+    if (token.isEmpty()) {
+        for (const int index : indices)
+            requeueItem(index);
+        return;
+    }
+
+    // Dateien öffnet der Body erst beim Senden, hier nur prüfen, ob sie lesbar sind
+    QList<int> sent;
+    QList<MultipartBody::FilePart> parts;
+    int attempts = 0;
+    for (const int index : indices) {
+        const Item &item = m_items.at(index);
+        if (!QFileInfo(item.uploadPath).isReadable()) {
+            failItem(index, tr("Could not open file locally."));
+            continue;
+        }
+        parts.append({new QFile(item.uploadPath),
+                      item.uploadName,
+                      item.contentType,
+                      item.serverPath,
+                      item.contentEncoding,
+                      item.metadata,
+                      item.idempotencyKey});
+        sent.append(index);
+        attempts = std::max(attempts, item.attempts);
+    }
+    if (sent.isEmpty()) {
+        startNext();
+        return;
+    }
+
+    QNetworkRequest request = batchRequest(m_serverUrl, token);
+    RetryPolicy::markAttempt(request, attempts);
+    // Kein Schlüssel für den ganzen Batch: beim Retry kann er anders zusammengesetzt sein,
+    // jede Datei trägt ihren eigenen (Part-Header)
+    MultipartBody *body = new MultipartBody(parts);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, body->contentType());
+    ThrottledDevice *device = ThrottledDevice::wrap(request, body, &m_limiter);
+
+    NetworkCall *call = NetworkCall::post(m_netManager, request, device, this, [this](QNetworkReply *reply) {
+        onBatchFinished(reply);
+    });
+    QNetworkReply *reply = call->reply();
+    m_batches.insert(reply, sent);
+
+    connect(reply,
+            &QNetworkReply::uploadProgress,
+            this,
+            [this, reply](qint64 bytesSent, qint64 bytesTotal) {
+                if (bytesTotal <= 0)
+                    return;
+                if (bytesSent == bytesTotal && !m_sentAt.contains(reply))
+                    m_sentAt.insert(reply, m_elapsed.elapsed());
+
+                // Ohne Multipart-Overhead gerechnet, die Dateien liegen der Reihe nach im Body
+                const QList<int> indices = m_batches.value(reply);
+                qint64 files = 0;
+                for (const int index : indices)
+                    files += m_items.at(index).bytesTotal;
+                qint64 remaining = bytesSent * files / bytesTotal;
+                for (const int index : indices) {
+                    Item &item = m_items[index];
+                    const qint64 itemSent = std::min(item.bytesTotal, remaining);
+                    remaining -= itemSent;
+                    if (itemSent != item.bytesSent) {
+                        item.bytesSent = itemSent;
+                        emit itemProgress(index, item.bytesSent, item.bytesTotal);
+                    }
+                }
+                emitProgress();
+            });
+}
+
+void UploadQueue::startChunkedItem(int index)
+{
+    Item &item = m_items[index];
+    item.state = State::Uploading;
+    item.bytesSent = 0;
+
+    ChunkedUpload *upload = new ChunkedUpload(m_netManager,
+                                              m_serverUrl,
+                                              item.uploadPath,
+                                              item.uploadName,
+                                              item.serverPath,
+                                              m_chunkSize,
+                                              this);
+    upload->setDispatcher(m_dispatcher);
+    upload->setContentEncoding(item.contentEncoding);
+    upload->setMetadata(item.metadata);
+    upload->setBandwidthLimiter(&m_limiter);
+    upload->setIdempotencyKey(item.idempotencyKey);
+    if (!item.uploadId.isEmpty())
+        upload->setUploadId(item.uploadId);
+    m_chunked.insert(upload, index);
+    emit itemStarted(index);
+
+    connect(upload,
+            &ChunkedUpload::progress,
+            this,
+            [this, index](qint64 bytesSent, qint64 bytesTotal) {
+                Item &item = m_items[index];
+                item.bytesSent = bytesSent;
+                emit itemProgress(index, bytesSent, bytesTotal);
+                emitProgress();
+            });
+    connect(upload,
+            &ChunkedUpload::committed,
+            this,
+            [this, index](const QString &uploadId, qint64 offset) {
+                Item &item = m_items[index];
+                item.uploadId = uploadId;
+                item.committed = offset;
+                emit itemCommitted(index, uploadId, offset);
+            });
+    connect(upload, &ChunkedUpload::chunkResponse, &m_controller, &ConcurrencyController::addResponse);
+    connect(upload,
+            &ChunkedUpload::retrying,
+            this,
+            [this, index](int retry, int delayMs, const QString &reason) {
+                emit itemRetrying(index, retry, delayMs, reason);
+            });
+    connect(upload, &ChunkedUpload::authenticationRequired, this, &UploadQueue::onAuthenticationRequired);
+    connect(upload, &ChunkedUpload::serverUnreachable, this, &UploadQueue::serverUnreachable);
+    connect(upload, &ChunkedUpload::finished, this, [this, upload](bool ok, const QString &message) {
+        onChunkedFinished(upload, ok, message);
+    });
+
+    upload->start(m_jwtToken);
+}
+
+void UploadQueue::hashItem(int index)
+{
+    Item &item = m_items[index];
+    item.hash = m_index->cachedHash(item.filePath, item.fileSize, item.mtime);
+    if (!item.hash.isEmpty())
+        return;
+
+    // Hashing läuft parallel im globalen Thread-Pool
+    item.state = State::Hashing;
+    QtConcurrent::run(&FileHasher::hashFile, item.filePath).then(this, [this, index](QByteArray hash) {
+        onHashed(index, hash);
+    });
+}
+
+void UploadQueue::onHashed(int index, const QByteArray &hash)
+{
+    Item &item = m_items[index];
+    if (item.state != State::Hashing)
+        return;
+
+    item.hash = hash;
+    item.state = State::Pending;
+    // Dedup kann während des Laufs abgeschaltet werden (setIndex(nullptr))
+    if (m_index && !hash.isEmpty())
+        m_index->updateHash(item.filePath, item.fileSize, item.mtime, hash);
+    startNext();
+}
+
+bool UploadQueue::hasPreparation() const
+{
+    return m_validate || m_transcodeOptions.enabled || m_compress || m_sendMetadata || m_stripMetadata;
+}
+
+bool UploadQueue::needsPreparation(const Item &item) const
+{
+    return hasPreparation() && !item.prepared;
+}
+
+void UploadQueue::prepareAhead()
+{
+    if (!hasPreparation())
+        return;
+
+    // Nur ein Fenster vor den laufenden Uploads vorbereiten: so bleiben Speicher
+    // und temporäre Dateien begrenzt, die Uploads aber ständig versorgt
+    int window = 0;
+    if (m_interactive > 0)
+        prepareAhead(Priority::Interactive, window);
+    prepareAhead(Priority::Background, window);
+}
+
+void UploadQueue::prepareAhead(Priority priority, int &window)
+{
+    for (int index = m_nextIndex; index < m_items.size() && window < currentConcurrency()
+                                  && m_preparing < m_transcodePool.maxThreadCount();
+         ++index) {
+        const Item &item = m_items.at(index);
+        if (item.priority != priority)
+            continue;
+        if (item.state == State::Preparing) {
+            ++window;
+            continue;
+        }
+        if (item.state != State::Pending)
+            continue;
+        if (m_index && m_index->contains(item.hash, item.serverPath))
+            continue; // wird ohnehin übersprungen
+        if (m_index && m_askServer && !item.hash.isEmpty() && !item.serverChecked)
+            continue; // erst Server fragen
+
+        ++window;
+        if (needsPreparation(item))
+            prepareItem(index);
+    }
+}
+
+void UploadQueue::prepareItem(int index)
+{
+    Item &item = m_items[index];
+    item.state = State::Preparing;
+    ++m_preparing;
+
+    const QString filePath = item.filePath;
+    const ImageTranscoder::Options options = m_transcodeOptions;
+    const bool compress = m_compress;
+    const bool metadata = m_sendMetadata;
+    const bool strip = m_stripMetadata;
+    const bool validate = m_validate;
+    const QString outputDir = m_tempDir.path();
+
+    QtConcurrent::run(&m_transcodePool,
+                      [filePath, options, compress, metadata, strip, validate, outputDir]() {
+                          Preparation result;
+                          // Zuerst: eine kaputte Datei wird weder gelesen noch umgewandelt
+                          if (validate) {
+                              result.validated = true;
+                              result.validation = ImageValidator::validate(filePath);
+                              if (!result.validation.valid)
+                                  return result;
+                          }
+                          // Vom Original: neu kodierte Bilder haben kein EXIF mehr
+                          if (metadata) {
+                              const QJsonObject json = ExifReader::toJson(ExifReader::read(filePath));
+                              result.metadata = QJsonDocument(json).toJson(QJsonDocument::Compact);
+                          }
+                          if (options.enabled)
+                              result.image = ImageTranscoder::transcode(filePath, options, outputDir);
+                          // Neu kodierte Bilder sind bereits komprimiert
+                          if (compress && !result.image.transcoded)
+                              result.compressed = UploadCompressor::compress(filePath, outputDir);
+                          // Komprimiert wird nur BMP/TIFF, entfernt nur bei JPEG: schließt sich aus
+                          if (strip && !result.image.transcoded && !result.compressed.compressed)
+                              result.stripped = ExifReader::strip(filePath, outputDir);
+                          return result;
+                      })
+        .then(this, [this, index](const Preparation &result) { onPrepared(index, result); });
+}
+
+void UploadQueue::onPrepared(int index, const Preparation &result)
+{
+    --m_preparing;
+
+    Item &item = m_items[index];
+    item.prepared = true;
+    item.state = State::Pending;
+    m_nextIndex = std::min(m_nextIndex, index);
+
+    if (result.validated) {
+        if (!result.validation.valid) {
+            failItem(index, tr("rejected before upload: %1").arg(result.validation.error));
+            startNext();
+            return;
+        }
+        // Tatsächliches Format statt Endung (z.B. PNG unter .jpg)
+        item.contentType = result.validation.mimeType;
+    }
+
+    item.metadata = result.metadata;
+    const ImageTranscoder::Result &image = result.image;
+    const UploadCompressor::Result &compressed = result.compressed;
+    const ExifReader::StripResult &stripped = result.stripped;
+    if (image.transcoded) {
+        if (m_running)
+            m_bytesTotal += image.size - item.bytesTotal;
+        item.uploadPath = image.outputPath;
+        item.uploadName = image.fileName;
+        item.contentType = image.mimeType;
+        item.bytesTotal = image.size;
+    } else if (compressed.compressed) {
+        // Name und Content-Type bleiben, der Server dekodiert anhand von Content-Encoding
+        if (m_running)
+            m_bytesTotal += compressed.size - item.bytesTotal;
+        item.uploadPath = compressed.outputPath;
+        item.contentEncoding = UploadCompressor::Encoding;
+        item.bytesTotal = compressed.size;
+    } else if (stripped.stripped) {
+        if (m_running)
+            m_bytesTotal += stripped.size - item.bytesTotal;
+        item.uploadPath = stripped.outputPath;
+        item.bytesTotal = stripped.size;
+    } else if (!image.error.isEmpty()) {
+        item.message = tr("not transcoded: %1").arg(image.error);
+    } else if (!compressed.error.isEmpty()) {
+        item.message = tr("not compressed: %1").arg(compressed.error);
+    } else if (!stripped.error.isEmpty()) {
+        item.message = tr("metadata not removed: %1").arg(stripped.error);
+    }
+    startNext();
+}
+
+void UploadQueue::releaseUpload(Item &item)
+{
+    // Temporäre Ausgabe von Transcoding/Kompression wird nach dem Upload nicht mehr gebraucht
+    if (item.uploadPath != item.filePath) {
+        QFile::remove(item.uploadPath);
+        item.uploadPath = item.filePath;
+        item.contentEncoding.clear();
+    }
+}
+
+void UploadQueue::checkServer(int index)
+{
+    m_items[index].state = State::Checking;
+    dispatch([this, index](const QString &token) { sendCheck(index, token); });
+}
+
+void UploadQueue::sendCheck(int index, const QString &token)
+{
+    Item &item = m_items[index];
+    if (token.isEmpty()) {
+        // Ohne Token nicht fragen, der Upload behandelt die Anmeldung
+        item.serverChecked = true;
+        requeueItem(index);
+        return;
+    }
+
+    QUrl url(m_serverUrl + "/upload/exists");
+    QUrlQuery query;
+    query.addQueryItem("hash", QString::fromLatin1(item.hash.toHex()));
+    query.addQueryItem("path", item.serverPath);
+    url.setQuery(query);
+
+    QNetworkRequest request(url);
+    request.setRawHeader("Authorization", ("Bearer " + token).toUtf8());
+
+    NetworkCall *call = NetworkCall::get(m_netManager, request, this, [this](QNetworkReply *reply) {
+        onCheckFinished(reply);
+    });
+    m_checks.insert(call->reply(), index);
+}
+
+void UploadQueue::onCheckFinished(QNetworkReply *reply)
+{
+    const int index = m_checks.take(reply);
+
+    Item &item = m_items[index];
+    item.serverChecked = true;
+    reportUnreachable(reply);
+
+    // Fehler (auch 401/404) heißen nur "unbekannt", der Upload selbst kümmert sich darum
+    const bool exists = reply->error() == QNetworkReply::NoError
+                        && QJsonDocument::fromJson(reply->readAll()).object()["exists"].toBool();
+    if (exists) {
+        if (m_index)
+            m_index->recordUpload(item.filePath, item.fileSize, item.mtime, item.hash, item.serverPath);
+        skipItem(index);
+    } else {
+        item.state = State::Pending;
+        m_nextIndex = std::min(m_nextIndex, index);
+    }
+    startNext();
+}
+
+void UploadQueue::onReplyFinished(QNetworkReply *reply)
+{
+    const int index = m_active.take(reply);
+    const qint64 sentAt = m_sentAt.value(reply, -1);
+    m_sentAt.remove(reply);
+
+    const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    // Eigene Abbrüche nicht zählen, den Inaktivitäts-Timeout schon (Status 0 = Überlast)
+    if (reply->error() != QNetworkReply::OperationCanceledError
+        || reply->property(RetryPolicy::TimedOutProperty).toBool()) {
+        m_controller.addResponse(statusCode, sentAt >= 0 ? m_elapsed.elapsed() - sentAt : -1);
+    }
+
+    if (statusCode == 401) {
+        // Token vom Server abgelehnt: Item zurück in die Warteschlange, Queue anhalten
+        requeueItem(index);
+        return;
+    }
+
+    // Vorübergehend (auch Überlast, der Controller hat das Limit schon gesenkt): mit Backoff erneut,
+    // bei einem ausgefallenen Knoten nach dem Failover schon beim nächsten
+    reportUnreachable(reply);
+    if (RetryPolicy::isRetryable(reply) && scheduleRetry(index, reply)) {
+        startNext();
+        return;
+    }
+
+    if (reply->error() != QNetworkReply::NoError)
+        failItem(index, RetryPolicy::reason(reply) + " " + QString::fromUtf8(reply->readAll()));
+    else
+        completeItem(index);
+
+    startNext();
+}
+
+void UploadQueue::onBatchFinished(QNetworkReply *reply)
+{
+    const QList<int> indices = m_batches.take(reply);
+    const qint64 sentAt = m_sentAt.value(reply, -1);
+    m_sentAt.remove(reply);
+
+    const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    // Eigene Abbrüche nicht zählen, den Inaktivitäts-Timeout schon (Status 0 = Überlast)
+    if (reply->error() != QNetworkReply::OperationCanceledError
+        || reply->property(RetryPolicy::TimedOutProperty).toBool()) {
+        m_controller.addResponse(statusCode, sentAt >= 0 ? m_elapsed.elapsed() - sentAt : -1);
+    }
+
+    if (statusCode == 401) {
+        for (const int index : indices)
+            requeueItem(index);
+        return;
+    }
+
+    if (statusCode == 404 || statusCode == 405) {
+        // Server ohne /upload/batch: ab jetzt einzeln senden, ohne das als Versuch zu zählen
+        m_batchUnsupported = true;
+        for (const int index : indices) {
+            Item &item = m_items[index];
+            item.state = State::Pending;
+            item.bytesSent = 0;
+            m_nextIndex = std::min(m_nextIndex, index);
+        }
+        emitProgress();
+        startNext();
+        return;
+    }
+
+    if (reply->error() != QNetworkReply::NoError) {
+        reportUnreachable(reply);
+        const bool retryable = RetryPolicy::isRetryable(reply);
+        const QString error = RetryPolicy::reason(reply) + " " + QString::fromUtf8(reply->readAll());
+        for (const int index : indices) {
+            if (!retryable || !scheduleRetry(index, reply))
+                failItem(index, error);
+        }
+        startNext();
+        return;
+    }
+
+    // Ergebnis pro Datei, in der Reihenfolge der Parts
+    const QJsonArray results = QJsonDocument::fromJson(reply->readAll()).object()["results"].toArray();
+    for (qsizetype i = 0; i < indices.size(); ++i) {
+        const QJsonObject result = results.at(i).toObject();
+        if (result["status"].toString() == "ok")
+            completeItem(indices.at(i));
+        else if (result.contains("error"))
+            failItem(indices.at(i), result["error"].toString());
+        else
+            failItem(indices.at(i), tr("No result from server."));
+    }
+    startNext();
+}
+
+void UploadQueue::onWindow()
+{
+    if (!m_running) {
+        m_windowTimer.stop();
+        return;
+    }
+    const qint64 sent = bytesSent();
+    const qint64 elapsed = m_windowClock.restart();
+    m_controller.endWindow(sent - m_windowBytes,
+                           elapsed,
+                           m_active.size() + m_chunked.size() + m_batches.size());
+    m_windowBytes = sent;
+}
+
+void UploadQueue::onChunkedFinished(ChunkedUpload *upload, bool ok, const QString &message)
+{
+    const int index = m_chunked.take(upload);
+    upload->deleteLater();
+
+    if (ok)
+        completeItem(index);
+    else
+        failItem(index, message);
+
+    startNext();
+}
+
+void UploadQueue::requeueItem(int index)
+{
+    Item &item = m_items[index];
+    item.state = State::Pending;
+    item.bytesSent = 0;
+    ++item.attempts;
+    m_nextIndex = std::min(m_nextIndex, index);
+    onAuthenticationRequired();
+    emitProgress();
+}
+
+bool UploadQueue::isWaitingForRetry(const Item &item) const
+{
+    return item.retryAt > m_clock.elapsed();
+}
+
+bool UploadQueue::scheduleRetry(int index, const QNetworkReply *reply)
+{
+    Item &item = m_items[index];
+    if (item.retries >= MaxRetries)
+        return false;
+
+    ++item.retries;
+    ++item.attempts;
+    const int delayMs = RetryPolicy::delayMs(item.retries, reply);
+    item.state = State::Pending;
+    item.bytesSent = 0;
+    item.retryAt = m_clock.elapsed() + delayMs;
+    m_nextIndex = std::min(m_nextIndex, index);
+
+    emit itemRetrying(index, item.retries, delayMs, RetryPolicy::reason(reply));
+    emitProgress();
+    armRetryTimer();
+    return true;
+}
+
+void UploadQueue::armRetryTimer()
+{
+    // Frühesten Wiederholungszeitpunkt suchen; wartende Items halten m_nextIndex davor
+    const qint64 now = m_clock.elapsed();
+    qint64 next = -1;
+    for (int index = m_nextIndex; index < m_items.size(); ++index) {
+        const Item &item = m_items.at(index);
+        if (item.state == State::Pending && item.retryAt > now)
+            next = next < 0 ? item.retryAt : std::min(next, item.retryAt);
+    }
+    if (next >= 0)
+        m_retryTimer.start(int(next - now));
+}
+
+void UploadQueue::onAuthenticationRequired()
+{
+    if (!m_paused) {
+        m_paused = true;
+        emit authenticationRequired();
+    }
+}
+
+void UploadQueue::reportUnreachable(const QNetworkReply *reply)
+{
+    if (RetryPolicy::isUnreachable(reply))
+        emit serverUnreachable(reply->url().toString(), RetryPolicy::reason(reply));
+}
+
+void UploadQueue::finishItem(Item &item)
+{
+    releaseUpload(item);
+    if (item.priority == Priority::Interactive)
+        --m_interactive;
+}
+
+void UploadQueue::completeItem(int index)
+{
+    Item &item = m_items[index];
+    item.state = State::Done;
+    item.bytesSent = item.bytesTotal;
+    m_bytesDone += item.bytesTotal;
+    ++m_succeeded;
+    finishItem(item);
+    if (m_index && !item.hash.isEmpty())
+        m_index->recordUpload(item.filePath, item.fileSize, item.mtime, item.hash, item.serverPath);
+    emit itemFinished(index, true, QString());
+    emitProgress();
+}
+
+void UploadQueue::skipItem(int index)
+{
+    Item &item = m_items[index];
+    item.state = State::Skipped;
+    finishItem(item);
+    // Übersprungene Dateien zählen nicht zum Gesamtvolumen
+    m_bytesTotal -= item.bytesTotal;
+    ++m_skipped;
+    emit itemSkipped(index);
+    emitProgress();
+}
+
+void UploadQueue::failItem(int index, const QString &message)
+{
+    Item &item = m_items[index];
+    item.state = State::Failed;
+    item.bytesSent = 0;
+    item.message = message;
+    finishItem(item);
+    // Fehlgeschlagene Dateien zählen nicht mehr zum Gesamtvolumen
+    m_bytesTotal -= item.bytesTotal;
+    ++m_failed;
+    emit itemFinished(index, false, message);
+    emitProgress();
+}
+
+void UploadQueue::emitProgress()
+{
+    emit progress(bytesSent(), m_bytesTotal, bytesPerSecond());
+}
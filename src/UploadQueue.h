@@ -0,0 +1,283 @@
+/**
+ * @file UploadQueue.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief queue of pending uploads, sent with bounded parallelism
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QObject>
+#include <QString>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <QTimer>
+
+#include "Authorization.h"
+#include "BandwidthLimiter.h"
+#include "ConcurrencyController.h"
+#include "ExifReader.h"
+#include "ImageTranscoder.h"
+#include "ImageValidator.h"
+#include "MultipartBody.h"
+#include "RetryPolicy.h"
+#include "UploadCompressor.h"
+
+class ChunkedUpload;
+class UploadIndex;
+
+class UploadQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MaxAdaptiveConcurrency = 32;
+    // Vorübergehende Fehler (Timeout, Abbruch, 429/502/503/504): so oft mit Backoff erneut
+    // einreihen, bevor das Item als fehlgeschlagen gilt
+    static constexpr int MaxRetries = RetryPolicy::MaxRetries;
+    // Kleine Dateien gebündelt senden: Standardgrenzen pro Batch-Request
+    static constexpr int DefaultBatchFiles = 32;
+    static constexpr qint64 DefaultBatchBytes = 4 * 1024 * 1024;
+    static constexpr qint64 DefaultBatchFileSize = 256 * 1024;
+
+    enum class State { Pending, Hashing, Checking, Preparing, Uploading, Done, Skipped, Failed };
+    // Interaktive Einzel-Uploads werden vor Hintergrund-Batches gestartet
+    enum class Priority { Interactive, Background };
+
+    struct Item
+    {
+        QString filePath;
+        QString serverPath;
+        Priority priority = Priority::Background;
+        qint64 fileSize = 0;
+        qint64 mtime = 0;
+        QByteArray hash;
+        bool serverChecked = false;
+
+        // Was tatsächlich gesendet wird (nach Transcoding/Kompression ggf. eine temporäre Datei)
+        QString uploadPath;
+        QString uploadName;
+        QString contentType;
+        QByteArray contentEncoding; // leer oder "gzip"
+        QByteArray metadata;        // JSON aus EXIF/XMP der Originaldatei, leer = nicht senden
+        bool prepared = false;
+        // Chunked Session und vom Server bestätigter Offset (zum Fortsetzen)
+        QString uploadId;
+        qint64 committed = 0;
+        // Bleibt über alle Wiederholungen gleich, damit der Server Duplikate erkennt
+        QByteArray idempotencyKey;
+
+        qint64 bytesTotal = 0;
+        qint64 bytesSent = 0;
+        int attempts = 0; // Wiederholungen insgesamt (401 und vorübergehende Fehler)
+        int retries = 0;  // Wiederholungen nach vorübergehenden Fehlern
+        qint64 retryAt = 0; // m_clock in ms, vorher nicht erneut senden
+        State state = State::Pending;
+        QString message;
+    };
+
+    explicit UploadQueue(QNetworkAccessManager *manager, QObject *parent = nullptr);
+
+    // POST /upload: Request mit Bearer Token und multipart/form-data Body ("photo", "path").
+    // Der Body übernimmt file als Child, der Aufrufer den Body.
+    static QNetworkRequest uploadRequest(const QString &serverUrl, const QString &token);
+    // Mit contentEncoding bekommt der Datei-Part einen Content-Encoding Header,
+    // mit metadata folgt ein "metadata" Part (application/json)
+    static MultipartBody *uploadBody(QIODevice *file,
+                                     const QString &fileName,
+                                     const QString &contentType,
+                                     const QString &serverPath,
+                                     const QByteArray &contentEncoding = {},
+                                     const QByteArray &metadata = {});
+    // POST /upload/batch: mehrere "photo" Parts (je mit "path"), Antwort {"results":[...]}
+    // mit einem Ergebnis pro Datei in derselben Reihenfolge
+    static QNetworkRequest batchRequest(const QString &serverUrl, const QString &token);
+
+    // Auch mitten im Lauf (Failover): laufende Chunked Uploads wechseln sofort, alle
+    // anderen Requests ab dem nächsten Versuch
+    void setServerUrl(const QString &url);
+    void setToken(const QString &token);
+    // Ohne Dispatcher wird direkt mit dem per setToken gesetzten Token gesendet
+    void setDispatcher(const Authorization::Dispatcher &dispatcher);
+    // Feste Anzahl paralleler Uploads bzw. Startwert der adaptiven Steuerung
+    void setConcurrency(int concurrency);
+    int concurrency() const;
+    // Anzahl paralleler Uploads nach Durchsatz, Wartezeit und 429/503 regeln (1..MaxAdaptiveConcurrency)
+    void setAdaptiveConcurrency(bool enabled);
+    bool adaptiveConcurrency() const;
+    // Aktuell erlaubte parallele Uploads (fest oder vom Controller)
+    int currentConcurrency() const;
+    // Dateien größer als chunkSize werden fortsetzbar in Chunks gesendet (0 = aus)
+    void setChunkSize(qint64 chunkSize);
+    qint64 chunkSize() const;
+    // Dateien bis maxFileSize zu einem Request mit höchstens maxFiles Dateien bzw. maxBytes
+    // bündeln (maxFiles <= 1 = aus). Kennt der Server /upload/batch nicht, wird einzeln gesendet.
+    void setBatching(int maxFiles,
+                     qint64 maxBytes = DefaultBatchBytes,
+                     qint64 maxFileSize = DefaultBatchFileSize);
+    int batchFiles() const;
+    // Mit Index werden Dateien vorab parallel gehasht und bereits hochgeladene übersprungen
+    void setIndex(UploadIndex *index);
+    void setAskServer(bool askServer);
+    // Bilder vor dem Upload in einem Worker-Pool verkleinern/neu kodieren
+    void setTranscodeOptions(const ImageTranscoder::Options &options);
+    ImageTranscoder::Options transcodeOptions() const;
+    // Gut komprimierbare Dateien (unkomprimierte BMP/TIFF) gzip-kodiert senden
+    void setCompression(bool enabled);
+    bool compression() const;
+    // Aufnahmedaten (EXIF/XMP) im Worker-Pool lesen und als "metadata" Part mitsenden,
+    // damit der Server das Bild dafür nicht öffnen muss
+    void setSendMetadata(bool enabled);
+    bool sendMetadata() const;
+    // JPEGs ohne EXIF/XMP/IPTC senden (z.B. wegen GPS-Daten); die Metadaten gehen,
+    // falls eingeschaltet, trotzdem im "metadata" Part mit
+    void setStripMetadata(bool enabled);
+    bool stripMetadata() const;
+    // Vor dem Senden im Worker-Pool: Format aus den Magic Bytes (setzt den Content-Type)
+    // und Strukturprüfung (ImageValidator); kaputte Dateien scheitern, ohne ein Byte zu senden
+    void setValidation(bool enabled);
+    bool validation() const;
+    // Upload-Bandbreite in Bytes/s (0 = unbegrenzt), wirkt auch auf laufende Transfers
+    void setRateLimits(qint64 totalRate, qint64 transferRate);
+    qint64 rateLimit() const;
+    qint64 transferRateLimit() const;
+
+    int enqueue(const QString &filePath,
+                const QString &serverPath,
+                Priority priority = Priority::Background);
+    void start();
+    // Chunked Upload mit einer bestehenden Session fortsetzen (nach einem Neustart)
+    void setResumePoint(int index, const QString &uploadId, qint64 committed);
+
+    int count() const;
+    const Item &item(int index) const;
+    bool isRunning() const;
+    bool isPaused() const;
+
+    qint64 bytesTotal() const;
+    qint64 bytesSent() const;
+    double bytesPerSecond() const;
+
+signals:
+    void itemAdded(int index);
+    void itemStarted(int index);
+    void itemCommitted(int index, const QString &uploadId, qint64 offset);
+    void itemProgress(int index, qint64 bytesSent, qint64 bytesTotal);
+    void itemFinished(int index, bool ok, const QString &message);
+    void itemSkipped(int index);
+    // Vorübergehender Fehler: nächster Versuch (1..MaxRetries) in delayMs
+    void itemRetrying(int index, int retry, int delayMs, const QString &reason);
+    void progress(qint64 bytesSent, qint64 bytesTotal, double bytesPerSecond);
+    void authenticationRequired();
+    // Verbindungsfehler, Timeout, 502/504 (RetryPolicy::isUnreachable) für requestUrl
+    void serverUnreachable(const QString &requestUrl, const QString &reason);
+    void concurrencyChanged(int concurrency);
+    void finished(int succeeded, int skipped, int failed, qint64 bytes, qint64 elapsedMs);
+
+private:
+    // Ergebnis der Vorbereitung im Worker-Pool
+    struct Preparation
+    {
+        bool validated = false;
+        ImageValidator::Result validation;
+        ImageTranscoder::Result image;
+        UploadCompressor::Result compressed;
+        ExifReader::StripResult stripped;
+        QByteArray metadata;
+    };
+
+    void startNext();
+    void startPending(Priority priority);
+    void startItem(int index);
+    void sendItem(int index, const QString &token);
+    void startChunkedItem(int index);
+    bool isBatchable(const Item &item) const;
+    void startBatch(int index);
+    void sendBatch(const QList<int> &indices, const QString &token);
+    void hashItem(int index);
+    void onHashed(int index, const QByteArray &hash);
+    bool hasPreparation() const;
+    bool needsPreparation(const Item &item) const;
+    void prepareAhead();
+    void prepareAhead(Priority priority, int &window);
+    void prepareItem(int index);
+    void onPrepared(int index, const Preparation &result);
+    void releaseUpload(Item &item);
+    void checkServer(int index);
+    void sendCheck(int index, const QString &token);
+    void onCheckFinished(QNetworkReply *reply);
+    void dispatch(const Authorization::Call &call);
+    void requeueItem(int index);
+    bool isWaitingForRetry(const Item &item) const;
+    bool scheduleRetry(int index, const QNetworkReply *reply);
+    void armRetryTimer();
+    int activeCount() const;
+    void onReplyFinished(QNetworkReply *reply);
+    void onBatchFinished(QNetworkReply *reply);
+    void onWindow();
+    void onChunkedFinished(ChunkedUpload *upload, bool ok, const QString &message);
+    void onAuthenticationRequired();
+    void reportUnreachable(const QNetworkReply *reply);
+    void finishItem(Item &item);
+    void completeItem(int index);
+    void skipItem(int index);
+    void failItem(int index, const QString &message);
+    void emitProgress();
+
+    QNetworkAccessManager *m_netManager;
+    QString m_serverUrl;
+    QString m_jwtToken;
+    Authorization::Dispatcher m_dispatcher;
+    int m_concurrency = 4;
+    bool m_adaptive = false;
+    ConcurrencyController m_controller;
+    QTimer m_windowTimer;
+    QElapsedTimer m_windowClock;
+    qint64 m_windowBytes = 0;
+    QHash<QNetworkReply *, qint64> m_sentAt; // Body vollständig gesendet (m_elapsed)
+    QElapsedTimer m_clock;                   // monoton seit Erzeugung, für Item::retryAt
+    QTimer m_retryTimer;                     // weckt die Queue zum frühesten retryAt
+    qint64 m_chunkSize = 0;
+    int m_batchFiles = 1;
+    qint64 m_batchBytes = DefaultBatchBytes;
+    qint64 m_batchFileSize = DefaultBatchFileSize;
+    bool m_batchUnsupported = false; // Server hat /upload/batch mit 404/405 abgelehnt
+    UploadIndex *m_index = nullptr;
+    bool m_askServer = false;
+    ImageTranscoder::Options m_transcodeOptions;
+    bool m_compress = false;
+    bool m_sendMetadata = false;
+    bool m_stripMetadata = false;
+    bool m_validate = false;
+    BandwidthLimiter m_limiter;
+    QThreadPool m_transcodePool;
+    QTemporaryDir m_tempDir;
+    int m_preparing = 0;
+
+    QList<Item> m_items;
+    QHash<QNetworkReply *, int> m_active;
+    QHash<ChunkedUpload *, int> m_chunked;
+    QHash<QNetworkReply *, QList<int>> m_batches;
+    QHash<QNetworkReply *, int> m_checks;
+    int m_waitingForToken = 0;
+    int m_nextIndex = 0;
+    int m_interactive = 0; // noch offene interaktive Items
+    bool m_inStartNext = false;
+
+    bool m_running = false;
+    bool m_paused = false;
+    int m_succeeded = 0;
+    int m_skipped = 0;
+    int m_failed = 0;
+    qint64 m_bytesTotal = 0;
+    qint64 m_bytesDone = 0;
+    QElapsedTimer m_elapsed;
+};
@@ -0,0 +1,43 @@
+#include "Statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+QJsonObject Statistics::percentiles(QList<double> values)
+{
+    if (values.isEmpty())
+        return {};
+    std::sort(values.begin(), values.end());
+
+    const auto at = [&values](double p) {
+        const qsizetype index = static_cast<qsizetype>(std::ceil(p * values.size())) - 1;
+        return values.at(std::clamp<qsizetype>(index, 0, values.size() - 1));
+    };
+    double sum = 0;
+    for (const double value : std::as_const(values))
+        sum += value;
+
+    return {{"p50", at(0.50)},
+            {"p90", at(0.90)},
+            {"p99", at(0.99)},
+            {"max", values.last()},
+            {"mean", sum / values.size()}};
+}
+
+QJsonArray Statistics::histogram(const QList<double> &valuesMs)
+{
+    // Bucket i zählt Werte <= 2^i ms, Bucket 0 alles bis 1 ms
+    QList<qint64> counts;
+    for (const double value : valuesMs) {
+        const int bucket = value <= 1.0 ? 0 : static_cast<int>(std::ceil(std::log2(value)));
+        if (counts.size() <= bucket)
+            counts.resize(bucket + 1);
+        ++counts[bucket];
+    }
+
+    QJsonArray result;
+    for (qsizetype i = 0; i < counts.size(); ++i)
+        result.append(QJsonObject{{"leMs", std::ldexp(1.0, static_cast<int>(i))}, {"count", counts.at(i)}});
+    return result;
+}
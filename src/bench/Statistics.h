@@ -0,0 +1,25 @@
+/**
+ * @file Statistics.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief percentiles and latency histograms for benchmark and load reports
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+
+namespace Statistics {
+
+// {"p50","p90","p99","max","mean"} (leeres Objekt ohne Werte)
+QJsonObject percentiles(QList<double> values);
+
+// Buckets mit verdoppelter Obergrenze: [{"leMs": 1, "count"}, {"leMs": 2, ...}, ...]
+QJsonArray histogram(const QList<double> &valuesMs);
+
+} // namespace Statistics
@@ -0,0 +1,265 @@
+#include "UploadBenchmark.h"
+#include "Statistics.h"
+#include "../UploadEngine.h"
+#include "../mock/MockServerThread.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QRandomGenerator>
+#include <QTimer>
+
+#include <algorithm>
+#include <ctime>
+
+#ifdef Q_OS_UNIX
+#include <time.h>
+#endif
+
+#include "../includes/rz_config.hpp"
+
+namespace {
+constexpr double MB = 1024.0 * 1024.0;
+
+// CPU-Zeit aller Threads des Prozesses in ms
+double processCpuTimeMs()
+{
+#ifdef Q_OS_UNIX
+    timespec ts{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#else
+    return std::clock() * 1000.0 / CLOCKS_PER_SEC;
+#endif
+}
+} // namespace
+
+UploadBenchmark::UploadBenchmark(const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+{}
+
+UploadBenchmark::~UploadBenchmark()
+{
+    delete m_engine;
+    delete m_server;
+}
+
+QJsonObject UploadBenchmark::run()
+{
+    QJsonObject result{{"benchmark", "upload"},
+                       {"version", QString::fromStdString(PROJECT_VERSION)},
+                       {"qt", qVersion()},
+                       {"timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODate)}};
+
+    QString serverUrl = m_options.serverUrl;
+    if (serverUrl.isEmpty()) {
+        // Ohne Hashing: gemessen werden soll der Client, nicht BLAKE2b im Mock
+        MockCrowServer::Options serverOptions;
+        serverOptions.username = m_options.username;
+        serverOptions.password = m_options.password;
+        serverOptions.hashUploads = false;
+        serverOptions.bandwidth = m_options.bandwidth;
+        serverOptions.latency = m_options.latency;
+        serverOptions.maxUploads = m_options.maxUploads;
+        m_server = new MockServerThread(serverOptions);
+        if (!m_server->startServer()) {
+            result["error"] = "Could not start mock server";
+            return result;
+        }
+        serverUrl = m_server->url();
+        result["server"] = "in-process";
+    } else {
+        result["server"] = serverUrl;
+    }
+
+    // Eigener Index im Temp-Verzeichnis, Dedup aus: jede Datei wird wirklich gesendet
+    m_engine = new UploadEngine(m_tempDir.filePath("upload-index.dat"));
+    m_engine->setServerUrl(serverUrl);
+    m_engine->setDedup(false, false);
+    m_engine->queue()->setChunkSize(m_options.chunkSize);
+    m_engine->queue()->setBatching(m_options.batchFiles);
+
+    double loginMs = 0;
+    if (!login(&loginMs)) {
+        result["error"] = "Login failed";
+        return result;
+    }
+    result["loginMs"] = loginMs;
+
+    const QString smallFile = createFile(10 * 1024);
+    result["requestBuild"] = measureRequestBuild(smallFile);
+    QFile::remove(smallFile);
+
+    QJsonArray uploads;
+    for (const qint64 size : std::as_const(m_options.sizes)) {
+        const QString filePath = createFile(size);
+        if (filePath.isEmpty()) {
+            emit message(QString("Could not create a %1 byte test file, skipped").arg(size));
+            continue;
+        }
+        for (const int concurrency : std::as_const(m_options.concurrency))
+            uploads.append(measureUploads(filePath, size, concurrency));
+        QFile::remove(filePath);
+    }
+    result["uploads"] = uploads;
+
+    m_engine->logout();
+    return result;
+}
+
+bool UploadBenchmark::login(double *elapsedMs)
+{
+    QEventLoop loop;
+    bool ok = false;
+    connect(m_engine, &UploadEngine::loggedIn, &loop, [&]() {
+        ok = true;
+        loop.quit();
+    });
+    connect(m_engine, &UploadEngine::loginFailed, &loop, &QEventLoop::quit);
+    QTimer::singleShot(10000, &loop, &QEventLoop::quit);
+
+    QElapsedTimer timer;
+    timer.start();
+    m_engine->login(m_options.username, m_options.password);
+    loop.exec();
+    *elapsedMs = timer.nsecsElapsed() / 1e6;
+    return ok;
+}
+
+QJsonObject UploadBenchmark::measureRequestBuild(const QString &filePath) const
+{
+    // Kosten für Request + Multipart Body wie in UploadQueue::sendItem, ohne zu senden
+    const QString serverUrl = m_engine->serverUrl();
+    const QString token = QString(512, QChar('x'));
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < m_options.buildIterations; ++i) {
+        QFile *file = new QFile(filePath);
+        if (!file->open(QIODevice::ReadOnly)) {
+            const QString error = file->errorString();
+            delete file;
+            return {{"error", error}};
+        }
+        const QNetworkRequest request = UploadQueue::uploadRequest(serverUrl, token);
+        MultipartBody *body = UploadQueue::uploadBody(file, "bench.jpg", "image/jpeg", "bench");
+        delete body;
+    }
+    const qint64 ns = timer.nsecsElapsed();
+
+    return {{"iterations", m_options.buildIterations},
+            {"nsPerRequest", m_options.buildIterations > 0 ? ns / m_options.buildIterations : 0}};
+}
+
+QJsonObject UploadBenchmark::measureUploads(const QString &filePath, qint64 size, int concurrency)
+{
+    UploadQueue *queue = m_engine->queue();
+    // Adaptiv: Start bei 1, der Controller muss selbst hochfahren
+    const bool adaptive = concurrency <= 0;
+    queue->setConcurrency(adaptive ? 1 : concurrency);
+    queue->setAdaptiveConcurrency(adaptive);
+
+    const int minFiles = adaptive ? UploadQueue::MaxAdaptiveConcurrency : concurrency;
+    const int files = static_cast<int>(
+        std::clamp<qint64>(m_options.bytesPerRun / size, minFiles, std::max(m_options.maxFiles, minFiles)));
+
+    // Verbindungen hängen an context und verschwinden mit ihm
+    QObject context;
+    QEventLoop loop;
+    QHash<int, QElapsedTimer> started;
+    QList<double> latencies;
+    int failed = 0;
+
+    connect(queue, &UploadQueue::itemStarted, &context, [&](int index) { started[index].start(); });
+    connect(queue, &UploadQueue::itemFinished, &context, [&](int index, bool ok, const QString &) {
+        if (ok)
+            latencies.append(started.value(index).nsecsElapsed() / 1e6);
+        else
+            ++failed;
+    });
+    connect(queue, &UploadQueue::finished, &loop, &QEventLoop::quit);
+    connect(m_engine, &UploadEngine::sessionExpired, &loop, &QEventLoop::quit);
+
+    // Verlauf des adaptiven Limits: [ms seit Start, Limit]
+    QElapsedTimer wall;
+    QJsonArray trace;
+    connect(queue, &UploadQueue::concurrencyChanged, &context, [&](int limit) {
+        trace.append(QJsonArray{wall.isValid() ? wall.elapsed() : 0, limit});
+    });
+
+    for (int i = 0; i < files; ++i)
+        m_engine->enqueue({filePath}, QString(), "bench");
+
+    const double cpuStart = processCpuTimeMs();
+    const double serverCpuStart = serverCpuTimeMs();
+    wall.start();
+
+    m_engine->start();
+    loop.exec();
+
+    const double wallMs = wall.nsecsElapsed() / 1e6;
+    const double serverCpuMs = serverCpuTimeMs() - serverCpuStart;
+    const double clientCpuMs = processCpuTimeMs() - cpuStart - serverCpuMs;
+    const double megabytes = (files - failed) * size / MB;
+
+    QJsonObject result{{"size", size},
+                       {"concurrency", concurrency},
+                       {"files", files},
+                       {"batch", m_options.batchFiles},
+                       {"failed", failed},
+                       {"bytes", (files - failed) * size},
+                       {"wallMs", wallMs},
+                       {"mbPerSecond", wallMs > 0 ? megabytes / (wallMs / 1000.0) : 0},
+                       {"requestsPerSecond", wallMs > 0 ? (files - failed) / (wallMs / 1000.0) : 0},
+                       {"latencyMs", Statistics::percentiles(latencies)},
+                       {"clientCpuMsPerMB", megabytes > 0 ? clientCpuMs / megabytes : 0}};
+    if (m_server)
+        result["serverCpuMsPerMB"] = megabytes > 0 ? serverCpuMs / megabytes : 0;
+    if (adaptive) {
+        result["concurrency"] = "adaptive";
+        result["finalConcurrency"] = queue->currentConcurrency();
+        result["concurrencyTrace"] = trace;
+        queue->setAdaptiveConcurrency(false);
+    }
+
+    emit message(QString("%1 bytes x %2 @ %3: %4 MB/s, p50 %5 ms")
+                     .arg(size)
+                     .arg(files)
+                     .arg(adaptive ? QString("adaptive->%1").arg(result["finalConcurrency"].toInt())
+                                   : QString::number(concurrency))
+                     .arg(result["mbPerSecond"].toDouble(), 0, 'f', 1)
+                     .arg(result["latencyMs"].toObject()["p50"].toDouble(), 0, 'f', 1));
+    return result;
+}
+
+double UploadBenchmark::serverCpuTimeMs() const
+{
+    return m_server ? m_server->cpuTimeMs() : 0;
+}
+
+QString UploadBenchmark::createFile(qint64 size)
+{
+    // Zufallsdaten (nicht komprimierbar), blockweise geschrieben, damit auch 1 GB klein im RAM bleibt
+    QFile file(m_tempDir.filePath(QString("bench-%1.bin").arg(size)));
+    if (!file.open(QIODevice::WriteOnly))
+        return QString();
+
+    QList<quint32> block(256 * 1024);
+    QRandomGenerator::global()->fillRange(block.data(), block.size());
+    const qint64 blockBytes = block.size() * qint64(sizeof(quint32));
+
+    for (qint64 written = 0; written < size;) {
+        const qint64 length = std::min(blockBytes, size - written);
+        if (file.write(reinterpret_cast<const char *>(block.constData()), length) != length) {
+            file.remove();
+            return QString();
+        }
+        written += length;
+        block[written % block.size()] ^= QRandomGenerator::global()->generate();
+    }
+    return file.fileName();
+}
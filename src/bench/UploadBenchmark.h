@@ -0,0 +1,65 @@
+/**
+ * @file UploadBenchmark.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief measures request build cost, upload throughput, latency and CPU per MB
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QTemporaryDir>
+
+class MockServerThread;
+class UploadEngine;
+
+class UploadBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options
+    {
+        QString serverUrl; // leer: Mock Server im eigenen Thread starten
+        QString username = "admin";
+        QString password = "1234";
+        QList<qint64> sizes;
+        QList<int> concurrency; // 0 = adaptiv
+        // Nur für den eingebauten Mock Server: Leitung und Last simulieren
+        qint64 bandwidth = 0; // Bytes/s
+        int latency = 0;      // ms
+        int maxUploads = 0;
+        qint64 bytesPerRun = 256LL * 1024 * 1024; // so viele Bytes pro Messung (mind. eine Datei pro Slot)
+        int maxFiles = 200;
+        int buildIterations = 10000;
+        qint64 chunkSize = 0;
+        int batchFiles = 1;
+    };
+
+    explicit UploadBenchmark(const Options &options, QObject *parent = nullptr);
+    ~UploadBenchmark() override;
+
+    // Läuft blockierend (eigene Event Loops) und liefert das Ergebnis als JSON
+    QJsonObject run();
+
+signals:
+    void message(const QString &text);
+
+private:
+    bool login(double *elapsedMs);
+    QJsonObject measureRequestBuild(const QString &filePath) const;
+    QJsonObject measureUploads(const QString &filePath, qint64 size, int concurrency);
+    double serverCpuTimeMs() const;
+    QString createFile(qint64 size);
+
+    Options m_options;
+    QTemporaryDir m_tempDir;
+    MockServerThread *m_server = nullptr;
+    UploadEngine *m_engine = nullptr;
+};
@@ -0,0 +1,106 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+
+#include "UploadBenchmark.h"
+
+#include "../includes/rz_config.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+// "10K", "1M", "1G" oder Bytes
+qint64 parseSize(QString text)
+{
+    text = text.trimmed().toUpper();
+    qint64 factor = 1;
+    if (text.endsWith('K'))
+        factor = 1024;
+    else if (text.endsWith('M'))
+        factor = 1024 * 1024;
+    else if (text.endsWith('G'))
+        factor = 1024 * 1024 * 1024;
+    if (factor > 1)
+        text.chop(1);
+    return text.toLongLong() * factor;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationVersion(PROJECT_VERSION.c_str());
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Upload benchmark against an in-process mock Crow server (or --server).\n"
+        "Results are written as JSON to stdout or --output.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOptions({
+        {"server", "Benchmark against this server instead of the in-process mock.", "url"},
+        {"user", "Username.", "user", "admin"},
+        {"password", "Password.", "password", "1234"},
+        {"sizes", "Comma separated file sizes (K, M, G suffix).", "sizes", "10K,100K,1M,10M,100M,1G"},
+        {"concurrency",
+         "Comma separated concurrency levels, \"adaptive\" for the adaptive controller.",
+         "levels",
+         "1,4,8"},
+        {"bytes-per-run", "Bytes to upload per measurement (K, M, G suffix).", "size", "256M"},
+        {"max-files", "Upper limit of files per measurement.", "n", "200"},
+        {"iterations", "Iterations for the request build measurement.", "n", "10000"},
+        {"chunk-size", "Chunk size in MB for resumable uploads (0 = off).", "mb", "0"},
+        {"batch", "Pack up to n small files (up to 256 KB each) into one request (1 = off).", "n", "1"},
+        {"bandwidth", "In-process mock: simulated upload bandwidth in KB/s (0 = unlimited).", "kbps", "0"},
+        {"latency", "In-process mock: simulated delay before each response in ms.", "ms", "0"},
+        {"max-uploads", "In-process mock: 503 above this many concurrent uploads (0 = off).", "n", "0"},
+        {"output", "Write the JSON result to this file.", "file"},
+    });
+    parser.process(a);
+
+    UploadBenchmark::Options options;
+    options.serverUrl = parser.value("server");
+    options.username = parser.value("user");
+    options.password = parser.value("password");
+    for (const QString &size : parser.value("sizes").split(',', Qt::SkipEmptyParts)) {
+        if (const qint64 bytes = parseSize(size); bytes > 0)
+            options.sizes.append(bytes);
+    }
+    for (const QString &level : parser.value("concurrency").split(',', Qt::SkipEmptyParts)) {
+        if (level.trimmed() == "adaptive")
+            options.concurrency.append(0);
+        else if (const int concurrency = level.toInt(); concurrency > 0)
+            options.concurrency.append(concurrency);
+    }
+    options.bytesPerRun = parseSize(parser.value("bytes-per-run"));
+    options.maxFiles = parser.value("max-files").toInt();
+    options.buildIterations = parser.value("iterations").toInt();
+    options.chunkSize = parser.value("chunk-size").toLongLong() * 1024 * 1024;
+    options.batchFiles = std::max(1, parser.value("batch").toInt());
+    options.bandwidth = parser.value("bandwidth").toLongLong() * 1024;
+    options.latency = parser.value("latency").toInt();
+    options.maxUploads = parser.value("max-uploads").toInt();
+
+    if (options.sizes.isEmpty() || options.concurrency.isEmpty())
+        parser.showHelp(1);
+
+    UploadBenchmark benchmark(options);
+    QObject::connect(&benchmark, &UploadBenchmark::message, [](const QString &text) {
+        std::fprintf(stderr, "%s\n", qPrintable(text));
+    });
+
+    const QJsonObject result = benchmark.run();
+    const QByteArray json = QJsonDocument(result).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet("output")) {
+        QFile file(parser.value("output"));
+        if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size()) {
+            std::fprintf(stderr, "Could not write %s\n", qPrintable(file.fileName()));
+            return 1;
+        }
+    } else {
+        std::fwrite(json.constData(), 1, static_cast<size_t>(json.size()), stdout);
+    }
+    return result.contains("error") ? 1 : 0;
+}
@@ -0,0 +1,259 @@
+#include "CliUploader.h"
+#include "../ImageFiles.h"
+#include "../UploadEngine.h"
+
+#include <QFileInfo>
+#include <QJsonDocument>
+
+#include <cstdio>
+#include <utility>
+
+CliUploader::CliUploader(UploadEngine *engine, const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_engine(engine)
+    , m_options(options)
+{
+    m_progressTimer.setInterval(options.progressInterval);
+    connect(&m_progressTimer, &QTimer::timeout, this, &CliUploader::printProgress);
+}
+
+void CliUploader::run()
+{
+    m_elapsed.start();
+
+    UploadQueue *queue = m_engine->queue();
+    queue->setConcurrency(m_options.concurrency);
+    queue->setAdaptiveConcurrency(m_options.adaptive);
+    queue->setChunkSize(m_options.chunkSize);
+    queue->setBatching(m_options.batchFiles);
+    queue->setTranscodeOptions(m_options.transcode);
+    queue->setCompression(m_options.compress);
+    queue->setSendMetadata(m_options.metadata);
+    queue->setStripMetadata(m_options.stripMetadata);
+    queue->setValidation(m_options.validate);
+    queue->setRateLimits(m_options.rateLimit, m_options.transferRateLimit);
+    m_engine->telemetry()->setExportFile(m_options.metricsFile);
+    m_engine->setDedup(m_options.dedup, m_options.askServer);
+
+    // Verbindungsaufbau läuft parallel zum Einlesen der Ordner
+    m_engine->prewarm();
+
+    // Ordner rekursiv, die Unterordner-Struktur bleibt unter serverPath erhalten
+    int files = 0;
+    for (const QString &input : std::as_const(m_options.inputs)) {
+        const QFileInfo info(input);
+        if (m_options.sync) {
+            // Abgleich braucht das Manifest, also erst nach dem Login
+            if (!info.isDir()) {
+                printEvent("error", {{"message", "--sync expects folders: " + input}});
+                finish(UsageError);
+                return;
+            }
+            ++files;
+        } else if (info.isDir()) {
+            const QString root = info.absoluteFilePath();
+            files += m_engine->enqueue(ImageFiles::scanDirectory(root), root, m_options.serverPath);
+        } else if (info.isFile()) {
+            files += m_engine->enqueue({info.absoluteFilePath()}, QString(), m_options.serverPath);
+        } else {
+            printEvent("error", {{"message", "No such file or directory: " + input}});
+            finish(UsageError);
+            return;
+        }
+    }
+
+    if (!m_options.sync)
+        printEvent("queued", {{"files", files}});
+    if (files == 0) {
+        printMessage("No images found.");
+        finish(Success);
+        return;
+    }
+
+    connect(m_engine, &UploadEngine::message, this, &CliUploader::printMessage);
+    connect(m_engine, &UploadEngine::loggedIn, this, &CliUploader::onLoggedIn);
+    connect(m_engine, &UploadEngine::syncFinished, this, &CliUploader::onSyncFinished);
+    connect(m_engine, &UploadEngine::loginFailed, this, [this](const QString &reason) {
+        printEvent("error", {{"message", "Login failed: " + reason}});
+        finish(SessionFailed);
+    });
+    connect(m_engine, &UploadEngine::sessionExpired, this, [this]() {
+        printEvent("error", {{"message", "Session expired."}});
+        finish(SessionFailed);
+    });
+    connect(m_engine,
+            &UploadEngine::serverChanged,
+            this,
+            [this](const QString &name, const QString &url, const QString &reason) {
+                printEvent("server", {{"name", name}, {"url", url}, {"reason", reason}});
+            });
+
+    connect(queue, &UploadQueue::itemStarted, this, [this, queue](int index) {
+        printEvent("started", {{"index", index}, {"file", queue->item(index).filePath}});
+    });
+    connect(queue, &UploadQueue::itemFinished, this, [this, queue](int index, bool ok, const QString &message) {
+        const UploadQueue::Item &item = queue->item(index);
+        if (ok)
+            printEvent("done", {{"index", index}, {"file", item.filePath}, {"bytes", item.bytesTotal}});
+        else
+            printEvent("failed", {{"index", index}, {"file", item.filePath}, {"error", message}});
+    });
+    connect(queue,
+            &UploadQueue::itemRetrying,
+            this,
+            [this, queue](int index, int retry, int delayMs, const QString &reason) {
+                printEvent("retry",
+                           {{"index", index},
+                            {"file", queue->item(index).filePath},
+                            {"retry", retry},
+                            {"delayMs", delayMs},
+                            {"reason", reason}});
+            });
+    connect(queue, &UploadQueue::itemSkipped, this, [this, queue](int index) {
+        printEvent("skipped", {{"index", index}, {"file", queue->item(index).filePath}});
+    });
+    connect(queue, &UploadQueue::progress, this, [this](qint64 bytesSent, qint64 bytesTotal, double bytesPerSecond) {
+        // Nur merken, ausgegeben wird im festen Takt
+        m_bytesSent = bytesSent;
+        m_bytesTotal = bytesTotal;
+        m_bytesPerSecond = bytesPerSecond;
+        m_progressChanged = true;
+    });
+    connect(queue, &UploadQueue::finished, this, &CliUploader::onQueueFinished);
+
+    // Mehrere Knoten: erst nach der ersten Probenrunde einloggen, dann gleich beim schnellsten
+    ServerPool *servers = m_engine->servers();
+    if (!servers->hasProbed()) {
+        connect(
+            servers,
+            &ServerPool::probed,
+            this,
+            [this]() { m_engine->login(m_options.username, m_options.password); },
+            Qt::SingleShotConnection);
+        return;
+    }
+    m_engine->login(m_options.username, m_options.password);
+}
+
+void CliUploader::onLoggedIn()
+{
+    if (m_engine->queue()->isRunning())
+        return; // Resume nach erneutem Login macht die Engine selbst
+    if (m_options.sync && m_syncIndex < 0) {
+        m_syncIndex = 0;
+        syncNext();
+        return;
+    }
+
+    if (m_options.progressInterval > 0)
+        m_progressTimer.start();
+    m_engine->start();
+}
+
+void CliUploader::syncNext()
+{
+    if (m_syncIndex < m_options.inputs.size()) {
+        const QString root = QFileInfo(m_options.inputs.at(m_syncIndex++)).absoluteFilePath();
+        if (!m_engine->sync(root, m_options.serverPath)) {
+            printEvent("error", {{"message", "Sync already running."}});
+            finish(UsageError);
+        }
+        return;
+    }
+
+    // Alle Ordner abgeglichen: hochladen, was neu oder geändert ist
+    const int files = m_engine->queue()->count();
+    printEvent("queued", {{"files", files}});
+    if (files == 0) {
+        printMessage("Everything is up to date.");
+        finish(Success);
+        return;
+    }
+    onLoggedIn();
+}
+
+void CliUploader::onSyncFinished(int queued, int unchanged, const QString &error)
+{
+    if (!error.isEmpty()) {
+        printEvent("error", {{"message", "Sync failed: " + error}});
+        finish(UploadsFailed);
+        return;
+    }
+    printEvent("synced",
+               {{"folder", QFileInfo(m_options.inputs.at(m_syncIndex - 1)).absoluteFilePath()},
+                {"queued", queued},
+                {"unchanged", unchanged}});
+    syncNext();
+}
+
+void CliUploader::printProgress()
+{
+    if (!m_progressChanged)
+        return;
+    m_progressChanged = false;
+
+    printEvent("progress",
+               {{"bytesSent", m_bytesSent},
+                {"bytesTotal", m_bytesTotal},
+                {"bytesPerSecond", qRound64(m_bytesPerSecond)}});
+}
+
+void CliUploader::onQueueFinished(int succeeded, int skipped, int failed, qint64 bytes, qint64 elapsedMs)
+{
+    printProgress();
+    printEvent("summary",
+               {{"succeeded", succeeded},
+                {"skipped", skipped},
+                {"failed", failed},
+                {"bytes", bytes},
+                {"uploadMs", elapsedMs}});
+    finish(failed > 0 ? UploadsFailed : Success);
+}
+
+void CliUploader::finish(int exitCode)
+{
+    if (m_finishing)
+        return;
+    m_finishing = true;
+    m_exitCode = exitCode;
+    m_progressTimer.stop();
+
+    if (!m_engine->isLoggedIn()) {
+        quit();
+        return;
+    }
+
+    // Refresh Token beim Server invalidieren, aber nicht ewig auf die Antwort warten
+    NetworkCall *call = m_engine->logout();
+    if (!call) {
+        quit();
+        return;
+    }
+    call->setTimeout(5000);
+    connect(call, &NetworkCall::finished, this, &CliUploader::quit);
+}
+
+void CliUploader::quit()
+{
+    if (m_done)
+        return;
+    m_done = true;
+    if (!m_options.metricsFile.isEmpty() && !m_engine->telemetry()->exportNow())
+        printMessage("Could not write metrics to " + m_options.metricsFile);
+    emit done(m_exitCode);
+}
+
+void CliUploader::printEvent(const QString &event, QJsonObject fields)
+{
+    // JSON Lines: ein Objekt pro Zeile, sofort geflusht (für Pipes und Logfiles aus cron)
+    fields["event"] = event;
+    fields["elapsedMs"] = m_elapsed.elapsed();
+    const QByteArray line = QJsonDocument(fields).toJson(QJsonDocument::Compact) + '\n';
+    std::fwrite(line.constData(), 1, static_cast<size_t>(line.size()), stdout);
+    std::fflush(stdout);
+}
+
+void CliUploader::printMessage(const QString &text)
+{
+    std::fprintf(stderr, "%s\n", qPrintable(text));
+}
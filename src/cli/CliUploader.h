@@ -0,0 +1,89 @@
+/**
+ * @file CliUploader.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief headless upload run: login, upload, logout, JSON Lines progress on stdout
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include "../ImageTranscoder.h"
+
+class UploadEngine;
+
+class CliUploader : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum ExitCode { Success = 0, UploadsFailed = 1, SessionFailed = 2, UsageError = 3 };
+
+    struct Options
+    {
+        QString username;
+        QString password;
+        QStringList inputs; // Dateien und/oder Ordner
+        QString serverPath;
+        int concurrency = 4;
+        bool adaptive = false;
+        qint64 chunkSize = 0;
+        int batchFiles = 1; // kleine Dateien pro Request, 1 = einzeln
+        bool sync = false;  // Ordner mit dem Server-Manifest abgleichen statt alles zu senden
+        bool dedup = true;
+        bool askServer = false;
+        ImageTranscoder::Options transcode;
+        bool compress = false;
+        bool metadata = false;      // EXIF/XMP als "metadata" Part mitsenden
+        bool stripMetadata = false; // JPEGs ohne EXIF/XMP/IPTC senden
+        bool validate = true;       // Format und Struktur vor dem Senden prüfen
+        qint64 rateLimit = 0;         // Bytes/s über alle Uploads, 0 = unbegrenzt
+        qint64 transferRateLimit = 0; // Bytes/s pro Upload
+        QString metricsFile; // Telemetrie am Ende (und alle 10 s) schreiben
+        int progressInterval = 1000; // ms, 0 = keine Fortschrittszeilen
+    };
+
+    CliUploader(UploadEngine *engine, const Options &options, QObject *parent = nullptr);
+
+    // Dateien einsammeln und einloggen; am Ende kommt genau ein done()
+    void run();
+
+signals:
+    void done(int exitCode);
+
+private:
+    void onLoggedIn();
+    void syncNext();
+    void onSyncFinished(int queued, int unchanged, const QString &error);
+    void onQueueFinished(int succeeded, int skipped, int failed, qint64 bytes, qint64 elapsedMs);
+    void printProgress();
+    void finish(int exitCode);
+    void quit();
+
+    void printEvent(const QString &event, QJsonObject fields = {});
+    static void printMessage(const QString &text);
+
+    UploadEngine *m_engine;
+    Options m_options;
+    QTimer m_progressTimer;
+    QElapsedTimer m_elapsed;
+
+    qint64 m_bytesSent = 0;
+    qint64 m_bytesTotal = 0;
+    double m_bytesPerSecond = 0;
+    bool m_progressChanged = false;
+
+    int m_syncIndex = -1; // nächster abzugleichender Ordner, -1 = Sync noch nicht begonnen
+    int m_exitCode = Success;
+    bool m_finishing = false;
+    bool m_done = false;
+};
@@ -0,0 +1,127 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QSettings>
+#include <QTimer>
+
+#include "../UploadEngine.h"
+#include "CliUploader.h"
+
+#include "../includes/rz_config.hpp"
+
+#include <algorithm>
+
+int main(int argc, char *argv[]) {
+    QCoreApplication a(argc, argv);
+    // Gleiche Settings und gleicher Upload-Index wie die GUI
+    QCoreApplication::setApplicationName(PROJECT_NAME.c_str());
+    QCoreApplication::setApplicationVersion(PROJECT_VERSION.c_str());
+
+    QSettings settings;
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Upload images to the Crow server without a GUI.\n"
+        "Progress is written to stdout as JSON Lines, log messages to stderr.\n"
+        "The password can also be passed in the CROW_PASSWORD environment variable.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("paths", "Image files or folders (recursive).", "paths...");
+    parser.addOptions({
+        {{"s", "server"},
+         "Server URL as [name=]URL, optionally with user[:password]@. Repeat for several nodes: "
+         "the fastest reachable one is used, with failover (default: servers of the GUI).",
+         "url"},
+        {{"u", "user"}, "Username.", "user", qEnvironmentVariable("CROW_USER", "admin")},
+        {{"p", "password"}, "Password.", "password"},
+        {{"t", "target"}, "Target folder on the server.", "path"},
+        {{"j", "concurrency"},
+         "Number of parallel uploads.",
+         "n",
+         settings.value("Concurrency", 4).toString()},
+        {"adaptive", "Adapt the number of parallel uploads to the link (starts at --concurrency)."},
+        {"chunk-size",
+         "Chunk size in MB for resumable uploads (0 = off).",
+         "mb",
+         settings.value("ChunkSize", 0).toString()},
+        {"batch",
+         "Pack up to n small files (up to 256 KB each) into one request (1 = off).",
+         "n",
+         QString::number(settings.value("BatchUploads", false).toBool() ? UploadQueue::DefaultBatchFiles
+                                                                         : 1)},
+        {"sync",
+         "Folders only: upload just the files that are new or changed compared with the "
+         "server manifest of --target."},
+        {"no-dedup", "Do not skip already uploaded files."},
+        {"ask-server", "Ask the server for already known files."},
+        {"index", "Upload index file.", "file", UploadIndex::defaultLocation()},
+        {"downscale", "Downscale images to this maximum edge length in pixels.", "pixels"},
+        {"quality", "Encoder quality for downscaled images.", "1-100", "85"},
+        {"format", "Output format for downscaled images (jpg, webp, png).", "format", "jpg"},
+        {"compress", "Send compressible files (uncompressed BMP/TIFF) gzip-encoded."},
+        {"metadata", "Read capture date, camera, GPS and orientation locally and send them as JSON."},
+        {"strip-metadata", "Remove EXIF/XMP/IPTC from uploaded JPEGs."},
+        {"no-validate",
+         "Do not check format and structure (JPEG markers, PNG CRCs, TIFF bounds) before sending."},
+        {"limit-rate",
+         "Upload limit over all transfers in KB/s (0 = unlimited).",
+         "kbps",
+         settings.value("RateLimit", 0).toString()},
+        {"limit-rate-per-transfer",
+         "Upload limit per transfer in KB/s (0 = unlimited).",
+         "kbps",
+         settings.value("RateLimitPerTransfer", 0).toString()},
+        {"metrics", "Write request telemetry to this file (*.json or Prometheus text).", "file"},
+        {"progress-interval", "Milliseconds between progress lines (0 = off).", "ms", "1000"},
+    });
+    parser.process(a);
+
+    CliUploader::Options options;
+    options.username = parser.value("user");
+    options.password = parser.isSet("password") ? parser.value("password")
+                                                : qEnvironmentVariable("CROW_PASSWORD");
+    options.inputs = parser.positionalArguments();
+    options.serverPath = parser.value("target");
+    options.concurrency = std::max(1, parser.value("concurrency").toInt());
+    options.adaptive = parser.isSet("adaptive") || settings.value("AdaptiveConcurrency", false).toBool();
+    options.chunkSize = parser.value("chunk-size").toLongLong() * 1024 * 1024;
+    options.batchFiles = std::max(1, parser.value("batch").toInt());
+    options.sync = parser.isSet("sync");
+    options.dedup = !parser.isSet("no-dedup");
+    options.askServer = parser.isSet("ask-server");
+    options.transcode.enabled = parser.isSet("downscale");
+    options.transcode.maxEdge = parser.value("downscale").toInt();
+    options.transcode.quality = parser.value("quality").toInt();
+    options.transcode.format = parser.value("format").toLatin1();
+    options.compress = parser.isSet("compress");
+    options.metadata = parser.isSet("metadata");
+    options.stripMetadata = parser.isSet("strip-metadata");
+    options.validate = !parser.isSet("no-validate");
+    options.rateLimit = std::max<qint64>(0, parser.value("limit-rate").toLongLong()) * 1024;
+    options.transferRateLimit = std::max<qint64>(0, parser.value("limit-rate-per-transfer").toLongLong())
+                                * 1024;
+    options.metricsFile = parser.value("metrics");
+    options.progressInterval = parser.value("progress-interval").toInt();
+
+    if (options.inputs.isEmpty() || options.password.isEmpty()
+        || (options.transcode.enabled && options.transcode.maxEdge <= 0)) {
+        parser.showHelp(CliUploader::UsageError);
+    }
+
+    QStringList servers = parser.values("server");
+    if (servers.isEmpty())
+        servers = settings.value("Servers").toStringList();
+    if (servers.isEmpty())
+        servers.append(settings.value("Server", "http://localhost:8080").toString());
+    QList<ServerPool::Server> profiles;
+    for (const QString &spec : std::as_const(servers))
+        profiles.append(ServerPool::parse(spec));
+
+    UploadEngine engine(parser.value("index"));
+    engine.setServers(profiles);
+
+    CliUploader uploader(&engine, options);
+    QObject::connect(&uploader, &CliUploader::done, &a, &QCoreApplication::exit, Qt::QueuedConnection);
+    QTimer::singleShot(0, &uploader, &CliUploader::run);
+
+    return a.exec();
+}
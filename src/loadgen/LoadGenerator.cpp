@@ -0,0 +1,304 @@
+#include "LoadGenerator.h"
+#include "../UploadEngine.h"
+#include "../bench/Statistics.h"
+#include "../mock/MockServerThread.h"
+
+#include <QDateTime>
+#include <QEventLoop>
+#include <QHostAddress>
+#include <QPointer>
+#include <QRandomGenerator>
+#include <QUrl>
+
+#include <algorithm>
+#include <cmath>
+
+#include "../includes/rz_config.hpp"
+
+LoadGenerator::LoadGenerator(const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+{
+    m_arrivalTimer.setSingleShot(true);
+    m_arrivalTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_arrivalTimer, &QTimer::timeout, this, &LoadGenerator::onArrival);
+}
+
+LoadGenerator::~LoadGenerator()
+{
+    // Erst die Clients, dann der Server
+    for (const VirtualUser &user : std::as_const(m_users))
+        delete user.engine;
+    delete m_server;
+}
+
+bool LoadGenerator::isLocalServer(const QString &url)
+{
+    const QString host = QUrl(url).host();
+    return host == "localhost" || QHostAddress(host).isLoopback();
+}
+
+bool LoadGenerator::waitUntil(const std::function<bool()> &done, int timeoutMs)
+{
+    if (done())
+        return true;
+
+    QEventLoop loop;
+    QTimer poll;
+    connect(&poll, &QTimer::timeout, &loop, [&]() {
+        if (done())
+            loop.quit();
+    });
+    poll.start(50);
+    QTimer::singleShot(timeoutMs, &loop, &QEventLoop::quit);
+    loop.exec();
+    return done();
+}
+
+QJsonObject LoadGenerator::run()
+{
+    m_clock.start();
+    QJsonObject result{{"loadgen", QString::fromStdString(PROJECT_VERSION)},
+                       {"timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODate)}};
+
+    emit message("Generating images...");
+    if (!m_tempDir.isValid()
+        || !m_images.generate(m_options.images, m_options.variants, m_options.quality, m_tempDir.path())) {
+        result["error"] = "Could not generate images";
+        return result;
+    }
+
+    QString serverUrl = m_options.serverUrl;
+    if (serverUrl.isEmpty()) {
+        MockCrowServer::Options serverOptions;
+        serverOptions.username = m_options.username;
+        serverOptions.password = m_options.password;
+        serverOptions.tokenLifetime = m_options.tokenLifetime;
+        serverOptions.hashUploads = false;
+        m_server = new MockServerThread(serverOptions);
+        if (!m_server->startServer()) {
+            result["error"] = "Could not start mock server";
+            return result;
+        }
+        serverUrl = m_server->url();
+        result["server"] = "in-process";
+    } else if (!isLocalServer(serverUrl)) {
+        result["error"] = "Load generation is only allowed against localhost";
+        return result;
+    } else {
+        result["server"] = serverUrl;
+    }
+
+    // Jeder virtuelle Benutzer ist ein eigener Client: eigener QNetworkAccessManager,
+    // eigene Tokens und eigener Refresh-Zyklus
+    for (int i = 0; i < m_options.users; ++i) {
+        VirtualUser user;
+        user.engine = new UploadEngine(m_tempDir.filePath(QString("index-%1.dat").arg(i)));
+        user.engine->setServerUrl(serverUrl);
+        user.engine->setDedup(false, false);
+        user.engine->queue()->setConcurrency(m_options.userConcurrency);
+        m_users.append(user);
+        connectUser(i);
+    }
+
+    emit message(QString("Logging in %1 virtual users...").arg(m_options.users));
+    if (!loginUsers()) {
+        result["error"] = "No virtual user could log in";
+        logoutUsers();
+        return result;
+    }
+
+    emit message(QString("Generating load for %1 s...").arg(m_options.duration));
+    const qint64 loadStartNs = m_clock.nsecsElapsed();
+    m_arriving = true;
+    scheduleArrival();
+    waitUntil([]() { return false; }, m_options.duration * 1000);
+    m_arriving = false;
+    m_arrivalTimer.stop();
+    const qint64 loadEndNs = m_clock.nsecsElapsed();
+
+    emit message(QString("Waiting for %1 uploads in flight...").arg(m_inFlight));
+    waitUntil([this]() { return m_inFlight == 0; }, m_options.drainTimeout * 1000);
+
+    logoutUsers();
+
+    const QJsonObject load = report(std::max(loadEndNs, m_lastFinishedNs) - loadStartNs);
+    for (auto it = load.constBegin(); it != load.constEnd(); ++it)
+        result.insert(it.key(), it.value());
+    return result;
+}
+
+void LoadGenerator::connectUser(int userIndex)
+{
+    UploadEngine *engine = m_users.at(userIndex).engine;
+    UploadQueue *queue = engine->queue();
+
+    connect(engine, &UploadEngine::loggedIn, this, [this, userIndex]() {
+        VirtualUser &user = m_users[userIndex];
+        if (m_loginsPending > 0 && user.loginStartedNs > 0) {
+            m_loginLatencies.append((m_clock.nsecsElapsed() - user.loginStartedNs) / 1e6);
+            user.loginStartedNs = 0;
+            --m_loginsPending;
+        }
+        user.loggedIn = true;
+    });
+    connect(engine, &UploadEngine::loginFailed, this, [this, userIndex](const QString &reason) {
+        VirtualUser &user = m_users[userIndex];
+        ++m_errors["login: " + reason];
+        if (m_loginsPending > 0 && user.loginStartedNs > 0) {
+            user.loginStartedNs = 0;
+            ++m_loginFailures;
+            --m_loginsPending;
+        }
+    });
+    connect(engine, &UploadEngine::tokenRefreshed, this, [this]() { ++m_refreshes; });
+    connect(engine, &UploadEngine::sessionExpired, this, [this, userIndex]() {
+        // Wie ein Benutzer: neu einloggen, die Engine setzt die Queue danach fort
+        ++m_sessionsExpired;
+        VirtualUser &user = m_users[userIndex];
+        user.loggedIn = false;
+        if (m_arriving || m_inFlight > 0)
+            user.engine->login(m_options.username, m_options.password);
+    });
+
+    connect(queue, &UploadQueue::itemStarted, this, [this, userIndex](int index) {
+        auto it = m_users[userIndex].uploads.find(index);
+        if (it != m_users[userIndex].uploads.end())
+            it->startedNs = m_clock.nsecsElapsed();
+    });
+    connect(queue, &UploadQueue::itemFinished, this, [this, userIndex](int index, bool ok, const QString &message) {
+        onUploadFinished(userIndex, index, ok, message);
+    });
+}
+
+bool LoadGenerator::loginUsers()
+{
+    m_loginsPending = m_users.size();
+    for (VirtualUser &user : m_users) {
+        user.loginStartedNs = m_clock.nsecsElapsed();
+        user.engine->login(m_options.username, m_options.password);
+    }
+    waitUntil([this]() { return m_loginsPending == 0; }, 30000);
+
+    // Wer bis hierher nicht geantwortet hat, zählt als fehlgeschlagen
+    m_loginFailures += m_loginsPending;
+    m_loginsPending = 0;
+    return m_loginFailures < m_users.size();
+}
+
+void LoadGenerator::logoutUsers()
+{
+    int pending = 0;
+    QList<QPointer<NetworkCall>> calls;
+    for (const VirtualUser &user : std::as_const(m_users)) {
+        // Ab hier keine Messwerte und kein automatisches Neu-Einloggen mehr
+        user.engine->disconnect(this);
+        user.engine->queue()->disconnect(this);
+        if (!user.engine->isLoggedIn())
+            continue;
+        NetworkCall *call = user.engine->logout();
+        if (!call)
+            continue;
+        ++pending;
+        call->setTimeout(5000);
+        connect(call, &NetworkCall::finished, this, [&pending]() { --pending; });
+        calls.append(call);
+    }
+    waitUntil([&pending]() { return pending <= 0; }, 5000);
+
+    // pending lebt nur bis hier
+    for (const QPointer<NetworkCall> &call : std::as_const(calls)) {
+        if (call)
+            call->disconnect(this);
+    }
+}
+
+void LoadGenerator::scheduleArrival()
+{
+    if (!m_arriving || m_options.rate <= 0)
+        return;
+
+    // Poisson: exponentialverteilte Abstände, Constant: fester Takt
+    double intervalMs = 1000.0 / m_options.rate;
+    if (m_options.arrival == Arrival::Poisson)
+        intervalMs *= -std::log(1.0 - QRandomGenerator::global()->generateDouble());
+    m_arrivalTimer.start(static_cast<int>(std::round(intervalMs)));
+}
+
+void LoadGenerator::onArrival()
+{
+    const int userIndex = QRandomGenerator::global()->bounded(m_users.size());
+    VirtualUser &user = m_users[userIndex];
+    const SyntheticImages::Image &image = m_images.pick();
+
+    const int index = user.engine->queue()->count();
+    user.engine->enqueue({image.filePath}, QString(), QString("loadgen/user-%1").arg(userIndex));
+    user.uploads.insert(index, {m_clock.nsecsElapsed(), 0, image.size});
+    ++m_arrivals;
+    ++m_inFlight;
+    user.engine->start();
+
+    scheduleArrival();
+}
+
+void LoadGenerator::onUploadFinished(int userIndex, int index, bool ok, const QString &message)
+{
+    const auto it = m_users[userIndex].uploads.constFind(index);
+    if (it == m_users[userIndex].uploads.constEnd())
+        return;
+    const Upload upload = *it;
+    m_users[userIndex].uploads.erase(it);
+
+    const qint64 now = m_clock.nsecsElapsed();
+    m_lastFinishedNs = std::max(m_lastFinishedNs, now);
+    --m_inFlight;
+
+    if (ok) {
+        ++m_completed;
+        m_bytes += upload.size;
+        m_latencies.append((now - upload.arrivedNs) / 1e6);
+        if (upload.startedNs > 0)
+            m_serviceLatencies.append((now - upload.startedNs) / 1e6);
+    } else {
+        ++m_failed;
+        ++m_errors[message];
+    }
+}
+
+QJsonObject LoadGenerator::report(qint64 elapsedNs) const
+{
+    const double seconds = elapsedNs / 1e9;
+
+    QJsonObject errors;
+    for (auto it = m_errors.constBegin(); it != m_errors.constEnd(); ++it)
+        errors[it.key()] = it.value();
+
+    const QJsonObject options{{"users", m_options.users},
+                              {"userConcurrency", m_options.userConcurrency},
+                              {"rate", m_options.rate},
+                              {"arrival", m_options.arrival == Arrival::Poisson ? "poisson" : "constant"},
+                              {"durationS", m_options.duration},
+                              {"imageBytes", m_images.totalSize()}};
+
+    const QJsonObject logins{{"ok", static_cast<int>(m_users.size()) - m_loginFailures},
+                             {"failed", m_loginFailures},
+                             {"latencyMs", Statistics::percentiles(m_loginLatencies)}};
+
+    const int finished = m_completed + m_failed;
+    return {{"options", options},
+            {"logins", logins},
+            {"refreshes", m_refreshes},
+            {"sessionsExpired", m_sessionsExpired},
+            {"arrivals", m_arrivals},
+            {"completed", m_completed},
+            {"failed", m_failed},
+            {"unfinished", m_inFlight},
+            {"errorRate", finished > 0 ? double(m_failed) / finished : 0},
+            {"elapsedMs", elapsedNs / 1e6},
+            {"uploadsPerSecond", seconds > 0 ? m_completed / seconds : 0},
+            {"mbPerSecond", seconds > 0 ? m_bytes / (1024.0 * 1024.0) / seconds : 0},
+            {"latencyMs", Statistics::percentiles(m_latencies)},
+            {"serviceLatencyMs", Statistics::percentiles(m_serviceLatencies)},
+            {"latencyHistogram", Statistics::histogram(m_latencies)},
+            {"errors", errors}};
+}
@@ -0,0 +1,115 @@
+/**
+ * @file LoadGenerator.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief virtual users with their own login/refresh cycle uploading generated images
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#include <functional>
+
+#include "SyntheticImages.h"
+
+class MockServerThread;
+class UploadEngine;
+
+class LoadGenerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Arrival { Poisson, Constant };
+
+    struct Options
+    {
+        QString serverUrl; // leer: Mock Server im eigenen Thread starten
+        QString username = "admin";
+        QString password = "1234";
+        int users = 10;
+        int userConcurrency = 2;
+        double rate = 5.0; // Uploads pro Sekunde über alle Benutzer
+        Arrival arrival = Arrival::Poisson;
+        int duration = 60;      // s
+        int drainTimeout = 30;  // s
+        int tokenLifetime = 120; // s, nur für den eingebauten Mock Server
+        QList<SyntheticImages::Spec> images;
+        int variants = 4;
+        int quality = 85;
+    };
+
+    explicit LoadGenerator(const Options &options, QObject *parent = nullptr);
+    ~LoadGenerator() override;
+
+    // Nur gegen localhost erlaubt
+    static bool isLocalServer(const QString &url);
+
+    // Läuft blockierend (eigene Event Loops) und liefert den Report als JSON
+    QJsonObject run();
+
+signals:
+    void message(const QString &text);
+
+private:
+    struct Upload
+    {
+        qint64 arrivedNs = 0;
+        qint64 startedNs = 0;
+        qint64 size = 0;
+    };
+
+    struct VirtualUser
+    {
+        UploadEngine *engine = nullptr;
+        QHash<int, Upload> uploads; // Queue-Index -> Messwerte
+        qint64 loginStartedNs = 0;
+        bool loggedIn = false;
+    };
+
+    bool loginUsers();
+    void logoutUsers();
+    // Event Loop laufen lassen bis done() oder Timeout, liefert done()
+    static bool waitUntil(const std::function<bool()> &done, int timeoutMs);
+    void connectUser(int userIndex);
+    void scheduleArrival();
+    void onArrival();
+    void onUploadFinished(int userIndex, int index, bool ok, const QString &message);
+    QJsonObject report(qint64 elapsedNs) const;
+
+    Options m_options;
+    QTemporaryDir m_tempDir;
+    SyntheticImages m_images;
+    MockServerThread *m_server = nullptr;
+    QList<VirtualUser> m_users;
+
+    QElapsedTimer m_clock;
+    QTimer m_arrivalTimer;
+    bool m_arriving = false;
+    int m_inFlight = 0;
+
+    int m_loginsPending = 0;
+    int m_loginFailures = 0;
+    int m_refreshes = 0;
+    int m_sessionsExpired = 0;
+    int m_arrivals = 0;
+    int m_completed = 0;
+    int m_failed = 0;
+    qint64 m_bytes = 0;
+    qint64 m_lastFinishedNs = 0;
+    QList<double> m_loginLatencies;
+    QList<double> m_latencies;        // Ankunft bis Antwort (inkl. Wartezeit beim Client)
+    QList<double> m_serviceLatencies; // Start des Requests bis Antwort
+    QHash<QString, int> m_errors;
+};
@@ -0,0 +1,119 @@
+#include "SyntheticImages.h"
+
+#include <QColor>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageWriter>
+#include <QRandomGenerator>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+
+namespace {
+struct Job
+{
+    int spec = 0;
+    int variant = 0;
+    int width = 0;
+    int height = 0;
+};
+
+// Verlauf mit Rauschen: komprimiert ähnlich wie ein Foto, nicht wie eine Fläche
+QImage render(int width, int height, QRandomGenerator &random)
+{
+    QImage image(width, height, QImage::Format_RGB32);
+    const int hue = random.bounded(360);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            const int noise = random.bounded(48);
+            const QColor color = QColor::fromHsv((hue + x * 120 / width) % 360,
+                                                 80 + y * 160 / height,
+                                                 std::min(255, 120 + noise + x * 80 / width));
+            line[x] = color.rgb();
+        }
+    }
+    return image;
+}
+} // namespace
+
+QList<SyntheticImages::Spec> SyntheticImages::parse(const QString &text)
+{
+    QList<Spec> specs;
+    for (const QString &entry : text.split(',', Qt::SkipEmptyParts)) {
+        const QStringList sizeAndWeight = entry.trimmed().split(':');
+        const QStringList size = sizeAndWeight.first().split('x');
+        if (size.size() != 2)
+            return {};
+
+        Spec spec;
+        spec.width = size.at(0).toInt();
+        spec.height = size.at(1).toInt();
+        spec.weight = sizeAndWeight.size() > 1 ? sizeAndWeight.at(1).toInt() : 1;
+        if (spec.width <= 0 || spec.height <= 0 || spec.weight <= 0)
+            return {};
+        specs.append(spec);
+    }
+    return specs;
+}
+
+bool SyntheticImages::generate(const QList<Spec> &specs, int variants, int quality, const QString &outputDir)
+{
+    QList<Job> jobs;
+    for (int i = 0; i < specs.size(); ++i) {
+        for (int v = 0; v < variants; ++v)
+            jobs.append({i, v, specs.at(i).width, specs.at(i).height});
+    }
+
+    const QList<Image> images = QtConcurrent::blockingMapped(jobs, [quality, outputDir](const Job &job) {
+        QRandomGenerator random(static_cast<quint32>(job.spec * 1000 + job.variant));
+        const QString filePath = QString("%1/synthetic-%2x%3-%4.jpg")
+                                     .arg(outputDir)
+                                     .arg(job.width)
+                                     .arg(job.height)
+                                     .arg(job.variant);
+        QImageWriter writer(filePath, "jpg");
+        writer.setQuality(quality);
+        if (!writer.write(render(job.width, job.height, random)))
+            return Image();
+        return Image{filePath, QFileInfo(filePath).size()};
+    });
+
+    m_images = QList<QList<Image>>(specs.size());
+    m_cumulativeWeights.clear();
+    for (qsizetype i = 0; i < jobs.size(); ++i) {
+        if (images.at(i).filePath.isEmpty())
+            return false;
+        m_images[jobs.at(i).spec].append(images.at(i));
+    }
+
+    int sum = 0;
+    for (const Spec &spec : specs) {
+        sum += spec.weight;
+        m_cumulativeWeights.append(sum);
+    }
+    return !jobs.isEmpty();
+}
+
+const SyntheticImages::Image &SyntheticImages::pick() const
+{
+    const int value = QRandomGenerator::global()->bounded(m_cumulativeWeights.last());
+    const auto it = std::upper_bound(m_cumulativeWeights.cbegin(), m_cumulativeWeights.cend(), value);
+    const QList<Image> &variants = m_images.at(std::distance(m_cumulativeWeights.cbegin(), it));
+    return variants.at(QRandomGenerator::global()->bounded(variants.size()));
+}
+
+bool SyntheticImages::isEmpty() const
+{
+    return m_cumulativeWeights.isEmpty();
+}
+
+qint64 SyntheticImages::totalSize() const
+{
+    qint64 total = 0;
+    for (const QList<Image> &variants : m_images) {
+        for (const Image &image : variants)
+            total += image.size;
+    }
+    return total;
+}
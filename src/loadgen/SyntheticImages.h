@@ -0,0 +1,47 @@
+/**
+ * @file SyntheticImages.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief generated JPEG test images with a weighted size distribution
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QList>
+#include <QString>
+
+class SyntheticImages
+{
+public:
+    struct Spec
+    {
+        int width = 0;
+        int height = 0;
+        int weight = 1; // relative Häufigkeit
+    };
+
+    struct Image
+    {
+        QString filePath;
+        qint64 size = 0;
+    };
+
+    // "1920x1080:50,4000x3000:10" (Gewicht optional, Standard 1)
+    static QList<Spec> parse(const QString &text);
+
+    // Erzeugt pro Spec `variants` Bilder (parallel) in outputDir
+    bool generate(const QList<Spec> &specs, int variants, int quality, const QString &outputDir);
+
+    // Zufälliges Bild gemäß der Gewichtung
+    const Image &pick() const;
+
+    bool isEmpty() const;
+    qint64 totalSize() const;
+
+private:
+    QList<QList<Image>> m_images; // pro Spec
+    QList<int> m_cumulativeWeights;
+};
@@ -0,0 +1,87 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+
+#include "LoadGenerator.h"
+
+#include "../includes/rz_config.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+int main(int argc, char *argv[]) {
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationVersion(PROJECT_VERSION.c_str());
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Synthetic load against a local Crow server (default: in-process mock server).\n"
+        "Every virtual user logs in and refreshes its token on its own.\n"
+        "The report is written as JSON to stdout or --output.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOptions({
+        {"server", "Local server URL (localhost only) instead of the in-process mock.", "url"},
+        {"user", "Username.", "user", "admin"},
+        {"password", "Password.", "password", "1234"},
+        {"users", "Number of virtual users.", "n", "10"},
+        {"user-concurrency", "Parallel uploads per virtual user.", "n", "2"},
+        {"rate", "Uploads per second over all users.", "rate", "5"},
+        {"arrival", "Arrival process: poisson or constant.", "process", "poisson"},
+        {"duration", "Load duration in seconds.", "seconds", "60"},
+        {"drain-timeout", "Seconds to wait for uploads in flight.", "seconds", "30"},
+        {"token-lifetime", "Access token lifetime of the in-process mock (min. 90 s).", "seconds", "120"},
+        {"images",
+         "Image size distribution WIDTHxHEIGHT[:weight],...",
+         "specs",
+         "640x480:30,1920x1080:50,4000x3000:20"},
+        {"variants", "Generated images per size.", "n", "4"},
+        {"quality", "JPEG quality of generated images.", "1-100", "85"},
+        {"output", "Write the JSON report to this file.", "file"},
+    });
+    parser.process(a);
+
+    LoadGenerator::Options options;
+    options.serverUrl = parser.value("server");
+    options.username = parser.value("user");
+    options.password = parser.value("password");
+    options.users = std::max(1, parser.value("users").toInt());
+    options.userConcurrency = std::max(1, parser.value("user-concurrency").toInt());
+    options.rate = parser.value("rate").toDouble();
+    options.arrival = parser.value("arrival") == "constant" ? LoadGenerator::Arrival::Constant
+                                                            : LoadGenerator::Arrival::Poisson;
+    options.duration = std::max(1, parser.value("duration").toInt());
+    options.drainTimeout = std::max(0, parser.value("drain-timeout").toInt());
+    // Der Client refresht 60 s vor Ablauf, kürzere Laufzeiten würden dauernd refreshen
+    options.tokenLifetime = std::max(90, parser.value("token-lifetime").toInt());
+    options.images = SyntheticImages::parse(parser.value("images"));
+    options.variants = std::max(1, parser.value("variants").toInt());
+    options.quality = std::clamp(parser.value("quality").toInt(), 1, 100);
+
+    if (options.images.isEmpty() || options.rate <= 0)
+        parser.showHelp(1);
+    if (!options.serverUrl.isEmpty() && !LoadGenerator::isLocalServer(options.serverUrl)) {
+        std::fprintf(stderr, "Load generation is only allowed against localhost.\n");
+        return 1;
+    }
+
+    LoadGenerator generator(options);
+    QObject::connect(&generator, &LoadGenerator::message, [](const QString &text) {
+        std::fprintf(stderr, "%s\n", qPrintable(text));
+    });
+
+    const QJsonObject result = generator.run();
+    const QByteArray json = QJsonDocument(result).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet("output")) {
+        QFile file(parser.value("output"));
+        if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size()) {
+            std::fprintf(stderr, "Could not write %s\n", qPrintable(file.fileName()));
+            return 1;
+        }
+    } else {
+        std::fwrite(json.constData(), 1, static_cast<size_t>(json.size()), stdout);
+    }
+    return result.contains("error") ? 1 : 0;
+}
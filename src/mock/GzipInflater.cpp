@@ -0,0 +1,58 @@
+#include "GzipInflater.h"
+
+namespace {
+constexpr int OutputBlock = 256 * 1024;
+}
+
+GzipInflater::GzipInflater()
+{
+    // 16 + MAX_WBITS: nur gzip Header akzeptieren
+    m_error = inflateInit2(&m_stream, 16 + MAX_WBITS) != Z_OK;
+}
+
+GzipInflater::~GzipInflater()
+{
+    inflateEnd(&m_stream);
+}
+
+QByteArray GzipInflater::inflate(const QByteArray &data)
+{
+    if (m_error || data.isEmpty())
+        return {};
+    if (m_finished) {
+        // Daten hinter dem Ende des Streams
+        m_error = true;
+        return {};
+    }
+
+    QByteArray result;
+    QByteArray block(OutputBlock, Qt::Uninitialized);
+    m_stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.constData()));
+    m_stream.avail_in = static_cast<uInt>(data.size());
+
+    // Solange der Ausgabe-Block voll wird, kann zlib noch mehr liefern
+    do {
+        m_stream.next_out = reinterpret_cast<Bytef *>(block.data());
+        m_stream.avail_out = static_cast<uInt>(block.size());
+        const int status = ::inflate(&m_stream, Z_NO_FLUSH);
+        if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR) {
+            m_error = true;
+            return {};
+        }
+        result.append(block.constData(), block.size() - m_stream.avail_out);
+        m_finished = status == Z_STREAM_END;
+    } while (m_stream.avail_out == 0 && !m_finished);
+    if (m_finished && m_stream.avail_in > 0)
+        m_error = true;
+    return result;
+}
+
+bool GzipInflater::hasError() const
+{
+    return m_error;
+}
+
+bool GzipInflater::isFinished() const
+{
+    return m_finished;
+}
@@ -0,0 +1,36 @@
+/**
+ * @file GzipInflater.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief streaming gzip decoder for Content-Encoding: gzip upload bodies
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QByteArray>
+
+#include <zlib.h>
+
+class GzipInflater
+{
+public:
+    GzipInflater();
+    ~GzipInflater();
+    GzipInflater(const GzipInflater &) = delete;
+    GzipInflater &operator=(const GzipInflater &) = delete;
+
+    // Dekodiert den nächsten Block, bei einem Fehler leer und hasError() == true
+    QByteArray inflate(const QByteArray &data);
+
+    bool hasError() const;
+    // Ende des gzip-Streams erreicht (sonst ist der Body abgeschnitten)
+    bool isFinished() const;
+
+private:
+    z_stream m_stream{};
+    bool m_error = false;
+    bool m_finished = false;
+};
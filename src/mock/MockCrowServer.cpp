@@ -0,0 +1,837 @@
+#include "MockCrowServer.h"
+#include "GzipInflater.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
+#include <QRegularExpression>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QUuid>
+
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+// Streaming-Parser für multipart/form-data: große Parts werden nur gezählt,
+// kleine (z.B. "path") komplett behalten. Parts mit Content-Encoding: gzip
+// werden beim Lesen dekodiert, Größe und Hash beziehen sich auf die Originaldaten.
+class MultipartParser
+{
+public:
+    struct Part
+    {
+        QByteArray name;
+        QByteArray fileName;
+        QByteArray contentType;
+        QByteArray contentEncoding;
+        QByteArray idempotencyKey; // Batch: Schlüssel pro Datei
+        QByteArray data;
+        qint64 size = 0;
+        QByteArray hash;
+        bool decodeError = false;
+    };
+
+    static constexpr qint64 MaxKeptBytes = 1024 * 1024;
+
+    MultipartParser(const QByteArray &boundary, bool hash)
+        : m_delimiter("\r\n--" + boundary)
+        , m_buffer("\r\n")
+        , m_hashParts(hash)
+    {}
+
+    void feed(const QByteArray &data)
+    {
+        m_buffer.append(data);
+        process();
+    }
+
+    const QList<Part> &parts() const { return m_parts; }
+
+    const Part *part(const QByteArray &name) const
+    {
+        for (const Part &part : m_parts) {
+            if (part.name == name)
+                return &part;
+        }
+        return nullptr;
+    }
+
+private:
+    enum class State { Preamble, AfterDelimiter, Headers, Body, Done };
+
+    void process()
+    {
+        while (true) {
+            switch (m_state) {
+            case State::Preamble: {
+                const qsizetype idx = m_buffer.indexOf(m_delimiter);
+                if (idx < 0) {
+                    keepTail();
+                    return;
+                }
+                m_buffer.remove(0, idx + m_delimiter.size());
+                m_state = State::AfterDelimiter;
+                break;
+            }
+            case State::AfterDelimiter:
+                if (m_buffer.size() < 2)
+                    return;
+                if (m_buffer.startsWith("--")) {
+                    m_state = State::Done;
+                    break;
+                }
+                m_buffer.remove(0, 2); // CRLF nach dem Delimiter
+                m_state = State::Headers;
+                break;
+            case State::Headers: {
+                const qsizetype end = m_buffer.indexOf("\r\n\r\n");
+                if (end < 0)
+                    return;
+                m_current = Part();
+                m_hash.reset();
+                m_inflater.reset();
+                parseHeaders(m_buffer.left(end));
+                m_buffer.remove(0, end + 4);
+                m_state = State::Body;
+                break;
+            }
+            case State::Body: {
+                const qsizetype idx = m_buffer.indexOf(m_delimiter);
+                if (idx < 0) {
+                    // Ende könnte einen angeschnittenen Delimiter enthalten
+                    const qsizetype safe = m_buffer.size() - (m_delimiter.size() - 1);
+                    if (safe > 0) {
+                        append(m_buffer.left(safe));
+                        m_buffer.remove(0, safe);
+                    }
+                    return;
+                }
+                append(m_buffer.left(idx));
+                m_buffer.remove(0, idx + m_delimiter.size());
+                if (m_inflater && !m_inflater->isFinished())
+                    m_current.decodeError = true; // abgeschnittener gzip-Stream
+                if (m_hashParts)
+                    m_current.hash = m_hash.result();
+                m_parts.append(m_current);
+                m_state = State::AfterDelimiter;
+                break;
+            }
+            case State::Done:
+                m_buffer.clear();
+                return;
+            }
+        }
+    }
+
+    void keepTail()
+    {
+        const qsizetype keep = m_delimiter.size() - 1;
+        if (m_buffer.size() > keep)
+            m_buffer.remove(0, m_buffer.size() - keep);
+    }
+
+    void parseHeaders(const QByteArray &block)
+    {
+        static const QRegularExpression nameRe(R"re(\bname="([^"]*)")re");
+        static const QRegularExpression fileNameRe(R"re(\bfilename="([^"]*)")re");
+
+        for (const QByteArray &rawLine : block.split('\n')) {
+            const QByteArray line = rawLine.trimmed();
+            const qsizetype colon = line.indexOf(':');
+            if (colon <= 0)
+                continue;
+            const QByteArray key = line.left(colon).trimmed().toLower();
+            const QByteArray value = line.mid(colon + 1).trimmed();
+            if (key == "content-disposition") {
+                const QString disposition = QString::fromUtf8(value);
+                m_current.name = nameRe.match(disposition).captured(1).toUtf8();
+                m_current.fileName = fileNameRe.match(disposition).captured(1).toUtf8();
+            } else if (key == "content-type") {
+                m_current.contentType = value;
+            } else if (key == "content-encoding") {
+                m_current.contentEncoding = value.toLower();
+            } else if (key == "idempotency-key") {
+                m_current.idempotencyKey = value;
+            }
+        }
+        if (m_current.contentEncoding == "gzip")
+            m_inflater = std::make_unique<GzipInflater>();
+        else if (!m_current.contentEncoding.isEmpty())
+            m_current.decodeError = true; // unbekannte Kodierung
+    }
+
+    void append(const QByteArray &encoded)
+    {
+        if (encoded.isEmpty())
+            return;
+        QByteArray data = encoded;
+        if (m_inflater) {
+            data = m_inflater->inflate(encoded);
+            if (m_inflater->hasError())
+                m_current.decodeError = true;
+        }
+        if (m_current.size + data.size() <= MaxKeptBytes)
+            m_current.data.append(data);
+        m_current.size += data.size();
+        if (m_hashParts)
+            m_hash.addData(data);
+    }
+
+    QByteArray m_delimiter;
+    QByteArray m_buffer;
+    State m_state = State::Preamble;
+    bool m_hashParts;
+    Part m_current;
+    std::unique_ptr<GzipInflater> m_inflater;
+    QCryptographicHash m_hash{QCryptographicHash::Blake2b_256};
+    QList<Part> m_parts;
+};
+
+constexpr qint64 MaxBufferedBody = 16 * 1024 * 1024;
+const QString ChunkedPrefix = "/upload/chunked/";
+
+QByteArray reasonPhrase(int status)
+{
+    switch (status) {
+    case 200:
+        return "OK";
+    case 400:
+        return "Bad Request";
+    case 401:
+        return "Unauthorized";
+    case 404:
+        return "Not Found";
+    case 409:
+        return "Conflict";
+    case 429:
+        return "Too Many Requests";
+    case 503:
+        return "Service Unavailable";
+    default:
+        return "Error";
+    }
+}
+
+} // namespace
+
+struct MockCrowServer::Connection
+{
+    QTcpSocket *socket = nullptr;
+    QByteArray buffer;
+
+    bool headerDone = false;
+    QByteArray method;
+    QString path;
+    QUrlQuery query;
+    QHash<QByteArray, QByteArray> headers; // Keys in Kleinbuchstaben
+    qint64 contentLength = 0;
+    qint64 received = 0;
+    QByteArray body;
+    std::unique_ptr<MultipartParser> multipart;
+    bool chunkBody = false;
+    bool drop = false;
+    bool dropReply = false;
+    bool countsUpload = false; // zählt zu m_uploadsInFlight, bis die Antwort raus ist
+    bool overloaded = false;
+
+    void reset()
+    {
+        headerDone = false;
+        method.clear();
+        path.clear();
+        query.clear();
+        headers.clear();
+        contentLength = 0;
+        received = 0;
+        body.clear();
+        multipart.reset();
+        chunkBody = false;
+        drop = false;
+        dropReply = false;
+        countsUpload = false;
+        overloaded = false;
+    }
+};
+
+MockCrowServer::MockCrowServer(QObject *parent)
+    : MockCrowServer(Options(), parent)
+{}
+
+MockCrowServer::MockCrowServer(const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+{
+    connect(&m_server, &QTcpServer::newConnection, this, &MockCrowServer::onNewConnection);
+
+    m_bandwidthTimer.setInterval(10);
+    m_bandwidthTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_bandwidthTimer, &QTimer::timeout, this, &MockCrowServer::onBandwidthTick);
+    m_budgetClock.start();
+}
+
+MockCrowServer::~MockCrowServer()
+{
+    // Sockets gehören m_server, ihr disconnected() darf uns nicht mehr erreichen
+    for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
+        it.key()->disconnect(this);
+        delete it.value();
+    }
+}
+
+bool MockCrowServer::listen(const QHostAddress &address, quint16 port)
+{
+    return m_server.listen(address, port);
+}
+
+quint16 MockCrowServer::port() const
+{
+    return m_server.serverPort();
+}
+
+QString MockCrowServer::url() const
+{
+    return QString("http://127.0.0.1:%1").arg(port());
+}
+
+QList<MockCrowServer::StoredFile> MockCrowServer::files() const
+{
+    return m_files;
+}
+
+void MockCrowServer::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+        Connection *conn = new Connection;
+        conn->socket = socket;
+        m_connections.insert(socket, conn);
+        // Kleiner Lesepuffer: was wir nicht abholen, staut sich im Kernel und bremst den Client
+        if (m_options.bandwidth > 0)
+            socket->setReadBufferSize(64 * 1024);
+
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            Connection *conn = m_connections.take(socket);
+            if (conn && conn->countsUpload)
+                --m_uploadsInFlight;
+            m_throttled.remove(socket);
+            delete conn;
+            socket->deleteLater();
+        });
+    }
+}
+
+void MockCrowServer::onReadyRead(QTcpSocket *socket)
+{
+    Connection *conn = m_connections.value(socket);
+    if (!conn)
+        return;
+    if (m_options.bandwidth > 0)
+        readThrottled(socket, conn);
+    else
+        conn->buffer.append(socket->readAll());
+
+    // Mehrere Requests pro Verbindung (keep-alive) nacheinander abarbeiten
+    while (true) {
+        if (!conn->headerDone && !parseHeader(*conn))
+            return;
+
+        const qint64 take = std::min<qint64>(conn->contentLength - conn->received,
+                                             conn->buffer.size());
+        if (take > 0) {
+            consumeBody(*conn, conn->buffer.left(take));
+            conn->buffer.remove(0, take);
+
+            if (conn->drop && conn->received * 2 >= conn->contentLength) {
+                // Verbindungsabbruch simulieren, nichts wird übernommen
+                socket->abort();
+                return;
+            }
+        }
+        if (conn->received < conn->contentLength)
+            return;
+
+        const Response response = handle(*conn);
+        emit requestHandled(QString::fromLatin1(conn->method), conn->path, response.status);
+        if (conn->dropReply) {
+            // Übernommen, aber die Antwort geht verloren: der Client muss den Stand erfragen
+            socket->abort();
+            return;
+        }
+        const bool countsUpload = conn->countsUpload;
+        if (m_options.latency > 0) {
+            QTimer::singleShot(m_options.latency,
+                               this,
+                               [this, socket = QPointer<QTcpSocket>(socket), response, countsUpload]() {
+                                   if (countsUpload)
+                                       --m_uploadsInFlight;
+                                   if (socket)
+                                       respond(socket, response);
+                               });
+        } else {
+            if (countsUpload)
+                --m_uploadsInFlight;
+            respond(socket, response);
+        }
+        conn->reset();
+
+        if (conn->buffer.isEmpty())
+            return;
+    }
+}
+
+void MockCrowServer::readThrottled(QTcpSocket *socket, Connection *conn)
+{
+    // Budget wächst mit der Zeit, höchstens 50 ms Burst
+    const qint64 elapsedNs = m_budgetClock.nsecsElapsed();
+    m_budgetClock.start();
+    m_budget = std::min(m_budget + m_options.bandwidth * elapsedNs / 1000000000, m_options.bandwidth / 20);
+
+    const qint64 take = std::min(m_budget, socket->bytesAvailable());
+    if (take > 0) {
+        conn->buffer.append(socket->read(take));
+        m_budget -= take;
+    }
+
+    if (socket->bytesAvailable() > 0) {
+        m_throttled.insert(socket);
+        if (!m_bandwidthTimer.isActive())
+            m_bandwidthTimer.start();
+    } else {
+        m_throttled.remove(socket);
+    }
+}
+
+void MockCrowServer::onBandwidthTick()
+{
+    const QList<QTcpSocket *> sockets = m_throttled.values();
+    for (QTcpSocket *socket : sockets)
+        onReadyRead(socket);
+    if (m_throttled.isEmpty())
+        m_bandwidthTimer.stop();
+}
+
+bool MockCrowServer::parseHeader(Connection &conn)
+{
+    const qsizetype end = conn.buffer.indexOf("\r\n\r\n");
+    if (end < 0) {
+        if (conn.buffer.size() > 64 * 1024)
+            conn.socket->abort();
+        return false;
+    }
+
+    const QList<QByteArray> lines = conn.buffer.left(end).split('\n');
+    conn.buffer.remove(0, end + 4);
+
+    const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+    if (requestLine.size() < 2) {
+        conn.socket->abort();
+        return false;
+    }
+
+    conn.method = requestLine.at(0);
+    const QUrl target(QString::fromLatin1(requestLine.at(1)));
+    conn.path = target.path();
+    conn.query = QUrlQuery(target);
+
+    for (qsizetype i = 1; i < lines.size(); ++i) {
+        const QByteArray line = lines.at(i).trimmed();
+        const qsizetype colon = line.indexOf(':');
+        if (colon > 0)
+            conn.headers.insert(line.left(colon).trimmed().toLower(), line.mid(colon + 1).trimmed());
+    }
+    conn.contentLength = conn.headers.value("content-length").toLongLong();
+    conn.headerDone = true;
+
+    const QByteArray contentType = conn.headers.value("content-type");
+    const qsizetype boundaryPos = contentType.indexOf("boundary=");
+    if (contentType.startsWith("multipart/form-data") && boundaryPos >= 0) {
+        QByteArray boundary = contentType.mid(boundaryPos + 9);
+        const qsizetype semicolon = boundary.indexOf(';');
+        if (semicolon >= 0)
+            boundary.truncate(semicolon);
+        boundary = boundary.trimmed();
+        if (boundary.startsWith('"') && boundary.endsWith('"'))
+            boundary = boundary.mid(1, boundary.size() - 2);
+        conn.multipart = std::make_unique<MultipartParser>(boundary, m_options.hashUploads);
+    }
+    conn.chunkBody = conn.method == "PUT" && conn.path.startsWith(ChunkedPrefix);
+
+    const bool isUploadBody = (conn.method == "POST" || conn.method == "PUT")
+                              && conn.path.startsWith("/upload") && conn.path != "/upload/chunked";
+    if (isUploadBody && conn.contentLength > 0) {
+        ++m_uploadRequests;
+        conn.drop = m_options.dropEvery > 0 && m_uploadRequests % m_options.dropEvery == 0;
+        conn.dropReply = !conn.drop && m_options.dropReplyEvery > 0
+                         && m_uploadRequests % m_options.dropReplyEvery == 0;
+        conn.countsUpload = true;
+        ++m_uploadsInFlight;
+        conn.overloaded = m_options.maxUploads > 0 && m_uploadsInFlight > m_options.maxUploads;
+    }
+    return true;
+}
+
+void MockCrowServer::consumeBody(Connection &conn, const QByteArray &data)
+{
+    conn.received += data.size();
+    if (conn.multipart)
+        conn.multipart->feed(data);
+    else if (conn.chunkBody || conn.body.size() + data.size() <= MaxBufferedBody)
+        conn.body.append(data); // Chunks komplett puffern, sie zählen erst vollständig
+}
+
+MockCrowServer::Response MockCrowServer::handle(Connection &conn)
+{
+    const QString &path = conn.path;
+
+    if (conn.method == "POST" && path == "/login")
+        return handleLogin(conn);
+    if (conn.method == "POST" && path == "/refresh")
+        return handleRefresh(conn);
+    if (conn.method == "POST" && path == "/logout")
+        return handleLogout(conn);
+    // Health/Latenz-Probe des Clients (ServerPool), ohne Login
+    if (conn.method == "GET" && path == "/health")
+        return json(200, R"({"status":"ok"})");
+
+    if (path.startsWith("/upload") && !isAuthorized(conn))
+        return json(401, R"({"error":"unauthorized"})");
+    if (conn.overloaded) {
+        Response response = json(503, R"({"error":"too many concurrent uploads"})");
+        response.retryAfter = 1;
+        return response;
+    }
+
+    // Wiederholter POST mit bekanntem Key: gespeicherte Antwort, kein zweiter Upload
+    const QByteArray key = conn.method == "POST" ? conn.headers.value("idempotency-key") : QByteArray();
+    if (key.isEmpty())
+        return route(conn);
+    const auto it = m_idempotent.constFind(key);
+    if (it != m_idempotent.constEnd())
+        return it.value();
+    const Response response = route(conn);
+    if (response.status / 100 == 2)
+        m_idempotent.insert(key, response);
+    return response;
+}
+
+MockCrowServer::Response MockCrowServer::route(Connection &conn)
+{
+    const QString &path = conn.path;
+
+    if (conn.method == "POST" && path == "/upload")
+        return handleUpload(conn);
+    if (conn.method == "POST" && path == "/upload/batch")
+        return handleBatchUpload(conn);
+    if (conn.method == "GET" && path == "/upload/exists")
+        return handleExists(conn);
+    if (conn.method == "GET" && path == "/upload/manifest")
+        return handleManifest(conn);
+    if (conn.method == "POST" && path == "/upload/chunked")
+        return handleChunkedCreate(conn);
+    if (path.startsWith(ChunkedPrefix)) {
+        const QString uploadId = path.mid(ChunkedPrefix.size());
+        if (conn.method == "GET")
+            return handleChunkedStatus(uploadId);
+        if (conn.method == "PUT")
+            return handleChunkedPut(conn, uploadId);
+    }
+    return json(404, R"({"error":"not found"})");
+}
+
+void MockCrowServer::respond(QTcpSocket *socket, const Response &response)
+{
+    QByteArray head = "HTTP/1.1 " + QByteArray::number(response.status) + " "
+                      + reasonPhrase(response.status) + "\r\n";
+    head += "Content-Type: " + response.contentType + "\r\n";
+    head += "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n";
+    if (response.retryAfter >= 0)
+        head += "Retry-After: " + QByteArray::number(response.retryAfter) + "\r\n";
+    head += "Connection: keep-alive\r\n\r\n";
+    socket->write(head + response.body);
+}
+
+bool MockCrowServer::isAuthorized(const Connection &conn) const
+{
+    const QByteArray auth = conn.headers.value("authorization");
+    if (!auth.startsWith("Bearer "))
+        return false;
+    const QString token = QString::fromLatin1(auth.mid(7));
+    const auto it = m_accessTokens.constFind(token);
+    return it != m_accessTokens.constEnd() && it.value() > QDateTime::currentDateTimeUtc();
+}
+
+QString MockCrowServer::issueToken(const QString &user)
+{
+    // Aufbau wie ein JWT, damit der Client den "exp" Claim lesen kann
+    const QDateTime expires = QDateTime::currentDateTimeUtc().addSecs(m_options.tokenLifetime);
+    const QJsonObject payload{{"sub", user},
+                              {"exp", expires.toSecsSinceEpoch()},
+                              {"jti", QUuid::createUuid().toString(QUuid::WithoutBraces)}};
+    const auto encoding = QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals;
+    const QByteArray token = QByteArray(R"({"alg":"none","typ":"JWT"})").toBase64(encoding) + "."
+                             + QJsonDocument(payload).toJson(QJsonDocument::Compact).toBase64(encoding)
+                             + ".mock";
+
+    m_accessTokens.insert(QString::fromLatin1(token), expires);
+    return QString::fromLatin1(token);
+}
+
+MockCrowServer::Response MockCrowServer::handleLogin(const Connection &conn)
+{
+    const QJsonObject obj = QJsonDocument::fromJson(conn.body).object();
+    if (obj["username"].toString() != m_options.username
+        || obj["password"].toString() != m_options.password) {
+        return json(401, R"({"error":"invalid credentials"})");
+    }
+
+    const QString refreshToken = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    m_refreshTokens.insert(refreshToken, m_options.username);
+
+    const QJsonObject result{{"token", issueToken(m_options.username)},
+                             {"refreshToken", refreshToken}};
+    return json(200, QJsonDocument(result).toJson(QJsonDocument::Compact));
+}
+
+MockCrowServer::Response MockCrowServer::handleRefresh(const Connection &conn)
+{
+    const QString refreshToken = QJsonDocument::fromJson(conn.body).object()["refreshToken"].toString();
+    if (!m_refreshTokens.contains(refreshToken))
+        return json(401, R"({"error":"invalid refresh token"})");
+
+    const QJsonObject result{{"token", issueToken(m_refreshTokens.value(refreshToken))}};
+    return json(200, QJsonDocument(result).toJson(QJsonDocument::Compact));
+}
+
+MockCrowServer::Response MockCrowServer::handleLogout(const Connection &conn)
+{
+    m_refreshTokens.remove(QJsonDocument::fromJson(conn.body).object()["refreshToken"].toString());
+    return json(200, R"({"status":"ok"})");
+}
+
+MockCrowServer::Response MockCrowServer::handleUpload(const Connection &conn)
+{
+    if (!conn.multipart)
+        return json(400, R"({"error":"multipart expected"})");
+
+    const MultipartParser::Part *photo = conn.multipart->part("photo");
+    if (!photo)
+        return json(400, R"({"error":"photo part missing"})");
+    if (photo->decodeError)
+        return json(400, R"({"error":"invalid content encoding"})");
+
+    StoredFile file;
+    file.fileName = QString::fromUtf8(photo->fileName);
+    file.size = photo->size;
+    file.hash = photo->hash;
+    if (const MultipartParser::Part *pathPart = conn.multipart->part("path"))
+        file.path = QString::fromUtf8(pathPart->data);
+    if (const MultipartParser::Part *metadataPart = conn.multipart->part("metadata"))
+        file.metadata = QJsonDocument::fromJson(metadataPart->data).object();
+    storeFile(file);
+
+    const QJsonObject result{{"status", "ok"}, {"file", file.fileName}, {"size", file.size}};
+    return json(200, QJsonDocument(result).toJson(QJsonDocument::Compact));
+}
+
+MockCrowServer::Response MockCrowServer::handleBatchUpload(const Connection &conn)
+{
+    if (!conn.multipart)
+        return json(400, R"({"error":"multipart expected"})");
+
+    // Jeder "photo" Part bekommt die direkt folgenden "path" und "metadata" Parts
+    QList<const MultipartParser::Part *> photos;
+    QStringList paths;
+    QList<QJsonObject> metadata;
+    for (const MultipartParser::Part &part : conn.multipart->parts()) {
+        if (part.name == "photo") {
+            photos.append(&part);
+            paths.append(QString());
+            metadata.append(QJsonObject());
+        } else if (part.name == "path" && !paths.isEmpty()) {
+            paths.last() = QString::fromUtf8(part.data);
+        } else if (part.name == "metadata" && !metadata.isEmpty()) {
+            metadata.last() = QJsonDocument::fromJson(part.data).object();
+        }
+    }
+    if (photos.isEmpty())
+        return json(400, R"({"error":"photo part missing"})");
+
+    QJsonArray results;
+    for (qsizetype i = 0; i < photos.size(); ++i) {
+        const MultipartParser::Part *photo = photos.at(i);
+        const QString fileName = QString::fromUtf8(photo->fileName);
+        if (photo->decodeError) {
+            results.append(QJsonObject{{"status", "error"},
+                                       {"file", fileName},
+                                       {"error", "invalid content encoding"}});
+            continue;
+        }
+
+        // Schon gespeichert (früherer Batch oder Einzel-Upload, dessen Antwort verloren ging):
+        // erstes Ergebnis wiederholen statt ein zweites Mal speichern
+        const auto known = m_idempotent.constFind(photo->idempotencyKey);
+        if (!photo->idempotencyKey.isEmpty() && known != m_idempotent.constEnd()) {
+            results.append(QJsonDocument::fromJson(known->body).object());
+            continue;
+        }
+
+        StoredFile file;
+        file.fileName = fileName;
+        file.size = photo->size;
+        file.hash = photo->hash;
+        file.path = paths.at(i);
+        file.metadata = metadata.at(i);
+        storeFile(file);
+        const QJsonObject result{{"status", "ok"}, {"file", file.fileName}, {"size", file.size}};
+        results.append(result);
+        if (!photo->idempotencyKey.isEmpty()) {
+            m_idempotent.insert(photo->idempotencyKey,
+                                json(200, QJsonDocument(result).toJson(QJsonDocument::Compact)));
+        }
+    }
+
+    const QJsonObject result{{"results", results}};
+    return json(200, QJsonDocument(result).toJson(QJsonDocument::Compact));
+}
+
+MockCrowServer::Response MockCrowServer::handleExists(const Connection &conn)
+{
+    const QByteArray hash = QByteArray::fromHex(conn.query.queryItemValue("hash").toLatin1());
+    const QString path = conn.query.queryItemValue("path", QUrl::FullyDecoded);
+    const bool exists = m_knownFiles.contains(hash + '\0' + path.toUtf8());
+
+    const QJsonObject result{{"exists", exists}};
+    return json(200, QJsonDocument(result).toJson(QJsonDocument::Compact));
+}
+
+MockCrowServer::Response MockCrowServer::handleManifest(const Connection &conn)
+{
+    // Alles unterhalb von path, relativ dazu; bei mehrfachen Uploads gilt der letzte
+    const QString root = conn.query.queryItemValue("path", QUrl::FullyDecoded);
+    QHash<QString, const StoredFile *> latest;
+    for (const StoredFile &file : m_files) {
+        QString relDir;
+        if (root.isEmpty())
+            relDir = file.path;
+        else if (file.path == root)
+            relDir.clear();
+        else if (file.path.startsWith(root + "/"))
+            relDir = file.path.mid(root.size() + 1);
+        else
+            continue;
+        latest.insert(relDir.isEmpty() ? file.fileName : relDir + "/" + file.fileName, &file);
+    }
+
+    // Kompakt als Arrays [name, size, hash], bei 100k Dateien zählt jedes Byte
+    QJsonArray files;
+    for (auto it = latest.constBegin(); it != latest.constEnd(); ++it)
+        files.append(QJsonArray{it.key(), it.value()->size, QString::fromLatin1(it.value()->hash.toHex())});
+
+    const QJsonObject result{{"path", root}, {"files", files}};
+    return json(200, QJsonDocument(result).toJson(QJsonDocument::Compact));
+}
+
+MockCrowServer::Response MockCrowServer::handleChunkedCreate(const Connection &conn)
+{
+    const QJsonObject obj = QJsonDocument::fromJson(conn.body).object();
+    ChunkedSession session;
+    session.file.fileName = obj["fileName"].toString();
+    session.file.path = obj["path"].toString();
+    session.file.metadata = obj["metadata"].toObject();
+    session.size = obj["size"].toInteger();
+    if (session.file.fileName.isEmpty() || session.size <= 0)
+        return json(400, R"({"error":"fileName and size required"})");
+    const QString encoding = obj["contentEncoding"].toString();
+    if (encoding == "gzip")
+        session.inflater = std::make_shared<GzipInflater>();
+    else if (!encoding.isEmpty())
+        return json(400, R"({"error":"unsupported content encoding"})");
+    session.hash = std::make_shared<QCryptographicHash>(QCryptographicHash::Blake2b_256);
+
+    const QString uploadId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    m_chunked.insert(uploadId, session);
+
+    const QJsonObject result{{"uploadId", uploadId}, {"offset", 0}};
+    return json(200, QJsonDocument(result).toJson(QJsonDocument::Compact));
+}
+
+MockCrowServer::Response MockCrowServer::handleChunkedStatus(const QString &uploadId)
+{
+    const auto it = m_chunked.constFind(uploadId);
+    if (it == m_chunked.constEnd())
+        return json(404, R"({"error":"unknown upload"})");
+
+    const QJsonObject result{{"offset", it->committed}, {"size", it->size}, {"complete", it->complete}};
+    return json(200, QJsonDocument(result).toJson(QJsonDocument::Compact));
+}
+
+MockCrowServer::Response MockCrowServer::handleChunkedPut(Connection &conn, const QString &uploadId)
+{
+    auto it = m_chunked.find(uploadId);
+    if (it == m_chunked.end())
+        return json(404, R"({"error":"unknown upload"})");
+
+    static const QRegularExpression rangeRe(R"(^bytes (\d+)-(\d+)/(\d+)$)");
+    const QRegularExpressionMatch match = rangeRe.match(
+        QString::fromLatin1(conn.headers.value("content-range")));
+    if (!match.hasMatch())
+        return json(400, R"({"error":"Content-Range required"})");
+
+    const qint64 start = match.captured(1).toLongLong();
+    const qint64 end = match.captured(2).toLongLong();
+    if (start != it->committed || it->complete) {
+        // Client ist nicht synchron: aktuellen Stand melden
+        const QJsonObject result{{"offset", it->committed}};
+        return json(409, QJsonDocument(result).toJson(QJsonDocument::Compact));
+    }
+    if (end - start + 1 != conn.received || end >= it->size)
+        return json(400, R"({"error":"invalid range"})");
+
+    // Chunks kommen lückenlos in Reihenfolge, daher kann fortlaufend dekodiert werden
+    QByteArray data = conn.body;
+    if (it->inflater) {
+        data = it->inflater->inflate(conn.body);
+        if (it->inflater->hasError()) {
+            m_chunked.erase(it);
+            return json(400, R"({"error":"invalid content encoding"})");
+        }
+    }
+    it->committed += conn.received;
+    it->file.size += data.size();
+    if (m_options.hashUploads)
+        it->hash->addData(data);
+    const bool complete = it->committed == it->size;
+    if (complete && it->inflater && !it->inflater->isFinished()) {
+        m_chunked.erase(it);
+        return json(400, R"({"error":"invalid content encoding"})");
+    }
+    const QJsonObject result{{"offset", it->committed}, {"complete", complete}};
+    if (complete) {
+        if (m_options.hashUploads)
+            it->file.hash = it->hash->result();
+        storeFile(it->file);
+        // Nur der Stand bleibt: ein Retry nach verlorener Antwort sieht "complete" statt 404
+        it->complete = true;
+        it->file = StoredFile();
+        it->hash.reset();
+        it->inflater.reset();
+    }
+    return json(200, QJsonDocument(result).toJson(QJsonDocument::Compact));
+}
+
+void MockCrowServer::storeFile(const StoredFile &file)
+{
+    m_files.append(file);
+    m_knownFiles.insert(file.hash + '\0' + file.path.toUtf8());
+}
+
+MockCrowServer::Response MockCrowServer::json(int status, const QByteArray &body)
+{
+    Response response;
+    response.status = status;
+    response.body = body;
+    return response;
+}
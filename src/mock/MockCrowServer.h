@@ -0,0 +1,136 @@
+/**
+ * @file MockCrowServer.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief minimal Crow compatible HTTP server for offline checks
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QHostAddress>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include <memory>
+
+class GzipInflater;
+
+class MockCrowServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options
+    {
+        QString username = "admin";
+        QString password = "1234";
+        int tokenLifetime = 900; // Sekunden
+        int dropEvery = 0;       // jeden n-ten Upload-Request mittendrin abbrechen (0 = nie)
+        int dropReplyEvery = 0;  // jeden n-ten Upload-Request übernehmen, aber ohne Antwort abbrechen
+        bool hashUploads = true; // BLAKE2b der Uploads für /upload/exists (Benchmarks: aus)
+        // Leitung und Last simulieren, z.B. für die adaptive Parallelität
+        qint64 bandwidth = 0; // Bytes/s Upload über alle Verbindungen (0 = unbegrenzt)
+        int latency = 0;      // ms bis zur Antwort (RTT + Serverzeit)
+        int maxUploads = 0;   // gleichzeitige Uploads, darüber 503 (0 = unbegrenzt)
+    };
+
+    struct StoredFile
+    {
+        QString path;
+        QString fileName;
+        qint64 size = 0; // dekodiert, wie die Datei beim Client
+        QByteArray hash; // BLAKE2b-256 wie FileHasher im Client
+        QJsonObject metadata; // vom Client gelesene Aufnahmedaten ("metadata" Part)
+    };
+
+    explicit MockCrowServer(QObject *parent = nullptr);
+    explicit MockCrowServer(const Options &options, QObject *parent = nullptr);
+    ~MockCrowServer();
+
+    bool listen(const QHostAddress &address = QHostAddress::LocalHost, quint16 port = 0);
+    quint16 port() const;
+    QString url() const;
+
+    QList<StoredFile> files() const;
+
+signals:
+    void requestHandled(const QString &method, const QString &path, int status);
+
+private:
+    struct Connection;
+    struct Response
+    {
+        int status = 200;
+        QByteArray contentType = "application/json";
+        QByteArray body;
+        int retryAfter = -1; // s, nur gesendet wenn >= 0
+    };
+    struct ChunkedSession
+    {
+        StoredFile file;
+        qint64 size = 0;      // gesendete Bytes, ggf. gzip-kodiert
+        qint64 committed = 0; // bezogen auf size
+        bool complete = false; // gespeichert; bleibt für GET/PUT nach verlorener Antwort stehen
+        std::shared_ptr<QCryptographicHash> hash;
+        std::shared_ptr<GzipInflater> inflater; // nur bei "contentEncoding":"gzip"
+    };
+
+    void onNewConnection();
+    void onReadyRead(QTcpSocket *socket);
+    void readThrottled(QTcpSocket *socket, Connection *conn);
+    void onBandwidthTick();
+    bool parseHeader(Connection &conn);
+    void consumeBody(Connection &conn, const QByteArray &data);
+    Response handle(Connection &conn);
+    Response route(Connection &conn);
+    void respond(QTcpSocket *socket, const Response &response);
+
+    bool isAuthorized(const Connection &conn) const;
+    QString issueToken(const QString &user);
+
+    Response handleLogin(const Connection &conn);
+    Response handleRefresh(const Connection &conn);
+    Response handleLogout(const Connection &conn);
+    Response handleUpload(const Connection &conn);
+    Response handleBatchUpload(const Connection &conn);
+    Response handleExists(const Connection &conn);
+    Response handleManifest(const Connection &conn);
+    Response handleChunkedCreate(const Connection &conn);
+    Response handleChunkedStatus(const QString &uploadId);
+    Response handleChunkedPut(Connection &conn, const QString &uploadId);
+    void storeFile(const StoredFile &file);
+
+    static Response json(int status, const QByteArray &body);
+
+    Options m_options;
+    QTcpServer m_server;
+    QHash<QTcpSocket *, Connection *> m_connections;
+
+    QHash<QString, QDateTime> m_accessTokens; // token -> Ablaufzeit
+    QHash<QString, QString> m_refreshTokens;  // refresh token -> user
+    QHash<QString, ChunkedSession> m_chunked;
+    QList<StoredFile> m_files;
+    QSet<QByteArray> m_knownFiles; // hash + Zielpfad
+    // Idempotency-Key (Request oder Batch-Part) -> erste erfolgreiche Antwort
+    QHash<QByteArray, Response> m_idempotent;
+    int m_uploadRequests = 0;
+    int m_uploadsInFlight = 0;
+
+    // Token Bucket für Options::bandwidth, gedrosselte Sockets werden per Timer weitergelesen
+    qint64 m_budget = 0;
+    QElapsedTimer m_budgetClock;
+    QTimer m_bandwidthTimer;
+    QSet<QTcpSocket *> m_throttled;
+};
@@ -0,0 +1,74 @@
+#include "MockServerThread.h"
+
+#ifdef Q_OS_UNIX
+#include <time.h>
+#endif
+
+MockServerThread::MockServerThread(const MockCrowServer::Options &options, QObject *parent)
+    : QThread(parent)
+    , m_options(options)
+{}
+
+MockServerThread::~MockServerThread()
+{
+    stopServer();
+}
+
+bool MockServerThread::startServer(quint16 port)
+{
+    m_requestedPort = port;
+    start();
+    m_ready.acquire();
+    if (m_port == 0) {
+        wait();
+        return false;
+    }
+    return true;
+}
+
+void MockServerThread::stopServer()
+{
+    if (!isRunning())
+        return;
+    quit();
+    wait();
+}
+
+QString MockServerThread::url() const
+{
+    return QString("http://127.0.0.1:%1").arg(m_port);
+}
+
+double MockServerThread::cpuTimeMs() const
+{
+    double ms = 0;
+#ifdef Q_OS_UNIX
+    if (m_server) {
+        // Die Thread-CPU-Uhr lässt sich nur im Thread selbst abfragen
+        QMetaObject::invokeMethod(
+            m_server,
+            [&ms]() {
+                timespec ts{};
+                clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+                ms = ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+            },
+            Qt::BlockingQueuedConnection);
+    }
+#endif
+    return ms;
+}
+
+void MockServerThread::run()
+{
+    MockCrowServer server(m_options);
+    if (!server.listen(QHostAddress::LocalHost, m_requestedPort)) {
+        m_ready.release();
+        return;
+    }
+    m_port = server.port();
+    m_server = &server;
+    m_ready.release();
+
+    exec();
+    m_server = nullptr;
+}
@@ -0,0 +1,46 @@
+/**
+ * @file MockServerThread.h
+ * @author ZHENG Robert (robert.hase-zheng.net)
+ * @brief runs a MockCrowServer on its own event loop inside the client process
+ * @version 0.1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2025 ZHENG Robert
+ *
+ */
+#pragma once
+
+#include <QSemaphore>
+#include <QString>
+#include <QThread>
+
+#include "MockCrowServer.h"
+
+// Server und Client teilen sich so keinen Event Loop: Latenzen des Clients
+// werden nicht durch die Request-Verarbeitung des Servers verfälscht.
+class MockServerThread : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit MockServerThread(const MockCrowServer::Options &options, QObject *parent = nullptr);
+    ~MockServerThread() override;
+
+    // Startet den Thread und wartet, bis der Server lauscht (false: Port nicht verfügbar)
+    bool startServer(quint16 port = 0);
+    void stopServer();
+
+    QString url() const;
+    // CPU-Zeit des Server-Threads in ms (0 wenn die Plattform das nicht liefert)
+    double cpuTimeMs() const;
+
+protected:
+    void run() override;
+
+private:
+    MockCrowServer::Options m_options;
+    quint16 m_requestedPort = 0;
+    quint16 m_port = 0;
+    MockCrowServer *m_server = nullptr;
+    QSemaphore m_ready;
+};
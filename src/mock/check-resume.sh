@@ -0,0 +1,55 @@
+#!/usr/bin/env bash
+# Offline-Prüfung der fortsetzbaren Uploads gegen CrowMockServer:
+# abgebrochene Chunks (--drop-every) und übernommene Chunks ohne Antwort (--drop-reply-every).
+# Jede Datei muss mit genau einer Upload-Session, vollständig und mit korrektem Hash ankommen.
+#
+#   src/mock/check-resume.sh <build-dir> [port]
+set -euo pipefail
+
+BUILD=${1:?usage: check-resume.sh <build-dir> [port]}
+PORT=${2:-18080}
+URL=http://127.0.0.1:$PORT
+TARGET=resume-check
+WORK=$(mktemp -d)
+trap 'kill "$MOCK_PID" 2>/dev/null || true; rm -rf "$WORK"' EXIT
+
+"$BUILD/CrowMockServer" --port "$PORT" --drop-every 3 --drop-reply-every 4 2>"$WORK/mock.log" &
+MOCK_PID=$!
+for _ in $(seq 50); do
+    curl -s -o /dev/null "$URL/health" && break
+    sleep 0.1
+done
+
+# Mehrere Chunks, genau passende Größe (letzter Chunk endet auf der Dateigröße), ein einzelner Chunk
+mkdir "$WORK/files"
+head -c 2621440 /dev/urandom >"$WORK/files/a.bin"
+head -c 4194304 /dev/urandom >"$WORK/files/b.bin"
+head -c 307200 /dev/urandom >"$WORK/files/c.bin"
+
+if ! "$BUILD/CrowQtClientCli" -s "$URL" -u admin -p 1234 -t "$TARGET" --chunk-size 1 -j 1 \
+    --no-validate --no-dedup --index "$WORK/index" "$WORK"/files/*.bin >"$WORK/cli.jsonl"; then
+    echo "FAIL: uploader exited with an error"
+    exit 1
+fi
+
+status=0
+sessions=$(grep -c "POST /upload/chunked -> 200" "$WORK/mock.log" || true)
+if [ "$sessions" -ne 3 ]; then
+    echo "FAIL: $sessions upload sessions for 3 files (restarted from zero?)"
+    status=1
+fi
+
+TOKEN=$(curl -s -H "Content-Type: application/json" -d '{"username":"admin","password":"1234"}' \
+    "$URL/login" | sed -n 's/.*"token":"\([^"]*\)".*/\1/p')
+MANIFEST=$(curl -s -H "Authorization: Bearer $TOKEN" "$URL/upload/manifest?path=$TARGET")
+for file in "$WORK"/files/*; do
+    name=$(basename "$file")
+    entry="[\"$name\",$(stat -c %s "$file"),\"$(b2sum -l 256 "$file" | cut -d' ' -f1)\"]"
+    if [[ "$MANIFEST" != *"$entry"* ]]; then
+        echo "FAIL: $name missing or corrupt on the server"
+        status=1
+    fi
+done
+
+[ "$status" -eq 0 ] && echo "OK: 3 files, one session each, hashes match"
+exit "$status"
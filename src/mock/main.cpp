@@ -0,0 +1,65 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTimer>
+
+#include "MockCrowServer.h"
+
+#include "../includes/rz_config.hpp"
+
+int main(int argc, char *argv[]) {
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationVersion(PROJECT_VERSION.c_str());
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Mock Crow upload server for offline checks");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOptions({
+        {"port", "Port to listen on.", "port", "8080"},
+        {"user", "Accepted username.", "user", "admin"},
+        {"password", "Accepted password.", "password", "1234"},
+        {"token-lifetime", "Access token lifetime in seconds.", "seconds", "900"},
+        {"drop-every", "Abort every n-th upload request midway.", "n", "0"},
+        {"drop-reply-every", "Store every n-th upload request but abort instead of answering.", "n", "0"},
+        {"no-hash", "Do not hash uploaded files (/upload/exists always misses)."},
+        {"bandwidth", "Simulated upload bandwidth in KB/s (0 = unlimited).", "kbps", "0"},
+        {"latency", "Simulated delay before each response in ms.", "ms", "0"},
+        {"max-uploads", "Answer 503 above this many concurrent uploads (0 = off).", "n", "0"},
+        {"down-after", "Exit after this many seconds, e.g. to test client failover (0 = never).", "seconds", "0"},
+    });
+    parser.process(a);
+
+    MockCrowServer::Options options;
+    options.username = parser.value("user");
+    options.password = parser.value("password");
+    options.tokenLifetime = parser.value("token-lifetime").toInt();
+    options.dropEvery = parser.value("drop-every").toInt();
+    options.dropReplyEvery = parser.value("drop-reply-every").toInt();
+    options.hashUploads = !parser.isSet("no-hash");
+    options.bandwidth = parser.value("bandwidth").toLongLong() * 1024;
+    options.latency = parser.value("latency").toInt();
+    options.maxUploads = parser.value("max-uploads").toInt();
+
+    MockCrowServer server(options);
+    if (!server.listen(QHostAddress::LocalHost, parser.value("port").toUShort())) {
+        qCritical("Could not listen on port %s", qPrintable(parser.value("port")));
+        return 1;
+    }
+    QObject::connect(&server,
+                     &MockCrowServer::requestHandled,
+                     [](const QString &method, const QString &path, int status) {
+                         qInfo("%s %s -> %d", qPrintable(method), qPrintable(path), status);
+                     });
+
+    // Simulierter Ausfall eines Knotens: Verbindungen brechen ab, neue werden verweigert
+    const int downAfter = parser.value("down-after").toInt();
+    if (downAfter > 0) {
+        QTimer::singleShot(downAfter * 1000, &a, [&a]() {
+            qInfo("Going down (--down-after)");
+            a.quit();
+        });
+    }
+
+    qInfo("Mock Crow server listening on %s", qPrintable(server.url()));
+    return a.exec();
+}